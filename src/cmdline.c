@@ -32,16 +32,63 @@ const char *gengetopt_args_info_usage = "Usage: h5direct_write_benchmark [OPTION
 const char *gengetopt_args_info_description = "";
 
 const char *gengetopt_args_info_help[] = {
-  "  -h, --help             Print help and exit",
-  "  -V, --version          Print version and exit",
-  "  -x, --nx=INT           number of pixels in x-direction (fastest changing)",
-  "  -y, --ny=INT           number of pixels in y-direction ",
-  "  -z, --nimages=INT      number of images (z-direction of array)",
-  "  -c, --chunk-size=INT   number of images per chunk  (default=`1')",
-  "  -o, --basename=STRING  basename of output files, will add .data and .h5  \n                           (default=`bench')",
-  "  -t, --traditional      run with traditional API, don't use direct writes  \n                           (default=off)",
-  "  -m, --metadata-tuning  apply hdf5 metadata tuning  (default=off)",
-  "  -j, --json=STRING      append results to given file using json formating",
+  "  -h, --help                       Print help and exit",
+  "  -V, --version                    Print version and exit",
+  "  -x, --nx=LONG                    number of pixels in x-direction (fastest \n                                     changing)",
+  "  -y, --ny=LONG                    number of pixels in y-direction ",
+  "  -z, --nimages=LONG               number of images (z-direction of array)",
+  "  -c, --chunk-size=LONG            number of images per chunk  (default=`1')",
+  "  -o, --basename=STRING            basename of output files, will add .data and \n                                     .h5  (default=`bench')",
+  "  -t, --traditional                run with traditional API, don't use direct \n                                     writes  (default=off)",
+  "  -m, --metadata-tuning            apply hdf5 metadata tuning  (default=off)",
+  "  -j, --json=STRING                append results to given file using json \n                                     formating",
+  "      --trace=STRING               record all VFD calls of the HDF5 write phase \n                                     and dump them to given file",
+  "      --trace-records=INT          size of the preallocated trace log in \n                                     records  (default=`1048576')",
+  "      --filter-mode=INT            passthrough filter behavior: 0 no-op, 1 \n                                     memcpy, 2 realloc, 3 checksum  \n                                     (default=`0')",
+  "      --nfilters=INT               number of passthrough filter instances in \n                                     the pipeline  (default=`1')",
+  "      --bshuf-lz4                  compress with the bitshuffle+LZ4 filter, \n                                     direct writes compress each chunk before \n                                     H5DOwrite_chunk()  (default=off)",
+  "      --bshuf-impl=STRING          bit transposition of the bitshuffle+LZ4 \n                                     codec: auto, scalar, sse2 or avx2  \n                                     (default=`auto')",
+  "      --data=STRING                chunk data: constant, detector, random or \n                                     mixed (alternating detector and random \n                                     chunks)  (default=`constant')",
+  "      --adaptive=DOUBLE            direct writes store a chunk uncompressed, \n                                     with the filter skipped in the filter \n                                     mask, if its compression ratio is below \n                                     the given value; 0 disables  (default=`0')",
+  "      --read-threads=INT           read the file back with H5Dread_chunk() and \n                                     decompress on this many threads, compared \n                                     with H5Dread(); 0 skips the read benchmark  \n                                     (default=`0')",
+  "      --read-sweep                 run the parallel read with 1, 2, 4, ... up \n                                     to read-threads threads  (default=off)",
+  "      --mem-interval=INT           sample RSS and metadata cache size every \n                                     given number of milliseconds during the \n                                     HDF5 writes, 0 disables  (default=`0')",
+  "      --free-list-limit=INT        cap every HDF5 free list and the total of \n                                     each kind of free list to the given number \n                                     of bytes, -1 means no limit  \n                                     (default=`-1')",
+  "      --timeline-bucket=INT        record the throughput of the raw and HDF5 \n                                     writes in buckets of the given number of \n                                     milliseconds, 0 disables  (default=`100')",
+  "      --progress=INT               print the throughput every given number of \n                                     seconds while writing, 0 disables  \n                                     (default=`0')",
+  "      --nbuffers=INT               number of chunk buffers written in turn, \n                                     each with different data; memory use is \n                                     independent of the file size  \n                                     (default=`1')",
+  "      --raw-fallocate              preallocate the raw file with fallocate() \n                                     before the timed writes  (default=off)",
+  "      --h5-alloc-early             allocate all chunks when the dataset is \n                                     created (H5D_ALLOC_TIME_EARLY, \n                                     H5D_FILL_TIME_NEVER)  (default=off)",
+  "      --frame-meta=INT             append a compound record per frame to a \n                                     second dataset, the given number of frames \n                                     per append: 1 per frame, chunk-size per \n                                     chunk, a multiple of it every few chunks; \n                                     0 disables  (default=`0')",
+  "      --buffers=STRING             backing of the chunk buffers: malloc, thp \n                                     (transparent hugepages) or hugetlb \n                                     (reserved hugepages)  (default=`malloc')",
+  "      --prefault                   touch every page of the chunk buffers right \n                                     after allocation  (default=off)",
+  "      --cpus=STRING                pin the benchmark and all its threads to the \n                                     given cpus, e.g. 0-7,16",
+  "      --numa-node=INT              bind the chunk buffers to the given NUMA \n                                     node and prefer it for all other memory, \n                                     -1 leaves the placement to the kernel  \n                                     (default=`-1')",
+  "      --nprocs=INT                 run the raw and HDF5 writes in this many \n                                     processes at once, each with its own files \n                                     basename.p<rank>.raw/.h5 and output in \n                                     basename.p<rank>.log  (default=`1')",
+  "      --nprocs-sweep               run with 1, 2, 4, ... up to nprocs processes  \n                                     (default=off)",
+  "      --write-threads=INT          write a dataset per thread with \n                                     H5DOwrite_chunk() from this many threads \n                                     into one file, compared with as many \n                                     processes writing a file each; more than \n                                     one thread needs a thread-safe HDF5, 0 \n                                     disables  (default=`0')",
+  "      --write-threads-sweep        run with 1, 2, 4, ... up to write-threads \n                                     writers  (default=off)",
+  "      --raw-engines=STRING         comma separated list of raw baselines: \n                                     write, pwrite, writev, mmap or all; the \n                                     raw results and the h5 relative \n                                     performance are from the fastest  \n                                     (default=`write')",
+  "      --writev-chunks=INT          number of chunks per writev() call of the \n                                     writev raw engine  (default=`16')",
+  "      --stage                      direct writes append the chunks to a log \n                                     basename.stage, a converter thread ingests \n                                     the log into the HDF5 file with \n                                     H5DOwrite_chunk() at the same time  \n                                     (default=off)",
+  "      --stage-rate=DOUBLE          limit the converter of --stage to the given \n                                     MiB/s, 0 for no limit  (default=`0')",
+  "      --alignment=LONG             align objects in the HDF5 file of at least \n                                     this size, or the chunk size if smaller, \n                                     to a multiple of it (H5Pset_alignment), 0 \n                                     disables  (default=`0')",
+  "      --tune=DOUBLE                search chunk size, alignment and metadata \n                                     tuning for the best sustained \n                                     H5DOwrite_chunk() rate within the given \n                                     number of seconds and print the \n                                     recommended command line, 0 disables  \n                                     (default=`0')",
+  "      --repeat=INT                 run the raw and HDF5 writes this many times \n                                     in one process and report mean, median, \n                                     standard deviation, 95% confidence \n                                     interval and outliers of every result  \n                                     (default=`1')",
+  "      --warmup=INT                 runs before the repeated ones that are not \n                                     counted  (default=`0')",
+  "      --order=STRING               order of the raw and HDF5 write phases: \n                                     raw-first, h5-first, alternate (swap with \n                                     every run of --repeat) or random  \n                                     (default=`raw-first')",
+  "      --quiesce=DOUBLE             before every timed phase sync and wait up to \n                                     the given number of seconds until dirty \n                                     and writeback pages in /proc/meminfo drop \n                                     below quiesce-dirty, 0 disables  \n                                     (default=`0')",
+  "      --quiesce-dirty=INT          threshold of --quiesce in MiB  \n                                     (default=`16')",
+  "      --scenario=STRING            write the datasets described in the given \n                                     scenario file into basename.scenario.h5, \n                                     each at its own frame rate, instead of the \n                                     raw and HDF5 comparison; see the scenarios \n                                     directory",
+  "      --checksum=STRING            store a checksum with every chunk: none, \n                                     fletcher32 (H5Pset_fletcher32) or crc32c \n                                     (PSI CRC32C filter); direct writes append \n                                     the checksum before H5DOwrite_chunk()  \n                                     (default=`none')",
+  "      --tail=STRING                direct writes of a partial chunk at the end, \n                                     when nimages is no multiple of chunk-size: \n                                     pad (zero-padded whole chunk with \n                                     H5DOwrite_chunk) or h5dwrite  \n                                     (default=`pad')",
+  "      --write-order=STRING         order of the chunk writes of the HDF5 phase: \n                                     sequential, reverse, strided, shuffled or \n                                     interleaved; all but sequential insert \n                                     into the middle of the chunk index  \n                                     (default=`sequential')",
+  "      --write-stride=LONG          chunks between two writes of --write-order \n                                     strided  (default=`16')",
+  "      --write-streams=INT          streams of --write-order interleaved, each \n                                     writes its own contiguous part of the \n                                     dataset in turn with the others  \n                                     (default=`4')",
+  "      --write-seed=INT             seed of the permutation of --write-order \n                                     shuffled  (default=`1')",
+  "      --overwrite=INT              write basename.overwrite.h5 with \n                                     bitshuffle+LZ4 compressed chunks, then \n                                     rewrite a fraction of the chunks with \n                                     other compressed sizes in this many \n                                     passes, each opening the file anew; done \n                                     for every strategy of fs-strategies, 0 \n                                     disables  (default=`0')",
+  "      --overwrite-fraction=DOUBLE  fraction of the chunks every pass of \n                                     --overwrite rewrites  (default=`0.25')",
+  "      --fs-strategies=STRING       comma separated list of file space \n                                     strategies of --overwrite \n                                     (H5Pset_file_space_strategy): fsm-aggr, \n                                     fsm-persist, page, page-persist, aggr, \n                                     none or all; the persist variants keep the \n                                     free space across closing the file  \n                                     (default=`fsm-aggr,fsm-persist')",
     0
 };
 
@@ -49,6 +96,8 @@ typedef enum {ARG_NO
   , ARG_FLAG
   , ARG_STRING
   , ARG_INT
+  , ARG_LONG
+  , ARG_DOUBLE
 } cmdline_parser_arg_type;
 
 static
@@ -79,6 +128,53 @@ void clear_given (struct gengetopt_args_info *args_info)
   args_info->traditional_given = 0 ;
   args_info->metadata_tuning_given = 0 ;
   args_info->json_given = 0 ;
+  args_info->trace_given = 0 ;
+  args_info->trace_records_given = 0 ;
+  args_info->filter_mode_given = 0 ;
+  args_info->nfilters_given = 0 ;
+  args_info->bshuf_lz4_given = 0 ;
+  args_info->bshuf_impl_given = 0 ;
+  args_info->data_given = 0 ;
+  args_info->adaptive_given = 0 ;
+  args_info->read_threads_given = 0 ;
+  args_info->read_sweep_given = 0 ;
+  args_info->mem_interval_given = 0 ;
+  args_info->free_list_limit_given = 0 ;
+  args_info->timeline_bucket_given = 0 ;
+  args_info->progress_given = 0 ;
+  args_info->nbuffers_given = 0 ;
+  args_info->raw_fallocate_given = 0 ;
+  args_info->h5_alloc_early_given = 0 ;
+  args_info->frame_meta_given = 0 ;
+  args_info->buffers_given = 0 ;
+  args_info->prefault_given = 0 ;
+  args_info->cpus_given = 0 ;
+  args_info->numa_node_given = 0 ;
+  args_info->nprocs_given = 0 ;
+  args_info->nprocs_sweep_given = 0 ;
+  args_info->write_threads_given = 0 ;
+  args_info->write_threads_sweep_given = 0 ;
+  args_info->raw_engines_given = 0 ;
+  args_info->writev_chunks_given = 0 ;
+  args_info->stage_given = 0 ;
+  args_info->stage_rate_given = 0 ;
+  args_info->alignment_given = 0 ;
+  args_info->tune_given = 0 ;
+  args_info->repeat_given = 0 ;
+  args_info->warmup_given = 0 ;
+  args_info->order_given = 0 ;
+  args_info->quiesce_given = 0 ;
+  args_info->quiesce_dirty_given = 0 ;
+  args_info->scenario_given = 0 ;
+  args_info->checksum_given = 0 ;
+  args_info->tail_given = 0 ;
+  args_info->write_order_given = 0 ;
+  args_info->write_stride_given = 0 ;
+  args_info->write_streams_given = 0 ;
+  args_info->write_seed_given = 0 ;
+  args_info->overwrite_given = 0 ;
+  args_info->overwrite_fraction_given = 0 ;
+  args_info->fs_strategies_given = 0 ;
 }
 
 static
@@ -96,6 +192,92 @@ void clear_args (struct gengetopt_args_info *args_info)
   args_info->metadata_tuning_flag = 0;
   args_info->json_arg = NULL;
   args_info->json_orig = NULL;
+  args_info->trace_arg = NULL;
+  args_info->trace_orig = NULL;
+  args_info->trace_records_arg = 1048576;
+  args_info->trace_records_orig = NULL;
+  args_info->filter_mode_arg = 0;
+  args_info->filter_mode_orig = NULL;
+  args_info->nfilters_arg = 1;
+  args_info->nfilters_orig = NULL;
+  args_info->bshuf_lz4_flag = 0;
+  args_info->bshuf_impl_arg = gengetopt_strdup ("auto");
+  args_info->bshuf_impl_orig = NULL;
+  args_info->data_arg = gengetopt_strdup ("constant");
+  args_info->data_orig = NULL;
+  args_info->adaptive_arg = 0;
+  args_info->adaptive_orig = NULL;
+  args_info->read_threads_arg = 0;
+  args_info->read_threads_orig = NULL;
+  args_info->read_sweep_flag = 0;
+  args_info->mem_interval_arg = 0;
+  args_info->mem_interval_orig = NULL;
+  args_info->free_list_limit_arg = -1;
+  args_info->free_list_limit_orig = NULL;
+  args_info->timeline_bucket_arg = 100;
+  args_info->timeline_bucket_orig = NULL;
+  args_info->progress_arg = 0;
+  args_info->progress_orig = NULL;
+  args_info->nbuffers_arg = 1;
+  args_info->nbuffers_orig = NULL;
+  args_info->raw_fallocate_flag = 0;
+  args_info->h5_alloc_early_flag = 0;
+  args_info->frame_meta_arg = 0;
+  args_info->frame_meta_orig = NULL;
+  args_info->buffers_arg = gengetopt_strdup ("malloc");
+  args_info->buffers_orig = NULL;
+  args_info->prefault_flag = 0;
+  args_info->cpus_arg = NULL;
+  args_info->cpus_orig = NULL;
+  args_info->numa_node_arg = -1;
+  args_info->numa_node_orig = NULL;
+  args_info->nprocs_arg = 1;
+  args_info->nprocs_orig = NULL;
+  args_info->nprocs_sweep_flag = 0;
+  args_info->write_threads_arg = 0;
+  args_info->write_threads_orig = NULL;
+  args_info->write_threads_sweep_flag = 0;
+  args_info->raw_engines_arg = gengetopt_strdup ("write");
+  args_info->raw_engines_orig = NULL;
+  args_info->writev_chunks_arg = 16;
+  args_info->writev_chunks_orig = NULL;
+  args_info->stage_flag = 0;
+  args_info->stage_rate_arg = 0;
+  args_info->stage_rate_orig = NULL;
+  args_info->alignment_arg = 0;
+  args_info->alignment_orig = NULL;
+  args_info->tune_arg = 0;
+  args_info->tune_orig = NULL;
+  args_info->repeat_arg = 1;
+  args_info->repeat_orig = NULL;
+  args_info->warmup_arg = 0;
+  args_info->warmup_orig = NULL;
+  args_info->order_arg = gengetopt_strdup ("raw-first");
+  args_info->order_orig = NULL;
+  args_info->quiesce_arg = 0;
+  args_info->quiesce_orig = NULL;
+  args_info->quiesce_dirty_arg = 16;
+  args_info->quiesce_dirty_orig = NULL;
+  args_info->scenario_arg = NULL;
+  args_info->scenario_orig = NULL;
+  args_info->checksum_arg = gengetopt_strdup ("none");
+  args_info->checksum_orig = NULL;
+  args_info->tail_arg = gengetopt_strdup ("pad");
+  args_info->tail_orig = NULL;
+  args_info->write_order_arg = gengetopt_strdup ("sequential");
+  args_info->write_order_orig = NULL;
+  args_info->write_stride_arg = 16;
+  args_info->write_stride_orig = NULL;
+  args_info->write_streams_arg = 4;
+  args_info->write_streams_orig = NULL;
+  args_info->write_seed_arg = 1;
+  args_info->write_seed_orig = NULL;
+  args_info->overwrite_arg = 0;
+  args_info->overwrite_orig = NULL;
+  args_info->overwrite_fraction_arg = 0.25;
+  args_info->overwrite_fraction_orig = NULL;
+  args_info->fs_strategies_arg = gengetopt_strdup ("fsm-aggr,fsm-persist");
+  args_info->fs_strategies_orig = NULL;
   
 }
 
@@ -114,6 +296,53 @@ void init_args_info(struct gengetopt_args_info *args_info)
   args_info->traditional_help = gengetopt_args_info_help[7] ;
   args_info->metadata_tuning_help = gengetopt_args_info_help[8] ;
   args_info->json_help = gengetopt_args_info_help[9] ;
+  args_info->trace_help = gengetopt_args_info_help[10] ;
+  args_info->trace_records_help = gengetopt_args_info_help[11] ;
+  args_info->filter_mode_help = gengetopt_args_info_help[12] ;
+  args_info->nfilters_help = gengetopt_args_info_help[13] ;
+  args_info->bshuf_lz4_help = gengetopt_args_info_help[14] ;
+  args_info->bshuf_impl_help = gengetopt_args_info_help[15] ;
+  args_info->data_help = gengetopt_args_info_help[16] ;
+  args_info->adaptive_help = gengetopt_args_info_help[17] ;
+  args_info->read_threads_help = gengetopt_args_info_help[18] ;
+  args_info->read_sweep_help = gengetopt_args_info_help[19] ;
+  args_info->mem_interval_help = gengetopt_args_info_help[20] ;
+  args_info->free_list_limit_help = gengetopt_args_info_help[21] ;
+  args_info->timeline_bucket_help = gengetopt_args_info_help[22] ;
+  args_info->progress_help = gengetopt_args_info_help[23] ;
+  args_info->nbuffers_help = gengetopt_args_info_help[24] ;
+  args_info->raw_fallocate_help = gengetopt_args_info_help[25] ;
+  args_info->h5_alloc_early_help = gengetopt_args_info_help[26] ;
+  args_info->frame_meta_help = gengetopt_args_info_help[27] ;
+  args_info->buffers_help = gengetopt_args_info_help[28] ;
+  args_info->prefault_help = gengetopt_args_info_help[29] ;
+  args_info->cpus_help = gengetopt_args_info_help[30] ;
+  args_info->numa_node_help = gengetopt_args_info_help[31] ;
+  args_info->nprocs_help = gengetopt_args_info_help[32] ;
+  args_info->nprocs_sweep_help = gengetopt_args_info_help[33] ;
+  args_info->write_threads_help = gengetopt_args_info_help[34] ;
+  args_info->write_threads_sweep_help = gengetopt_args_info_help[35] ;
+  args_info->raw_engines_help = gengetopt_args_info_help[36] ;
+  args_info->writev_chunks_help = gengetopt_args_info_help[37] ;
+  args_info->stage_help = gengetopt_args_info_help[38] ;
+  args_info->stage_rate_help = gengetopt_args_info_help[39] ;
+  args_info->alignment_help = gengetopt_args_info_help[40] ;
+  args_info->tune_help = gengetopt_args_info_help[41] ;
+  args_info->repeat_help = gengetopt_args_info_help[42] ;
+  args_info->warmup_help = gengetopt_args_info_help[43] ;
+  args_info->order_help = gengetopt_args_info_help[44] ;
+  args_info->quiesce_help = gengetopt_args_info_help[45] ;
+  args_info->quiesce_dirty_help = gengetopt_args_info_help[46] ;
+  args_info->scenario_help = gengetopt_args_info_help[47] ;
+  args_info->checksum_help = gengetopt_args_info_help[48] ;
+  args_info->tail_help = gengetopt_args_info_help[49] ;
+  args_info->write_order_help = gengetopt_args_info_help[50] ;
+  args_info->write_stride_help = gengetopt_args_info_help[51] ;
+  args_info->write_streams_help = gengetopt_args_info_help[52] ;
+  args_info->write_seed_help = gengetopt_args_info_help[53] ;
+  args_info->overwrite_help = gengetopt_args_info_help[54] ;
+  args_info->overwrite_fraction_help = gengetopt_args_info_help[55] ;
+  args_info->fs_strategies_help = gengetopt_args_info_help[56] ;
   
 }
 
@@ -205,6 +434,57 @@ cmdline_parser_release (struct gengetopt_args_info *args_info)
   free_string_field (&(args_info->basename_orig));
   free_string_field (&(args_info->json_arg));
   free_string_field (&(args_info->json_orig));
+  free_string_field (&(args_info->trace_arg));
+  free_string_field (&(args_info->trace_orig));
+  free_string_field (&(args_info->trace_records_orig));
+  free_string_field (&(args_info->filter_mode_orig));
+  free_string_field (&(args_info->nfilters_orig));
+  free_string_field (&(args_info->bshuf_impl_arg));
+  free_string_field (&(args_info->bshuf_impl_orig));
+  free_string_field (&(args_info->data_arg));
+  free_string_field (&(args_info->data_orig));
+  free_string_field (&(args_info->adaptive_orig));
+  free_string_field (&(args_info->read_threads_orig));
+  free_string_field (&(args_info->mem_interval_orig));
+  free_string_field (&(args_info->free_list_limit_orig));
+  free_string_field (&(args_info->timeline_bucket_orig));
+  free_string_field (&(args_info->progress_orig));
+  free_string_field (&(args_info->nbuffers_orig));
+  free_string_field (&(args_info->frame_meta_orig));
+  free_string_field (&(args_info->buffers_arg));
+  free_string_field (&(args_info->buffers_orig));
+  free_string_field (&(args_info->cpus_arg));
+  free_string_field (&(args_info->cpus_orig));
+  free_string_field (&(args_info->numa_node_orig));
+  free_string_field (&(args_info->nprocs_orig));
+  free_string_field (&(args_info->write_threads_orig));
+  free_string_field (&(args_info->raw_engines_arg));
+  free_string_field (&(args_info->raw_engines_orig));
+  free_string_field (&(args_info->writev_chunks_orig));
+  free_string_field (&(args_info->stage_rate_orig));
+  free_string_field (&(args_info->alignment_orig));
+  free_string_field (&(args_info->tune_orig));
+  free_string_field (&(args_info->repeat_orig));
+  free_string_field (&(args_info->warmup_orig));
+  free_string_field (&(args_info->order_arg));
+  free_string_field (&(args_info->order_orig));
+  free_string_field (&(args_info->quiesce_orig));
+  free_string_field (&(args_info->quiesce_dirty_orig));
+  free_string_field (&(args_info->scenario_arg));
+  free_string_field (&(args_info->scenario_orig));
+  free_string_field (&(args_info->checksum_arg));
+  free_string_field (&(args_info->checksum_orig));
+  free_string_field (&(args_info->tail_arg));
+  free_string_field (&(args_info->tail_orig));
+  free_string_field (&(args_info->write_order_arg));
+  free_string_field (&(args_info->write_order_orig));
+  free_string_field (&(args_info->write_stride_orig));
+  free_string_field (&(args_info->write_streams_orig));
+  free_string_field (&(args_info->write_seed_orig));
+  free_string_field (&(args_info->overwrite_orig));
+  free_string_field (&(args_info->overwrite_fraction_orig));
+  free_string_field (&(args_info->fs_strategies_arg));
+  free_string_field (&(args_info->fs_strategies_orig));
   
   
   for (i = 0; i < args_info->inputs_num; ++i)
@@ -260,6 +540,100 @@ cmdline_parser_dump(FILE *outfile, struct gengetopt_args_info *args_info)
     write_into_file(outfile, "metadata-tuning", 0, 0 );
   if (args_info->json_given)
     write_into_file(outfile, "json", args_info->json_orig, 0);
+  if (args_info->trace_given)
+    write_into_file(outfile, "trace", args_info->trace_orig, 0);
+  if (args_info->trace_records_given)
+    write_into_file(outfile, "trace-records", args_info->trace_records_orig, 0);
+  if (args_info->filter_mode_given)
+    write_into_file(outfile, "filter-mode", args_info->filter_mode_orig, 0);
+  if (args_info->nfilters_given)
+    write_into_file(outfile, "nfilters", args_info->nfilters_orig, 0);
+  if (args_info->bshuf_lz4_given)
+    write_into_file(outfile, "bshuf-lz4", 0, 0 );
+  if (args_info->bshuf_impl_given)
+    write_into_file(outfile, "bshuf-impl", args_info->bshuf_impl_orig, 0);
+  if (args_info->data_given)
+    write_into_file(outfile, "data", args_info->data_orig, 0);
+  if (args_info->adaptive_given)
+    write_into_file(outfile, "adaptive", args_info->adaptive_orig, 0);
+  if (args_info->read_threads_given)
+    write_into_file(outfile, "read-threads", args_info->read_threads_orig, 0);
+  if (args_info->read_sweep_given)
+    write_into_file(outfile, "read-sweep", 0, 0 );
+  if (args_info->mem_interval_given)
+    write_into_file(outfile, "mem-interval", args_info->mem_interval_orig, 0);
+  if (args_info->free_list_limit_given)
+    write_into_file(outfile, "free-list-limit", args_info->free_list_limit_orig, 0);
+  if (args_info->timeline_bucket_given)
+    write_into_file(outfile, "timeline-bucket", args_info->timeline_bucket_orig, 0);
+  if (args_info->progress_given)
+    write_into_file(outfile, "progress", args_info->progress_orig, 0);
+  if (args_info->nbuffers_given)
+    write_into_file(outfile, "nbuffers", args_info->nbuffers_orig, 0);
+  if (args_info->raw_fallocate_given)
+    write_into_file(outfile, "raw-fallocate", 0, 0 );
+  if (args_info->h5_alloc_early_given)
+    write_into_file(outfile, "h5-alloc-early", 0, 0 );
+  if (args_info->frame_meta_given)
+    write_into_file(outfile, "frame-meta", args_info->frame_meta_orig, 0);
+  if (args_info->buffers_given)
+    write_into_file(outfile, "buffers", args_info->buffers_orig, 0);
+  if (args_info->prefault_given)
+    write_into_file(outfile, "prefault", 0, 0 );
+  if (args_info->cpus_given)
+    write_into_file(outfile, "cpus", args_info->cpus_orig, 0);
+  if (args_info->numa_node_given)
+    write_into_file(outfile, "numa-node", args_info->numa_node_orig, 0);
+  if (args_info->nprocs_given)
+    write_into_file(outfile, "nprocs", args_info->nprocs_orig, 0);
+  if (args_info->nprocs_sweep_given)
+    write_into_file(outfile, "nprocs-sweep", 0, 0 );
+  if (args_info->write_threads_given)
+    write_into_file(outfile, "write-threads", args_info->write_threads_orig, 0);
+  if (args_info->write_threads_sweep_given)
+    write_into_file(outfile, "write-threads-sweep", 0, 0 );
+  if (args_info->raw_engines_given)
+    write_into_file(outfile, "raw-engines", args_info->raw_engines_orig, 0);
+  if (args_info->writev_chunks_given)
+    write_into_file(outfile, "writev-chunks", args_info->writev_chunks_orig, 0);
+  if (args_info->stage_given)
+    write_into_file(outfile, "stage", 0, 0 );
+  if (args_info->stage_rate_given)
+    write_into_file(outfile, "stage-rate", args_info->stage_rate_orig, 0);
+  if (args_info->alignment_given)
+    write_into_file(outfile, "alignment", args_info->alignment_orig, 0);
+  if (args_info->tune_given)
+    write_into_file(outfile, "tune", args_info->tune_orig, 0);
+  if (args_info->repeat_given)
+    write_into_file(outfile, "repeat", args_info->repeat_orig, 0);
+  if (args_info->warmup_given)
+    write_into_file(outfile, "warmup", args_info->warmup_orig, 0);
+  if (args_info->order_given)
+    write_into_file(outfile, "order", args_info->order_orig, 0);
+  if (args_info->quiesce_given)
+    write_into_file(outfile, "quiesce", args_info->quiesce_orig, 0);
+  if (args_info->quiesce_dirty_given)
+    write_into_file(outfile, "quiesce-dirty", args_info->quiesce_dirty_orig, 0);
+  if (args_info->scenario_given)
+    write_into_file(outfile, "scenario", args_info->scenario_orig, 0);
+  if (args_info->checksum_given)
+    write_into_file(outfile, "checksum", args_info->checksum_orig, 0);
+  if (args_info->tail_given)
+    write_into_file(outfile, "tail", args_info->tail_orig, 0);
+  if (args_info->write_order_given)
+    write_into_file(outfile, "write-order", args_info->write_order_orig, 0);
+  if (args_info->write_stride_given)
+    write_into_file(outfile, "write-stride", args_info->write_stride_orig, 0);
+  if (args_info->write_streams_given)
+    write_into_file(outfile, "write-streams", args_info->write_streams_orig, 0);
+  if (args_info->write_seed_given)
+    write_into_file(outfile, "write-seed", args_info->write_seed_orig, 0);
+  if (args_info->overwrite_given)
+    write_into_file(outfile, "overwrite", args_info->overwrite_orig, 0);
+  if (args_info->overwrite_fraction_given)
+    write_into_file(outfile, "overwrite-fraction", args_info->overwrite_fraction_orig, 0);
+  if (args_info->fs_strategies_given)
+    write_into_file(outfile, "fs-strategies", args_info->fs_strategies_orig, 0);
   
 
   i = EXIT_SUCCESS;
@@ -472,6 +846,12 @@ int update_arg(void *field, char **orig_field,
   case ARG_INT:
     if (val) *((int *)field) = strtol (val, &stop_char, 0);
     break;
+  case ARG_LONG:
+    if (val) *((long *)field) = (long)strtol (val, &stop_char, 0);
+    break;
+  case ARG_DOUBLE:
+    if (val) *((double *)field) = strtod (val, &stop_char);
+    break;
   case ARG_STRING:
     if (val) {
       string_field = (char **)field;
@@ -487,6 +867,8 @@ int update_arg(void *field, char **orig_field,
   /* check numeric conversion */
   switch(arg_type) {
   case ARG_INT:
+  case ARG_LONG:
+  case ARG_DOUBLE:
     if (val && !(stop_char && *stop_char == '\0')) {
       fprintf(stderr, "%s: invalid numeric value: %s\n", package_name, val);
       return 1; /* failure */
@@ -564,6 +946,53 @@ cmdline_parser_internal (
         { "traditional",	0, NULL, 't' },
         { "metadata-tuning",	0, NULL, 'm' },
         { "json",	1, NULL, 'j' },
+        { "trace",	1, NULL, 0 },
+        { "trace-records",	1, NULL, 0 },
+        { "filter-mode",	1, NULL, 0 },
+        { "nfilters",	1, NULL, 0 },
+        { "bshuf-lz4",	0, NULL, 0 },
+        { "bshuf-impl",	1, NULL, 0 },
+        { "data",	1, NULL, 0 },
+        { "adaptive",	1, NULL, 0 },
+        { "read-threads",	1, NULL, 0 },
+        { "read-sweep",	0, NULL, 0 },
+        { "mem-interval",	1, NULL, 0 },
+        { "free-list-limit",	1, NULL, 0 },
+        { "timeline-bucket",	1, NULL, 0 },
+        { "progress",	1, NULL, 0 },
+        { "nbuffers",	1, NULL, 0 },
+        { "raw-fallocate",	0, NULL, 0 },
+        { "h5-alloc-early",	0, NULL, 0 },
+        { "frame-meta",	1, NULL, 0 },
+        { "buffers",	1, NULL, 0 },
+        { "prefault",	0, NULL, 0 },
+        { "cpus",	1, NULL, 0 },
+        { "numa-node",	1, NULL, 0 },
+        { "nprocs",	1, NULL, 0 },
+        { "nprocs-sweep",	0, NULL, 0 },
+        { "write-threads",	1, NULL, 0 },
+        { "write-threads-sweep",	0, NULL, 0 },
+        { "raw-engines",	1, NULL, 0 },
+        { "writev-chunks",	1, NULL, 0 },
+        { "stage",	0, NULL, 0 },
+        { "stage-rate",	1, NULL, 0 },
+        { "alignment",	1, NULL, 0 },
+        { "tune",	1, NULL, 0 },
+        { "repeat",	1, NULL, 0 },
+        { "warmup",	1, NULL, 0 },
+        { "order",	1, NULL, 0 },
+        { "quiesce",	1, NULL, 0 },
+        { "quiesce-dirty",	1, NULL, 0 },
+        { "scenario",	1, NULL, 0 },
+        { "checksum",	1, NULL, 0 },
+        { "tail",	1, NULL, 0 },
+        { "write-order",	1, NULL, 0 },
+        { "write-stride",	1, NULL, 0 },
+        { "write-streams",	1, NULL, 0 },
+        { "write-seed",	1, NULL, 0 },
+        { "overwrite",	1, NULL, 0 },
+        { "overwrite-fraction",	1, NULL, 0 },
+        { "fs-strategies",	1, NULL, 0 },
         { 0,  0, 0, 0 }
       };
 
@@ -588,7 +1017,7 @@ cmdline_parser_internal (
         
           if (update_arg( (void *)&(args_info->nx_arg), 
                &(args_info->nx_orig), &(args_info->nx_given),
-              &(local_args_info.nx_given), optarg, 0, 0, ARG_INT,
+              &(local_args_info.nx_given), optarg, 0, 0, ARG_LONG,
               check_ambiguity, override, 0, 0,
               "nx", 'x',
               additional_error))
@@ -600,7 +1029,7 @@ cmdline_parser_internal (
         
           if (update_arg( (void *)&(args_info->ny_arg), 
                &(args_info->ny_orig), &(args_info->ny_given),
-              &(local_args_info.ny_given), optarg, 0, 0, ARG_INT,
+              &(local_args_info.ny_given), optarg, 0, 0, ARG_LONG,
               check_ambiguity, override, 0, 0,
               "ny", 'y',
               additional_error))
@@ -612,7 +1041,7 @@ cmdline_parser_internal (
         
           if (update_arg( (void *)&(args_info->nimages_arg), 
                &(args_info->nimages_orig), &(args_info->nimages_given),
-              &(local_args_info.nimages_given), optarg, 0, 0, ARG_INT,
+              &(local_args_info.nimages_given), optarg, 0, 0, ARG_LONG,
               check_ambiguity, override, 0, 0,
               "nimages", 'z',
               additional_error))
@@ -624,7 +1053,7 @@ cmdline_parser_internal (
         
           if (update_arg( (void *)&(args_info->chunk_size_arg), 
                &(args_info->chunk_size_orig), &(args_info->chunk_size_given),
-              &(local_args_info.chunk_size_given), optarg, 0, "1", ARG_INT,
+              &(local_args_info.chunk_size_given), optarg, 0, "1", ARG_LONG,
               check_ambiguity, override, 0, 0,
               "chunk-size", 'c',
               additional_error))
@@ -677,6 +1106,650 @@ cmdline_parser_internal (
           break;
 
         case 0:	/* Long option with no short option */
+          /* record all VFD calls of the HDF5 write phase and dump them to given file.  */
+          if (strcmp (long_options[option_index].name, "trace") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->trace_arg), 
+                 &(args_info->trace_orig), &(args_info->trace_given),
+                &(local_args_info.trace_given), optarg, 0, 0, ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "trace", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* size of the preallocated trace log in records.  */
+          else if (strcmp (long_options[option_index].name, "trace-records") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->trace_records_arg), 
+                 &(args_info->trace_records_orig), &(args_info->trace_records_given),
+                &(local_args_info.trace_records_given), optarg, 0, "1048576", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "trace-records", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* passthrough filter behavior: 0 no-op, 1 memcpy, 2 realloc, 3 checksum.  */
+          else if (strcmp (long_options[option_index].name, "filter-mode") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->filter_mode_arg), 
+                 &(args_info->filter_mode_orig), &(args_info->filter_mode_given),
+                &(local_args_info.filter_mode_given), optarg, 0, "0", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "filter-mode", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* number of passthrough filter instances in the pipeline.  */
+          else if (strcmp (long_options[option_index].name, "nfilters") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->nfilters_arg), 
+                 &(args_info->nfilters_orig), &(args_info->nfilters_given),
+                &(local_args_info.nfilters_given), optarg, 0, "1", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "nfilters", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* compress with the bitshuffle+LZ4 filter, direct writes compress each chunk before H5DOwrite_chunk().  */
+          else if (strcmp (long_options[option_index].name, "bshuf-lz4") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->bshuf_lz4_flag), 0, &(args_info->bshuf_lz4_given),
+                &(local_args_info.bshuf_lz4_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "bshuf-lz4", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* bit transposition of the bitshuffle+LZ4 codec: auto, scalar, sse2 or avx2.  */
+          else if (strcmp (long_options[option_index].name, "bshuf-impl") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->bshuf_impl_arg), 
+                 &(args_info->bshuf_impl_orig), &(args_info->bshuf_impl_given),
+                &(local_args_info.bshuf_impl_given), optarg, 0, "auto", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "bshuf-impl", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* chunk data: constant, detector, random or mixed (alternating detector and random chunks).  */
+          else if (strcmp (long_options[option_index].name, "data") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->data_arg), 
+                 &(args_info->data_orig), &(args_info->data_given),
+                &(local_args_info.data_given), optarg, 0, "constant", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "data", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* direct writes store a chunk uncompressed, with the filter skipped in the filter mask, if its compression ratio is below the given value; 0 disables.  */
+          else if (strcmp (long_options[option_index].name, "adaptive") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->adaptive_arg), 
+                 &(args_info->adaptive_orig), &(args_info->adaptive_given),
+                &(local_args_info.adaptive_given), optarg, 0, "0", ARG_DOUBLE,
+                check_ambiguity, override, 0, 0,
+                "adaptive", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* read the file back with H5Dread_chunk() and decompress on this many threads, compared with H5Dread(); 0 skips the read benchmark.  */
+          else if (strcmp (long_options[option_index].name, "read-threads") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->read_threads_arg), 
+                 &(args_info->read_threads_orig), &(args_info->read_threads_given),
+                &(local_args_info.read_threads_given), optarg, 0, "0", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "read-threads", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* run the parallel read with 1, 2, 4, ... up to read-threads threads.  */
+          else if (strcmp (long_options[option_index].name, "read-sweep") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->read_sweep_flag), 0, &(args_info->read_sweep_given),
+                &(local_args_info.read_sweep_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "read-sweep", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* sample RSS and metadata cache size every given number of milliseconds during the HDF5 writes, 0 disables.  */
+          else if (strcmp (long_options[option_index].name, "mem-interval") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->mem_interval_arg), 
+                 &(args_info->mem_interval_orig), &(args_info->mem_interval_given),
+                &(local_args_info.mem_interval_given), optarg, 0, "0", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "mem-interval", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* cap every HDF5 free list and the total of each kind of free list to the given number of bytes, -1 means no limit.  */
+          else if (strcmp (long_options[option_index].name, "free-list-limit") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->free_list_limit_arg), 
+                 &(args_info->free_list_limit_orig), &(args_info->free_list_limit_given),
+                &(local_args_info.free_list_limit_given), optarg, 0, "-1", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "free-list-limit", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* record the throughput of the raw and HDF5 writes in buckets of the given number of milliseconds, 0 disables.  */
+          else if (strcmp (long_options[option_index].name, "timeline-bucket") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->timeline_bucket_arg), 
+                 &(args_info->timeline_bucket_orig), &(args_info->timeline_bucket_given),
+                &(local_args_info.timeline_bucket_given), optarg, 0, "100", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "timeline-bucket", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* print the throughput every given number of seconds while writing, 0 disables.  */
+          else if (strcmp (long_options[option_index].name, "progress") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->progress_arg), 
+                 &(args_info->progress_orig), &(args_info->progress_given),
+                &(local_args_info.progress_given), optarg, 0, "0", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "progress", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* number of chunk buffers written in turn, each with different data; memory use is independent of the file size.  */
+          else if (strcmp (long_options[option_index].name, "nbuffers") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->nbuffers_arg), 
+                 &(args_info->nbuffers_orig), &(args_info->nbuffers_given),
+                &(local_args_info.nbuffers_given), optarg, 0, "1", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "nbuffers", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* preallocate the raw file with fallocate() before the timed writes.  */
+          else if (strcmp (long_options[option_index].name, "raw-fallocate") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->raw_fallocate_flag), 0, &(args_info->raw_fallocate_given),
+                &(local_args_info.raw_fallocate_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "raw-fallocate", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* allocate all chunks when the dataset is created (H5D_ALLOC_TIME_EARLY, H5D_FILL_TIME_NEVER).  */
+          else if (strcmp (long_options[option_index].name, "h5-alloc-early") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->h5_alloc_early_flag), 0, &(args_info->h5_alloc_early_given),
+                &(local_args_info.h5_alloc_early_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "h5-alloc-early", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* append a compound record per frame to a second dataset, the given number of frames per append: 1 per frame, chunk-size per chunk, a multiple of it every few chunks; 0 disables.  */
+          else if (strcmp (long_options[option_index].name, "frame-meta") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->frame_meta_arg), 
+                 &(args_info->frame_meta_orig), &(args_info->frame_meta_given),
+                &(local_args_info.frame_meta_given), optarg, 0, "0", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "frame-meta", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* backing of the chunk buffers: malloc, thp (transparent hugepages) or hugetlb (reserved hugepages).  */
+          else if (strcmp (long_options[option_index].name, "buffers") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->buffers_arg), 
+                 &(args_info->buffers_orig), &(args_info->buffers_given),
+                &(local_args_info.buffers_given), optarg, 0, "malloc", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "buffers", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* touch every page of the chunk buffers right after allocation.  */
+          else if (strcmp (long_options[option_index].name, "prefault") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->prefault_flag), 0, &(args_info->prefault_given),
+                &(local_args_info.prefault_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "prefault", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* pin the benchmark and all its threads to the given cpus, e.g. 0-7,16.  */
+          else if (strcmp (long_options[option_index].name, "cpus") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->cpus_arg), 
+                 &(args_info->cpus_orig), &(args_info->cpus_given),
+                &(local_args_info.cpus_given), optarg, 0, 0, ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "cpus", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* bind the chunk buffers to the given NUMA node and prefer it for all other memory, -1 leaves the placement to the kernel.  */
+          else if (strcmp (long_options[option_index].name, "numa-node") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->numa_node_arg), 
+                 &(args_info->numa_node_orig), &(args_info->numa_node_given),
+                &(local_args_info.numa_node_given), optarg, 0, "-1", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "numa-node", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* run the raw and HDF5 writes in this many processes at once, each with its own files basename.p<rank>.raw/.h5 and output in basename.p<rank>.log.  */
+          else if (strcmp (long_options[option_index].name, "nprocs") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->nprocs_arg), 
+                 &(args_info->nprocs_orig), &(args_info->nprocs_given),
+                &(local_args_info.nprocs_given), optarg, 0, "1", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "nprocs", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* run with 1, 2, 4, ... up to nprocs processes.  */
+          else if (strcmp (long_options[option_index].name, "nprocs-sweep") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->nprocs_sweep_flag), 0, &(args_info->nprocs_sweep_given),
+                &(local_args_info.nprocs_sweep_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "nprocs-sweep", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* write a dataset per thread with H5DOwrite_chunk() from this many threads into one file, compared with as many processes writing a file each; more than one thread needs a thread-safe HDF5, 0 disables.  */
+          else if (strcmp (long_options[option_index].name, "write-threads") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->write_threads_arg), 
+                 &(args_info->write_threads_orig), &(args_info->write_threads_given),
+                &(local_args_info.write_threads_given), optarg, 0, "0", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "write-threads", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* run with 1, 2, 4, ... up to write-threads writers.  */
+          else if (strcmp (long_options[option_index].name, "write-threads-sweep") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->write_threads_sweep_flag), 0, &(args_info->write_threads_sweep_given),
+                &(local_args_info.write_threads_sweep_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "write-threads-sweep", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* comma separated list of raw baselines: write, pwrite, writev, mmap or all; the raw results and the h5 relative performance are from the fastest.  */
+          else if (strcmp (long_options[option_index].name, "raw-engines") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->raw_engines_arg), 
+                 &(args_info->raw_engines_orig), &(args_info->raw_engines_given),
+                &(local_args_info.raw_engines_given), optarg, 0, "write", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "raw-engines", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* number of chunks per writev() call of the writev raw engine.  */
+          else if (strcmp (long_options[option_index].name, "writev-chunks") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->writev_chunks_arg), 
+                 &(args_info->writev_chunks_orig), &(args_info->writev_chunks_given),
+                &(local_args_info.writev_chunks_given), optarg, 0, "16", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "writev-chunks", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* direct writes append the chunks to a log basename.stage, a converter thread ingests the log into the HDF5 file with H5DOwrite_chunk() at the same time.  */
+          else if (strcmp (long_options[option_index].name, "stage") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->stage_flag), 0, &(args_info->stage_given),
+                &(local_args_info.stage_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "stage", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* limit the converter of --stage to the given MiB/s, 0 for no limit.  */
+          else if (strcmp (long_options[option_index].name, "stage-rate") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->stage_rate_arg), 
+                 &(args_info->stage_rate_orig), &(args_info->stage_rate_given),
+                &(local_args_info.stage_rate_given), optarg, 0, "0", ARG_DOUBLE,
+                check_ambiguity, override, 0, 0,
+                "stage-rate", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* align objects in the HDF5 file of at least this size, or the chunk size if smaller, to a multiple of it (H5Pset_alignment), 0 disables.  */
+          else if (strcmp (long_options[option_index].name, "alignment") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->alignment_arg), 
+                 &(args_info->alignment_orig), &(args_info->alignment_given),
+                &(local_args_info.alignment_given), optarg, 0, "0", ARG_LONG,
+                check_ambiguity, override, 0, 0,
+                "alignment", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* search chunk size, alignment and metadata tuning for the best sustained H5DOwrite_chunk() rate within the given number of seconds and print the recommended command line, 0 disables.  */
+          else if (strcmp (long_options[option_index].name, "tune") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->tune_arg), 
+                 &(args_info->tune_orig), &(args_info->tune_given),
+                &(local_args_info.tune_given), optarg, 0, "0", ARG_DOUBLE,
+                check_ambiguity, override, 0, 0,
+                "tune", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* run the raw and HDF5 writes this many times in one process and report mean, median, standard deviation, 95% confidence interval and outliers of every result.  */
+          else if (strcmp (long_options[option_index].name, "repeat") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->repeat_arg), 
+                 &(args_info->repeat_orig), &(args_info->repeat_given),
+                &(local_args_info.repeat_given), optarg, 0, "1", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "repeat", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* runs before the repeated ones that are not counted.  */
+          else if (strcmp (long_options[option_index].name, "warmup") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->warmup_arg), 
+                 &(args_info->warmup_orig), &(args_info->warmup_given),
+                &(local_args_info.warmup_given), optarg, 0, "0", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "warmup", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* order of the raw and HDF5 write phases: raw-first, h5-first, alternate (swap with every run of --repeat) or random.  */
+          else if (strcmp (long_options[option_index].name, "order") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->order_arg), 
+                 &(args_info->order_orig), &(args_info->order_given),
+                &(local_args_info.order_given), optarg, 0, "raw-first", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "order", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* before every timed phase sync and wait up to the given number of seconds until dirty and writeback pages in /proc/meminfo drop below quiesce-dirty, 0 disables.  */
+          else if (strcmp (long_options[option_index].name, "quiesce") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->quiesce_arg), 
+                 &(args_info->quiesce_orig), &(args_info->quiesce_given),
+                &(local_args_info.quiesce_given), optarg, 0, "0", ARG_DOUBLE,
+                check_ambiguity, override, 0, 0,
+                "quiesce", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* threshold of --quiesce in MiB.  */
+          else if (strcmp (long_options[option_index].name, "quiesce-dirty") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->quiesce_dirty_arg), 
+                 &(args_info->quiesce_dirty_orig), &(args_info->quiesce_dirty_given),
+                &(local_args_info.quiesce_dirty_given), optarg, 0, "16", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "quiesce-dirty", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* write the datasets described in the given scenario file into basename.scenario.h5, each at its own frame rate, instead of the raw and HDF5 comparison; see the scenarios directory.  */
+          else if (strcmp (long_options[option_index].name, "scenario") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->scenario_arg), 
+                 &(args_info->scenario_orig), &(args_info->scenario_given),
+                &(local_args_info.scenario_given), optarg, 0, 0, ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "scenario", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* store a checksum with every chunk: none, fletcher32 (H5Pset_fletcher32) or crc32c (PSI CRC32C filter); direct writes append the checksum before H5DOwrite_chunk().  */
+          else if (strcmp (long_options[option_index].name, "checksum") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->checksum_arg), 
+                 &(args_info->checksum_orig), &(args_info->checksum_given),
+                &(local_args_info.checksum_given), optarg, 0, "none", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "checksum", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* direct writes of a partial chunk at the end, when nimages is no multiple of chunk-size: pad (zero-padded whole chunk with H5DOwrite_chunk) or h5dwrite.  */
+          else if (strcmp (long_options[option_index].name, "tail") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->tail_arg), 
+                 &(args_info->tail_orig), &(args_info->tail_given),
+                &(local_args_info.tail_given), optarg, 0, "pad", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "tail", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* order of the chunk writes of the HDF5 phase: sequential, reverse, strided, shuffled or interleaved; all but sequential insert into the middle of the chunk index.  */
+          else if (strcmp (long_options[option_index].name, "write-order") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->write_order_arg), 
+                 &(args_info->write_order_orig), &(args_info->write_order_given),
+                &(local_args_info.write_order_given), optarg, 0, "sequential", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "write-order", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* chunks between two writes of --write-order strided.  */
+          else if (strcmp (long_options[option_index].name, "write-stride") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->write_stride_arg), 
+                 &(args_info->write_stride_orig), &(args_info->write_stride_given),
+                &(local_args_info.write_stride_given), optarg, 0, "16", ARG_LONG,
+                check_ambiguity, override, 0, 0,
+                "write-stride", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* streams of --write-order interleaved, each writes its own contiguous part of the dataset in turn with the others.  */
+          else if (strcmp (long_options[option_index].name, "write-streams") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->write_streams_arg), 
+                 &(args_info->write_streams_orig), &(args_info->write_streams_given),
+                &(local_args_info.write_streams_given), optarg, 0, "4", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "write-streams", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* seed of the permutation of --write-order shuffled.  */
+          else if (strcmp (long_options[option_index].name, "write-seed") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->write_seed_arg), 
+                 &(args_info->write_seed_orig), &(args_info->write_seed_given),
+                &(local_args_info.write_seed_given), optarg, 0, "1", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "write-seed", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* write basename.overwrite.h5 with bitshuffle+LZ4 compressed chunks, then rewrite a fraction of the chunks with other compressed sizes in this many passes, each opening the file anew; done for every strategy of fs-strategies, 0 disables.  */
+          else if (strcmp (long_options[option_index].name, "overwrite") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->overwrite_arg), 
+                 &(args_info->overwrite_orig), &(args_info->overwrite_given),
+                &(local_args_info.overwrite_given), optarg, 0, "0", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "overwrite", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* fraction of the chunks every pass of --overwrite rewrites.  */
+          else if (strcmp (long_options[option_index].name, "overwrite-fraction") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->overwrite_fraction_arg), 
+                 &(args_info->overwrite_fraction_orig), &(args_info->overwrite_fraction_given),
+                &(local_args_info.overwrite_fraction_given), optarg, 0, "0.25", ARG_DOUBLE,
+                check_ambiguity, override, 0, 0,
+                "overwrite-fraction", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          /* comma separated list of file space strategies of --overwrite (H5Pset_file_space_strategy): fsm-aggr, fsm-persist, page, page-persist, aggr, none or all; the persist variants keep the free space across closing the file.  */
+          else if (strcmp (long_options[option_index].name, "fs-strategies") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->fs_strategies_arg), 
+                 &(args_info->fs_strategies_orig), &(args_info->fs_strategies_given),
+                &(local_args_info.fs_strategies_given), optarg, 0, "fsm-aggr,fsm-persist", ARG_STRING,
+                check_ambiguity, override, 0, 0,
+                "fs-strategies", '-',
+                additional_error))
+              goto failure;
+          
+          }
+          
+          break;
         case '?':	/* Invalid option.  */
           /* `getopt_long' already printed an error message.  */
           goto failure;
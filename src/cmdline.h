@@ -39,16 +39,16 @@ struct gengetopt_args_info
 {
   const char *help_help; /**< @brief Print help and exit help description.  */
   const char *version_help; /**< @brief Print version and exit help description.  */
-  int nx_arg;	/**< @brief number of pixels in x-direction (fastest changing).  */
+  long nx_arg;	/**< @brief number of pixels in x-direction (fastest changing).  */
   char * nx_orig;	/**< @brief number of pixels in x-direction (fastest changing) original value given at command line.  */
   const char *nx_help; /**< @brief number of pixels in x-direction (fastest changing) help description.  */
-  int ny_arg;	/**< @brief number of pixels in y-direction .  */
+  long ny_arg;	/**< @brief number of pixels in y-direction .  */
   char * ny_orig;	/**< @brief number of pixels in y-direction  original value given at command line.  */
   const char *ny_help; /**< @brief number of pixels in y-direction  help description.  */
-  int nimages_arg;	/**< @brief number of images (z-direction of array).  */
+  long nimages_arg;	/**< @brief number of images (z-direction of array).  */
   char * nimages_orig;	/**< @brief number of images (z-direction of array) original value given at command line.  */
   const char *nimages_help; /**< @brief number of images (z-direction of array) help description.  */
-  int chunk_size_arg;	/**< @brief number of images per chunk (default='1').  */
+  long chunk_size_arg;	/**< @brief number of images per chunk (default='1').  */
   char * chunk_size_orig;	/**< @brief number of images per chunk original value given at command line.  */
   const char *chunk_size_help; /**< @brief number of images per chunk help description.  */
   char * basename_arg;	/**< @brief basename of output files, will add .data and .h5 (default='bench').  */
@@ -61,6 +61,139 @@ struct gengetopt_args_info
   char * json_arg;	/**< @brief append results to given file using json formating.  */
   char * json_orig;	/**< @brief append results to given file using json formating original value given at command line.  */
   const char *json_help; /**< @brief append results to given file using json formating help description.  */
+  char * trace_arg;	/**< @brief record all VFD calls of the HDF5 write phase and dump them to given file.  */
+  char * trace_orig;	/**< @brief record all VFD calls of the HDF5 write phase and dump them to given file original value given at command line.  */
+  const char *trace_help; /**< @brief record all VFD calls of the HDF5 write phase and dump them to given file help description.  */
+  int trace_records_arg;	/**< @brief size of the preallocated trace log in records (default='1048576').  */
+  char * trace_records_orig;	/**< @brief size of the preallocated trace log in records original value given at command line.  */
+  const char *trace_records_help; /**< @brief size of the preallocated trace log in records help description.  */
+  int filter_mode_arg;	/**< @brief passthrough filter behavior: 0 no-op, 1 memcpy, 2 realloc, 3 checksum (default='0').  */
+  char * filter_mode_orig;	/**< @brief passthrough filter behavior: 0 no-op, 1 memcpy, 2 realloc, 3 checksum original value given at command line.  */
+  const char *filter_mode_help; /**< @brief passthrough filter behavior: 0 no-op, 1 memcpy, 2 realloc, 3 checksum help description.  */
+  int nfilters_arg;	/**< @brief number of passthrough filter instances in the pipeline (default='1').  */
+  char * nfilters_orig;	/**< @brief number of passthrough filter instances in the pipeline original value given at command line.  */
+  const char *nfilters_help; /**< @brief number of passthrough filter instances in the pipeline help description.  */
+  int bshuf_lz4_flag;	/**< @brief compress with the bitshuffle+LZ4 filter, direct writes compress each chunk before H5DOwrite_chunk() (default=off).  */
+  const char *bshuf_lz4_help; /**< @brief compress with the bitshuffle+LZ4 filter, direct writes compress each chunk before H5DOwrite_chunk() help description.  */
+  char * bshuf_impl_arg;	/**< @brief bit transposition of the bitshuffle+LZ4 codec: auto, scalar, sse2 or avx2 (default='auto').  */
+  char * bshuf_impl_orig;	/**< @brief bit transposition of the bitshuffle+LZ4 codec: auto, scalar, sse2 or avx2 original value given at command line.  */
+  const char *bshuf_impl_help; /**< @brief bit transposition of the bitshuffle+LZ4 codec: auto, scalar, sse2 or avx2 help description.  */
+  char * data_arg;	/**< @brief chunk data: constant, detector, random or mixed (alternating detector and random chunks) (default='constant').  */
+  char * data_orig;	/**< @brief chunk data: constant, detector, random or mixed (alternating detector and random chunks) original value given at command line.  */
+  const char *data_help; /**< @brief chunk data: constant, detector, random or mixed (alternating detector and random chunks) help description.  */
+  double adaptive_arg;	/**< @brief direct writes store a chunk uncompressed, with the filter skipped in the filter mask, if its compression ratio is below the given value; 0 disables (default='0').  */
+  char * adaptive_orig;	/**< @brief direct writes store a chunk uncompressed, with the filter skipped in the filter mask, if its compression ratio is below the given value; 0 disables original value given at command line.  */
+  const char *adaptive_help; /**< @brief direct writes store a chunk uncompressed, with the filter skipped in the filter mask, if its compression ratio is below the given value; 0 disables help description.  */
+  int read_threads_arg;	/**< @brief read the file back with H5Dread_chunk() and decompress on this many threads, compared with H5Dread(); 0 skips the read benchmark (default='0').  */
+  char * read_threads_orig;	/**< @brief read the file back with H5Dread_chunk() and decompress on this many threads, compared with H5Dread(); 0 skips the read benchmark original value given at command line.  */
+  const char *read_threads_help; /**< @brief read the file back with H5Dread_chunk() and decompress on this many threads, compared with H5Dread(); 0 skips the read benchmark help description.  */
+  int read_sweep_flag;	/**< @brief run the parallel read with 1, 2, 4, ... up to read-threads threads (default=off).  */
+  const char *read_sweep_help; /**< @brief run the parallel read with 1, 2, 4, ... up to read-threads threads help description.  */
+  int mem_interval_arg;	/**< @brief sample RSS and metadata cache size every given number of milliseconds during the HDF5 writes, 0 disables (default='0').  */
+  char * mem_interval_orig;	/**< @brief sample RSS and metadata cache size every given number of milliseconds during the HDF5 writes, 0 disables original value given at command line.  */
+  const char *mem_interval_help; /**< @brief sample RSS and metadata cache size every given number of milliseconds during the HDF5 writes, 0 disables help description.  */
+  int free_list_limit_arg;	/**< @brief cap every HDF5 free list and the total of each kind of free list to the given number of bytes, -1 means no limit (default='-1').  */
+  char * free_list_limit_orig;	/**< @brief cap every HDF5 free list and the total of each kind of free list to the given number of bytes, -1 means no limit original value given at command line.  */
+  const char *free_list_limit_help; /**< @brief cap every HDF5 free list and the total of each kind of free list to the given number of bytes, -1 means no limit help description.  */
+  int timeline_bucket_arg;	/**< @brief record the throughput of the raw and HDF5 writes in buckets of the given number of milliseconds, 0 disables (default='100').  */
+  char * timeline_bucket_orig;	/**< @brief record the throughput of the raw and HDF5 writes in buckets of the given number of milliseconds, 0 disables original value given at command line.  */
+  const char *timeline_bucket_help; /**< @brief record the throughput of the raw and HDF5 writes in buckets of the given number of milliseconds, 0 disables help description.  */
+  int progress_arg;	/**< @brief print the throughput every given number of seconds while writing, 0 disables (default='0').  */
+  char * progress_orig;	/**< @brief print the throughput every given number of seconds while writing, 0 disables original value given at command line.  */
+  const char *progress_help; /**< @brief print the throughput every given number of seconds while writing, 0 disables help description.  */
+  int nbuffers_arg;	/**< @brief number of chunk buffers written in turn, each with different data; memory use is independent of the file size (default='1').  */
+  char * nbuffers_orig;	/**< @brief number of chunk buffers written in turn, each with different data; memory use is independent of the file size original value given at command line.  */
+  const char *nbuffers_help; /**< @brief number of chunk buffers written in turn, each with different data; memory use is independent of the file size help description.  */
+  int raw_fallocate_flag;	/**< @brief preallocate the raw file with fallocate() before the timed writes (default=off).  */
+  const char *raw_fallocate_help; /**< @brief preallocate the raw file with fallocate() before the timed writes help description.  */
+  int h5_alloc_early_flag;	/**< @brief allocate all chunks when the dataset is created (H5D_ALLOC_TIME_EARLY, H5D_FILL_TIME_NEVER) (default=off).  */
+  const char *h5_alloc_early_help; /**< @brief allocate all chunks when the dataset is created (H5D_ALLOC_TIME_EARLY, H5D_FILL_TIME_NEVER) help description.  */
+  int frame_meta_arg;	/**< @brief append a compound record per frame to a second dataset, the given number of frames per append: 1 per frame, chunk-size per chunk, a multiple of it every few chunks; 0 disables (default='0').  */
+  char * frame_meta_orig;	/**< @brief append a compound record per frame to a second dataset, the given number of frames per append: 1 per frame, chunk-size per chunk, a multiple of it every few chunks; 0 disables original value given at command line.  */
+  const char *frame_meta_help; /**< @brief append a compound record per frame to a second dataset, the given number of frames per append: 1 per frame, chunk-size per chunk, a multiple of it every few chunks; 0 disables help description.  */
+  char * buffers_arg;	/**< @brief backing of the chunk buffers: malloc, thp (transparent hugepages) or hugetlb (reserved hugepages) (default='malloc').  */
+  char * buffers_orig;	/**< @brief backing of the chunk buffers: malloc, thp (transparent hugepages) or hugetlb (reserved hugepages) original value given at command line.  */
+  const char *buffers_help; /**< @brief backing of the chunk buffers: malloc, thp (transparent hugepages) or hugetlb (reserved hugepages) help description.  */
+  int prefault_flag;	/**< @brief touch every page of the chunk buffers right after allocation (default=off).  */
+  const char *prefault_help; /**< @brief touch every page of the chunk buffers right after allocation help description.  */
+  char * cpus_arg;	/**< @brief pin the benchmark and all its threads to the given cpus, e.g. 0-7,16.  */
+  char * cpus_orig;	/**< @brief pin the benchmark and all its threads to the given cpus, e.g. 0-7,16 original value given at command line.  */
+  const char *cpus_help; /**< @brief pin the benchmark and all its threads to the given cpus, e.g. 0-7,16 help description.  */
+  int numa_node_arg;	/**< @brief bind the chunk buffers to the given NUMA node and prefer it for all other memory, -1 leaves the placement to the kernel (default='-1').  */
+  char * numa_node_orig;	/**< @brief bind the chunk buffers to the given NUMA node and prefer it for all other memory, -1 leaves the placement to the kernel original value given at command line.  */
+  const char *numa_node_help; /**< @brief bind the chunk buffers to the given NUMA node and prefer it for all other memory, -1 leaves the placement to the kernel help description.  */
+  int nprocs_arg;	/**< @brief run the raw and HDF5 writes in this many processes at once, each with its own files basename.p<rank>.raw/.h5 and output in basename.p<rank>.log (default='1').  */
+  char * nprocs_orig;	/**< @brief run the raw and HDF5 writes in this many processes at once, each with its own files basename.p<rank>.raw/.h5 and output in basename.p<rank>.log original value given at command line.  */
+  const char *nprocs_help; /**< @brief run the raw and HDF5 writes in this many processes at once, each with its own files basename.p<rank>.raw/.h5 and output in basename.p<rank>.log help description.  */
+  int nprocs_sweep_flag;	/**< @brief run with 1, 2, 4, ... up to nprocs processes (default=off).  */
+  const char *nprocs_sweep_help; /**< @brief run with 1, 2, 4, ... up to nprocs processes help description.  */
+  int write_threads_arg;	/**< @brief write a dataset per thread with H5DOwrite_chunk() from this many threads into one file, compared with as many processes writing a file each; more than one thread needs a thread-safe HDF5, 0 disables (default='0').  */
+  char * write_threads_orig;	/**< @brief write a dataset per thread with H5DOwrite_chunk() from this many threads into one file, compared with as many processes writing a file each; more than one thread needs a thread-safe HDF5, 0 disables original value given at command line.  */
+  const char *write_threads_help; /**< @brief write a dataset per thread with H5DOwrite_chunk() from this many threads into one file, compared with as many processes writing a file each; more than one thread needs a thread-safe HDF5, 0 disables help description.  */
+  int write_threads_sweep_flag;	/**< @brief run with 1, 2, 4, ... up to write-threads writers (default=off).  */
+  const char *write_threads_sweep_help; /**< @brief run with 1, 2, 4, ... up to write-threads writers help description.  */
+  char * raw_engines_arg;	/**< @brief comma separated list of raw baselines: write, pwrite, writev, mmap or all; the raw results and the h5 relative performance are from the fastest (default='write').  */
+  char * raw_engines_orig;	/**< @brief comma separated list of raw baselines: write, pwrite, writev, mmap or all; the raw results and the h5 relative performance are from the fastest original value given at command line.  */
+  const char *raw_engines_help; /**< @brief comma separated list of raw baselines: write, pwrite, writev, mmap or all; the raw results and the h5 relative performance are from the fastest help description.  */
+  int writev_chunks_arg;	/**< @brief number of chunks per writev() call of the writev raw engine (default='16').  */
+  char * writev_chunks_orig;	/**< @brief number of chunks per writev() call of the writev raw engine original value given at command line.  */
+  const char *writev_chunks_help; /**< @brief number of chunks per writev() call of the writev raw engine help description.  */
+  int stage_flag;	/**< @brief direct writes append the chunks to a log basename.stage, a converter thread ingests the log into the HDF5 file with H5DOwrite_chunk() at the same time (default=off).  */
+  const char *stage_help; /**< @brief direct writes append the chunks to a log basename.stage, a converter thread ingests the log into the HDF5 file with H5DOwrite_chunk() at the same time help description.  */
+  double stage_rate_arg;	/**< @brief limit the converter of --stage to the given MiB/s, 0 for no limit (default='0').  */
+  char * stage_rate_orig;	/**< @brief limit the converter of --stage to the given MiB/s, 0 for no limit original value given at command line.  */
+  const char *stage_rate_help; /**< @brief limit the converter of --stage to the given MiB/s, 0 for no limit help description.  */
+  long alignment_arg;	/**< @brief align objects in the HDF5 file of at least this size, or the chunk size if smaller, to a multiple of it (H5Pset_alignment), 0 disables (default='0').  */
+  char * alignment_orig;	/**< @brief align objects in the HDF5 file of at least this size, or the chunk size if smaller, to a multiple of it (H5Pset_alignment), 0 disables original value given at command line.  */
+  const char *alignment_help; /**< @brief align objects in the HDF5 file of at least this size, or the chunk size if smaller, to a multiple of it (H5Pset_alignment), 0 disables help description.  */
+  double tune_arg;	/**< @brief search chunk size, alignment and metadata tuning for the best sustained H5DOwrite_chunk() rate within the given number of seconds and print the recommended command line, 0 disables (default='0').  */
+  char * tune_orig;	/**< @brief search chunk size, alignment and metadata tuning for the best sustained H5DOwrite_chunk() rate within the given number of seconds and print the recommended command line, 0 disables original value given at command line.  */
+  const char *tune_help; /**< @brief search chunk size, alignment and metadata tuning for the best sustained H5DOwrite_chunk() rate within the given number of seconds and print the recommended command line, 0 disables help description.  */
+  int repeat_arg;	/**< @brief run the raw and HDF5 writes this many times in one process and report mean, median, standard deviation, 95% confidence interval and outliers of every result (default='1').  */
+  char * repeat_orig;	/**< @brief run the raw and HDF5 writes this many times in one process and report mean, median, standard deviation, 95% confidence interval and outliers of every result original value given at command line.  */
+  const char *repeat_help; /**< @brief run the raw and HDF5 writes this many times in one process and report mean, median, standard deviation, 95% confidence interval and outliers of every result help description.  */
+  int warmup_arg;	/**< @brief runs before the repeated ones that are not counted (default='0').  */
+  char * warmup_orig;	/**< @brief runs before the repeated ones that are not counted original value given at command line.  */
+  const char *warmup_help; /**< @brief runs before the repeated ones that are not counted help description.  */
+  char * order_arg;	/**< @brief order of the raw and HDF5 write phases: raw-first, h5-first, alternate (swap with every run of --repeat) or random (default='raw-first').  */
+  char * order_orig;	/**< @brief order of the raw and HDF5 write phases: raw-first, h5-first, alternate (swap with every run of --repeat) or random original value given at command line.  */
+  const char *order_help; /**< @brief order of the raw and HDF5 write phases: raw-first, h5-first, alternate (swap with every run of --repeat) or random help description.  */
+  double quiesce_arg;	/**< @brief before every timed phase sync and wait up to the given number of seconds until dirty and writeback pages in /proc/meminfo drop below quiesce-dirty, 0 disables (default='0').  */
+  char * quiesce_orig;	/**< @brief before every timed phase sync and wait up to the given number of seconds until dirty and writeback pages in /proc/meminfo drop below quiesce-dirty, 0 disables original value given at command line.  */
+  const char *quiesce_help; /**< @brief before every timed phase sync and wait up to the given number of seconds until dirty and writeback pages in /proc/meminfo drop below quiesce-dirty, 0 disables help description.  */
+  int quiesce_dirty_arg;	/**< @brief threshold of --quiesce in MiB (default='16').  */
+  char * quiesce_dirty_orig;	/**< @brief threshold of --quiesce in MiB original value given at command line.  */
+  const char *quiesce_dirty_help; /**< @brief threshold of --quiesce in MiB help description.  */
+  char * scenario_arg;	/**< @brief write the datasets described in the given scenario file into basename.scenario.h5, each at its own frame rate, instead of the raw and HDF5 comparison; see the scenarios directory.  */
+  char * scenario_orig;	/**< @brief write the datasets described in the given scenario file into basename.scenario.h5, each at its own frame rate, instead of the raw and HDF5 comparison; see the scenarios directory original value given at command line.  */
+  const char *scenario_help; /**< @brief write the datasets described in the given scenario file into basename.scenario.h5, each at its own frame rate, instead of the raw and HDF5 comparison; see the scenarios directory help description.  */
+  char * checksum_arg;	/**< @brief store a checksum with every chunk: none, fletcher32 (H5Pset_fletcher32) or crc32c (PSI CRC32C filter); direct writes append the checksum before H5DOwrite_chunk() (default='none').  */
+  char * checksum_orig;	/**< @brief store a checksum with every chunk: none, fletcher32 (H5Pset_fletcher32) or crc32c (PSI CRC32C filter); direct writes append the checksum before H5DOwrite_chunk() original value given at command line.  */
+  const char *checksum_help; /**< @brief store a checksum with every chunk: none, fletcher32 (H5Pset_fletcher32) or crc32c (PSI CRC32C filter); direct writes append the checksum before H5DOwrite_chunk() help description.  */
+  char * tail_arg;	/**< @brief direct writes of a partial chunk at the end, when nimages is no multiple of chunk-size: pad (zero-padded whole chunk with H5DOwrite_chunk) or h5dwrite (default='pad').  */
+  char * tail_orig;	/**< @brief direct writes of a partial chunk at the end, when nimages is no multiple of chunk-size: pad (zero-padded whole chunk with H5DOwrite_chunk) or h5dwrite original value given at command line.  */
+  const char *tail_help; /**< @brief direct writes of a partial chunk at the end, when nimages is no multiple of chunk-size: pad (zero-padded whole chunk with H5DOwrite_chunk) or h5dwrite help description.  */
+  char * write_order_arg;	/**< @brief order of the chunk writes of the HDF5 phase: sequential, reverse, strided, shuffled or interleaved; all but sequential insert into the middle of the chunk index (default='sequential').  */
+  char * write_order_orig;	/**< @brief order of the chunk writes of the HDF5 phase: sequential, reverse, strided, shuffled or interleaved; all but sequential insert into the middle of the chunk index original value given at command line.  */
+  const char *write_order_help; /**< @brief order of the chunk writes of the HDF5 phase: sequential, reverse, strided, shuffled or interleaved; all but sequential insert into the middle of the chunk index help description.  */
+  long write_stride_arg;	/**< @brief chunks between two writes of --write-order strided (default='16').  */
+  char * write_stride_orig;	/**< @brief chunks between two writes of --write-order strided original value given at command line.  */
+  const char *write_stride_help; /**< @brief chunks between two writes of --write-order strided help description.  */
+  int write_streams_arg;	/**< @brief streams of --write-order interleaved, each writes its own contiguous part of the dataset in turn with the others (default='4').  */
+  char * write_streams_orig;	/**< @brief streams of --write-order interleaved, each writes its own contiguous part of the dataset in turn with the others original value given at command line.  */
+  const char *write_streams_help; /**< @brief streams of --write-order interleaved, each writes its own contiguous part of the dataset in turn with the others help description.  */
+  int write_seed_arg;	/**< @brief seed of the permutation of --write-order shuffled (default='1').  */
+  char * write_seed_orig;	/**< @brief seed of the permutation of --write-order shuffled original value given at command line.  */
+  const char *write_seed_help; /**< @brief seed of the permutation of --write-order shuffled help description.  */
+  int overwrite_arg;	/**< @brief write basename.overwrite.h5 with bitshuffle+LZ4 compressed chunks, then rewrite a fraction of the chunks with other compressed sizes in this many passes, each opening the file anew; done for every strategy of fs-strategies, 0 disables (default='0').  */
+  char * overwrite_orig;	/**< @brief write basename.overwrite.h5 with bitshuffle+LZ4 compressed chunks, then rewrite a fraction of the chunks with other compressed sizes in this many passes, each opening the file anew; done for every strategy of fs-strategies, 0 disables original value given at command line.  */
+  const char *overwrite_help; /**< @brief write basename.overwrite.h5 with bitshuffle+LZ4 compressed chunks, then rewrite a fraction of the chunks with other compressed sizes in this many passes, each opening the file anew; done for every strategy of fs-strategies, 0 disables help description.  */
+  double overwrite_fraction_arg;	/**< @brief fraction of the chunks every pass of --overwrite rewrites (default='0.25').  */
+  char * overwrite_fraction_orig;	/**< @brief fraction of the chunks every pass of --overwrite rewrites original value given at command line.  */
+  const char *overwrite_fraction_help; /**< @brief fraction of the chunks every pass of --overwrite rewrites help description.  */
+  char * fs_strategies_arg;	/**< @brief comma separated list of file space strategies of --overwrite (H5Pset_file_space_strategy): fsm-aggr, fsm-persist, page, page-persist, aggr, none or all; the persist variants keep the free space across closing the file (default='fsm-aggr,fsm-persist').  */
+  char * fs_strategies_orig;	/**< @brief comma separated list of file space strategies of --overwrite (H5Pset_file_space_strategy): fsm-aggr, fsm-persist, page, page-persist, aggr, none or all; the persist variants keep the free space across closing the file original value given at command line.  */
+  const char *fs_strategies_help; /**< @brief comma separated list of file space strategies of --overwrite (H5Pset_file_space_strategy): fsm-aggr, fsm-persist, page, page-persist, aggr, none or all; the persist variants keep the free space across closing the file help description.  */
   
   unsigned int help_given ;	/**< @brief Whether help was given.  */
   unsigned int version_given ;	/**< @brief Whether version was given.  */
@@ -72,6 +205,53 @@ struct gengetopt_args_info
   unsigned int traditional_given ;	/**< @brief Whether traditional was given.  */
   unsigned int metadata_tuning_given ;	/**< @brief Whether metadata-tuning was given.  */
   unsigned int json_given ;	/**< @brief Whether json was given.  */
+  unsigned int trace_given ;	/**< @brief Whether trace was given.  */
+  unsigned int trace_records_given ;	/**< @brief Whether trace-records was given.  */
+  unsigned int filter_mode_given ;	/**< @brief Whether filter-mode was given.  */
+  unsigned int nfilters_given ;	/**< @brief Whether nfilters was given.  */
+  unsigned int bshuf_lz4_given ;	/**< @brief Whether bshuf-lz4 was given.  */
+  unsigned int bshuf_impl_given ;	/**< @brief Whether bshuf-impl was given.  */
+  unsigned int data_given ;	/**< @brief Whether data was given.  */
+  unsigned int adaptive_given ;	/**< @brief Whether adaptive was given.  */
+  unsigned int read_threads_given ;	/**< @brief Whether read-threads was given.  */
+  unsigned int read_sweep_given ;	/**< @brief Whether read-sweep was given.  */
+  unsigned int mem_interval_given ;	/**< @brief Whether mem-interval was given.  */
+  unsigned int free_list_limit_given ;	/**< @brief Whether free-list-limit was given.  */
+  unsigned int timeline_bucket_given ;	/**< @brief Whether timeline-bucket was given.  */
+  unsigned int progress_given ;	/**< @brief Whether progress was given.  */
+  unsigned int nbuffers_given ;	/**< @brief Whether nbuffers was given.  */
+  unsigned int raw_fallocate_given ;	/**< @brief Whether raw-fallocate was given.  */
+  unsigned int h5_alloc_early_given ;	/**< @brief Whether h5-alloc-early was given.  */
+  unsigned int frame_meta_given ;	/**< @brief Whether frame-meta was given.  */
+  unsigned int buffers_given ;	/**< @brief Whether buffers was given.  */
+  unsigned int prefault_given ;	/**< @brief Whether prefault was given.  */
+  unsigned int cpus_given ;	/**< @brief Whether cpus was given.  */
+  unsigned int numa_node_given ;	/**< @brief Whether numa-node was given.  */
+  unsigned int nprocs_given ;	/**< @brief Whether nprocs was given.  */
+  unsigned int nprocs_sweep_given ;	/**< @brief Whether nprocs-sweep was given.  */
+  unsigned int write_threads_given ;	/**< @brief Whether write-threads was given.  */
+  unsigned int write_threads_sweep_given ;	/**< @brief Whether write-threads-sweep was given.  */
+  unsigned int raw_engines_given ;	/**< @brief Whether raw-engines was given.  */
+  unsigned int writev_chunks_given ;	/**< @brief Whether writev-chunks was given.  */
+  unsigned int stage_given ;	/**< @brief Whether stage was given.  */
+  unsigned int stage_rate_given ;	/**< @brief Whether stage-rate was given.  */
+  unsigned int alignment_given ;	/**< @brief Whether alignment was given.  */
+  unsigned int tune_given ;	/**< @brief Whether tune was given.  */
+  unsigned int repeat_given ;	/**< @brief Whether repeat was given.  */
+  unsigned int warmup_given ;	/**< @brief Whether warmup was given.  */
+  unsigned int order_given ;	/**< @brief Whether order was given.  */
+  unsigned int quiesce_given ;	/**< @brief Whether quiesce was given.  */
+  unsigned int quiesce_dirty_given ;	/**< @brief Whether quiesce-dirty was given.  */
+  unsigned int scenario_given ;	/**< @brief Whether scenario was given.  */
+  unsigned int checksum_given ;	/**< @brief Whether checksum was given.  */
+  unsigned int tail_given ;	/**< @brief Whether tail was given.  */
+  unsigned int write_order_given ;	/**< @brief Whether write-order was given.  */
+  unsigned int write_stride_given ;	/**< @brief Whether write-stride was given.  */
+  unsigned int write_streams_given ;	/**< @brief Whether write-streams was given.  */
+  unsigned int write_seed_given ;	/**< @brief Whether write-seed was given.  */
+  unsigned int overwrite_given ;	/**< @brief Whether overwrite was given.  */
+  unsigned int overwrite_fraction_given ;	/**< @brief Whether overwrite-fraction was given.  */
+  unsigned int fs_strategies_given ;	/**< @brief Whether fs-strategies was given.  */
 
   char **inputs ; /**< @brief unamed options (options without names) */
   unsigned inputs_num ; /**< @brief unamed options number */
@@ -5,6 +5,8 @@
  *      Author: billich
  */
 
+#define _GNU_SOURCE   /* fallocate */
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/time.h>       /* timeval */
@@ -14,382 +16,1543 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/utsname.h>
+#include <limits.h>
 
 #include "cmdline.h"
 #include "hdf5.h"
 #include "hdf5_hl.h"
 #include "psi_passthrough_filter.h"
-
-enum { NDIM=3, MAX_IMAGE_DIM=8000, MAX_BASENAME_LENGTH=256, INIT_VALUE=127, METADATA_BLOCK_SIZE=1024*1024 };
+#include "psi_trace_vfd.h"
+#include "psi_bshuf_lz4_filter.h"
+#include "psi_parallel_read.h"
+#include "psi_mem_monitor.h"
+#include "psi_timeline.h"
+#include "psi_frame_meta.h"
+#include "psi_buffer_pool.h"
+#include "psi_numa.h"
+#include "psi_nprocs.h"
+#include "psi_write_threads.h"
+#include "psi_raw_engine.h"
+#include "psi_log_stage.h"
+#include "psi_tuner.h"
+#include "psi_stats.h"
+#include "psi_writeback.h"
+#include "psi_scenario.h"
+#include "psi_checksum_filter.h"
+#include "psi_write_order.h"
+
+// H5Dread_chunk() and H5Pset_file_space_strategy(), see the Makefile
+#if !H5_VERSION_GE(1,10,3)
+#error "h5direct_write_benchmark needs HDF5 1.10.3 or later"
+#endif
+
+enum { NDIM=3, MAX_BASENAME_LENGTH=256, INIT_VALUE=127, METADATA_BLOCK_SIZE=1024*1024, MAX_READ_RUNS=16, MAX_NPROCS=1024, MAX_SWEEP_RUNS=32,
+       MAX_METRICS=256, MAX_METRIC_NAME=64, LATENCY_GROUPS=10 };
+
+// HDF5 stores the size of a chunk in 32 bit
+#define MAX_CHUNK_BYTES  0xffffffffULL
+
+#define DATASET_NAME     "data"
+#define FRAME_META_NAME  "frame_meta"
 
 double timediff(const struct timeval *start, const struct timeval *end)
 {
 	return (double) (end->tv_sec - start->tv_sec + (end->tv_usec - start->tv_usec)*1.e-6);
 }
 
-int main(int argc, char *argv[])
+// fill a chunk with test data
+//   constant: all bytes INIT_VALUE
+//   detector: mostly zero, few small photon counts, compresses well with bitshuffle
+//   random:   incompressible noise
+int fill_chunk_buffer(char *buf, size_t size, const char *pattern, unsigned int seed)
 {
+	if (strcmp(pattern, "constant") == 0) {
+		memset(buf, INIT_VALUE, size);
+	} else if (strcmp(pattern, "detector") == 0) {
+		for (size_t i = 0; i < size; i++) {
+			seed = seed*1103515245 + 12345;
+			buf[i] = ((seed >> 16) % 16 == 0) ? (char)((seed >> 24) % 8) : 0;
+		}
+	} else if (strcmp(pattern, "random") == 0) {
+		for (size_t i = 0; i < size; i++) {
+			seed = seed*1103515245 + 12345;
+			buf[i] = (char)(seed >> 24);
+		}
+	} else {
+		return -1;
+	}
+	return 0;
+}
 
-	struct timeval wall_raw_start = {0,0};
-	struct timeval wall_raw_end = {0,0};
-	struct timeval wall_h5_start = {0,0};
-	struct timeval wall_h5_end = {0,0};
-	clock_t cpu_raw_start, cpu_raw_end, cpu_h5_end, cpu_h5_start;
-	double cpu_raw_elapsed, cpu_h5_elapsed;
-	double  wall_raw_elapsed = 0.;
-	double wall_h5_elapsed = 0.;
-
-	long long nbytes = 0;
-	size_t chunk_size = 0;
-	long long ncalls = 0;
-	double overhead, overhead_per_chunk;
-
-	time_t now;
-	struct utsname uts;
+// read benchmark: every chunk must match the buffer it was written from
+typedef struct chunk_source_t {
+	char **bufs;
+	int nbufs;
+	long long nfull;       // chunks before a partial one at the end
+	size_t tail_bytes;     // of the partial chunk
+} chunk_source_t;
 
-	char rawfile_name[MAX_BASENAME_LENGTH+5];  // suffix .raw + trailing /0
-	char h5file_name[MAX_BASENAME_LENGTH+5];
-	const char rawsuffix[] = ".raw";
-	const char h5suffix[] = ".h5";
+int check_chunk(long long index, const void *data, size_t size, void *arg)
+{
+	const chunk_source_t *source = arg;
+	// only the part of the partial chunk inside the dataset is defined
+	if (index == source->nfull && source->tail_bytes > 0 && size > source->tail_bytes) size = source->tail_bytes;
+	return memcmp(data, source->bufs[index % source->nbufs], size) != 0;
+}
 
-	char *buf = NULL;
+// physical memory in bytes, -1 if unknown
+long long physical_memory(void)
+{
+#ifdef _SC_PHYS_PAGES
+	long pages = sysconf(_SC_PHYS_PAGES);
+	long page_size = sysconf(_SC_PAGESIZE);
+	if (pages > 0 && page_size > 0) return (long long) pages * page_size;
+#endif
+	return -1;
+}
 
-	struct stat h5_filestat;
-	struct stat raw_filestat;
+int bshuf_impl_from_name(const char *name)
+{
+	if (strcmp(name, "auto") == 0) return PSI_BSHUF_IMPL_AUTO;
+	if (strcmp(name, "scalar") == 0) return PSI_BSHUF_IMPL_SCALAR;
+	if (strcmp(name, "sse2") == 0) return PSI_BSHUF_IMPL_SSE2;
+	if (strcmp(name, "avx2") == 0) return PSI_BSHUF_IMPL_AVX2;
+	return -1;
+}
 
-	int rawfd = -1;
-	int status;
+// file access property list for -m and --alignment, H5P_DEFAULT without
+// either. Objects of at least the alignment or the chunk size, whichever is
+// smaller, start at a multiple of the alignment.
+hid_t create_file_access(int metadata_tuning, long long alignment, size_t chunk_size)
+{
+	H5AC_cache_config_t cache_config;
+	hid_t fapl;
+	herr_t ret;
 
+	if (!metadata_tuning && alignment <= 0) return H5P_DEFAULT;
+	fapl = H5Pcreate(H5P_FILE_ACCESS);
+	if (fapl < 0) {
+		printf("failed to create file access property list\n");
+		return -1;
+	}
 
-	// parse command line arguments and do basic checks
-	// ------------------------------------------------
-	struct gengetopt_args_info args;
-	cmdline_parser(argc, argv, &args);
+	if (metadata_tuning) {
+		ret = H5Pset_meta_block_size(fapl, METADATA_BLOCK_SIZE);
+		if (ret < 0) {
+			printf("#failed to set meta block size\n");
+			goto fail;
+		}
 
-	if (args.nx_arg <= 0 || args.ny_arg <= 0 || args.nimages_arg <= 0) {
-		printf("ERROR: nx, ny and nimages both must be positive and none-zero\n");
-		goto fail;
+		cache_config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+		ret = H5Pget_mdc_config(fapl, &cache_config);
+		if (ret < 0) {
+			printf("#ERROR failed to get mdc config\n");
+			goto fail;
+		}
+		cache_config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+		cache_config.set_initial_size = 1;
+		cache_config.initial_size = 32*1024*1024;
+		cache_config.min_size = 8*1024*1024;
+		cache_config.max_size = 128*1024*1024;
 
+		ret = H5Pset_mdc_config(fapl, &cache_config);
+		if (ret < 0) {
+			printf("#ERROR set_mdc_config failed\n");
+			goto fail;
+		}
 	}
 
-	if (args.chunk_size_arg <= 0) {
-		printf("ERROR: chunk_size must be positive and none-zero\n");
-		goto fail;
+	if (alignment > 0) {
+		hsize_t threshold = (hsize_t) alignment < chunk_size ? (hsize_t) alignment : chunk_size;
+		ret = H5Pset_alignment(fapl, threshold, alignment);
+		if (ret < 0) {
+			printf("ERROR: failed to set alignment to %lli bytes\n", alignment);
+			goto fail;
+		}
 	}
+	return fapl;
 
-	if (args.nx_arg > MAX_IMAGE_DIM || args.ny_arg > MAX_IMAGE_DIM) {
-		printf("ERROR: nx and ny both must be smaller then %i\n", MAX_IMAGE_DIM);
-		goto fail;
-	}
+fail:
+	H5Pclose(fapl);
+	return -1;
+}
 
-	if (args.nimages_arg % args.chunk_size_arg != 0) {
-		printf("ERROR:  image number %i is no multiple of chunk size %i", args.nimages_arg, args.chunk_size_arg);
-		goto fail;
+// comma separated list of names or "all" (the nnames known ones), lookup
+// maps a name to its index. Fills index[] without duplicates, returns the
+// number of entries or -1 for an unknown name
+int parse_name_list(const char *list, int (*lookup)(const char *name), int nnames, int *index)
+{
+	char name[32];
+	int n = 0;
+
+	while (*list != '\0') {
+		size_t len = strcspn(list, ",");
+		if (len == 0 || len >= sizeof(name)) return -1;
+		memcpy(name, list, len);
+		name[len] = '\0';
+		list += list[len] == ',' ? len + 1 : len;
+
+		if (strcmp(name, "all") == 0) {
+			for (int i = 0; i < nnames; i++)
+				index[i] = i;
+			return nnames;
+		}
+		int k = lookup(name);
+		if (k < 0) return -1;
+		int seen = 0;
+		for (int i = 0; i < n; i++)
+			if (index[i] == k) seen = 1;
+		if (!seen) index[n++] = k;
 	}
+	return n > 0 ? n : -1;
+}
 
+// open the json file for appending and start a record with the mode and
+// the node name, the caller adds its keys, ends the record and closes the file
+FILE *open_json_record(const char *json_name, const char *mode)
+{
+	struct utsname uts;
+	FILE *jsonfile = fopen(json_name, "a");
 
-	// initialization
-	// --------------
-	ncalls     = args.nimages_arg / args.chunk_size_arg;
-	chunk_size = args.nx_arg * args.ny_arg * args.chunk_size_arg;
-    nbytes     = ncalls*chunk_size;
-
-	buf = (char *)malloc(chunk_size);
-	if (buf == NULL) {
-		perror("failed to allocate buffer space");
-		goto fail;
+	if (jsonfile == NULL) {
+		perror("ERROR: failed to open file for json output");
+		return NULL;
 	}
-	memset(buf, INIT_VALUE, chunk_size);
-
-	strncpy(rawfile_name, args.basename_arg,MAX_BASENAME_LENGTH);
-	strncpy(rawfile_name+strlen(args.basename_arg), rawsuffix,4);
+	if (uname(&uts) == -1) strcpy(uts.nodename, "unknown");
+	fprintf(jsonfile, "{ \n"
+			"  \"mode\":\"%s\", \n"
+			"  \"nodename\":\"%s\", \n",
+			mode, uts.nodename);
+	return jsonfile;
+}
 
-	strncpy(h5file_name, args.basename_arg,MAX_BASENAME_LENGTH);
-	strncpy(h5file_name+strlen(args.basename_arg), h5suffix,4);
+// --quiesce: wait for the writeback of the page cache before a phase,
+// returns the seconds waited
+double quiesce(const struct gengetopt_args_info *args)
+{
+	double waited;
+
+	if (args->quiesce_arg <= 0.) return 0.;
+	printf("# wait for writeback ...\n");
+	waited = wait_psi_writeback_quiet(args->quiesce_dirty_arg*1024LL*1024LL, args->quiesce_arg);
+	if (waited < 0.) {
+		printf("# writeback not done after %.1lf s, continue anyway\n", args->quiesce_arg);
+		return args->quiesce_arg;
+	}
+	return waited;
+}
 
-	unlink(rawfile_name);
-	unlink(h5file_name);
+// --order: whether the HDF5 phase of this run comes first. alternate
+// swaps the order with every run of the process, so that with --repeat
+// the phases go raw h5 h5 raw raw h5 ...
+int h5_phase_first(const char *order)
+{
+	static int nrun = 0;
+	int run = nrun++;
 
+	if (strcmp(order, "h5-first") == 0) return 1;
+	if (strcmp(order, "alternate") == 0) return run % 2;
+	if (strcmp(order, "random") == 0) return rand() % 2;
+	return 0;
+}
 
+// the raw writes, once with every engine. The results are those of the
+// fastest engine.
+typedef struct raw_phase_t {
+	double engine_elapsed[PSI_RAW_NENGINES];
+	int best;                 // index of the fastest engine
+	struct timeval start;
+	struct timeval end;
+	double elapsed;
+	double cpu_elapsed;
+	double create_elapsed;    // fallocate
+	long long faults;
+	psi_timeline_t timeline;
+	double quiesce_wait;
+	long long dirty_before;   // dirty and writeback bytes at the start
+} raw_phase_t;
+
+int run_raw_phase(const struct gengetopt_args_info *args, const char *file_name, char **bufs, int nbufs,
+		size_t chunk_size, long long ncalls, size_t tail_bytes, const int *engines, int nengines, raw_phase_t *raw)
+{
+	long long nbytes = ncalls*(long long)chunk_size + tail_bytes;
+	struct timeval create_start, create_end;
+	psi_raw_writer_t writer;
+	psi_timeline_t timeline;   // of the engine running, raw->timeline keeps the fastest
+	int fd = -1;
+
+	memset(raw, 0, sizeof(*raw));
+	memset(&writer, 0, sizeof(writer));
+	writer.fd = -1;
+	memset(&timeline, 0, sizeof(timeline));
+	psi_proc_barrier();    // common start with --nprocs
+	for (int e = 0; e < nengines; e++) {
+		const char *engine_name = get_psi_raw_engine_name(engines[e]);
+		struct timeval start, end;
+		clock_t cpu_start, cpu_end;
+		long long faults;
+		double create_elapsed = 0.;
+		double quiesce_wait;
+		long long dirty_before;
+		ssize_t n;
+
+		memset(&timeline, 0, sizeof(timeline));
+
+		// preallocate the raw file, like the HDF5 file this is not part of
+		// the timed writes
+		if (args->raw_fallocate_flag) {
+			printf("# preallocate raw file ...\n");
+			gettimeofday(&create_start, NULL);
+			fd = open(file_name, O_RDWR|O_CREAT|O_TRUNC, S_IRWXU);
+			if (fd == -1) {
+				printf("ERROR:open failed for %s\n", file_name);
+				perror(NULL);
+				goto fail;
+			}
+			if (fallocate(fd, 0, 0, nbytes) == -1) {
+				perror("ERROR: fallocate of raw file failed");
+				goto fail;
+			}
+			if (close(fd) == -1) {
+				fd = -1;
+				perror("ERROR: close of raw file failed");
+				goto fail;
+			}
+			fd = -1;
+			gettimeofday(&create_end, NULL);
+			create_elapsed = timediff(&create_start, &create_end);
+		}
 
-	// RAW writes
-	// -------------------
-	printf("# start raw writes ...\n");
-	status = gettimeofday(&wall_raw_start, NULL);
-	cpu_raw_start = clock();
+		quiesce_wait = quiesce(args);
+		dirty_before = get_psi_dirty_bytes();
+		printf("# start raw writes with %s ...\n", engine_name);
+		gettimeofday(&start, NULL);
+		cpu_start = clock();
+		faults = get_psi_page_faults();
 
-	rawfd = open(rawfile_name, O_RDWR|O_CREAT|O_TRUNC, S_IRWXU);
-	if (rawfd == -1) {
-		printf("ERROR:open failed for %s\n", rawfile_name);
-		perror(NULL);
-		goto fail;
-	}
+		// don't truncate, that would drop the preallocated blocks
+		if (open_psi_raw_writer(&writer, engines[e], file_name, nbytes, args->writev_chunks_arg, args->raw_fallocate_flag) < 0) {
+			goto fail;
+		}
+		init_psi_timeline(&timeline, "raw", args->timeline_bucket_arg*1.e-3, args->progress_arg);
 
-	for (long long i = 0; i < ncalls; i++) {
-		ssize_t n = write(rawfd, (void *)buf, chunk_size);
+		for (long long i = 0; i < ncalls; i++) {
+			n = psi_raw_write(&writer, bufs[i % nbufs], chunk_size);
+			if (n == -1) {
+				perror("ERROR: raw write failed");
+				goto fail;
+			}
+			if (n > 0) add_psi_timeline(&timeline, n);
+		}
+		if (tail_bytes > 0) {   // the partial chunk at the end
+			n = psi_raw_write(&writer, bufs[ncalls % nbufs], tail_bytes);
+			if (n == -1) {
+				perror("ERROR: raw write failed");
+				goto fail;
+			}
+			if (n > 0) add_psi_timeline(&timeline, n);
+		}
+		n = flush_psi_raw_writer(&writer);
 		if (n == -1) {
 			perror("ERROR: raw write failed");
 			goto fail;
 		}
-	}
+		if (n > 0) add_psi_timeline(&timeline, n);
 
-	status = close(rawfd);
-	if (status == -1) {
-		perror("ERROR: close of raw file failed");
-		goto fail;
+		if (close_psi_raw_writer(&writer) == -1) {
+			perror("ERROR: close of raw file failed");
+			goto fail;
+		}
+		finish_psi_timeline(&timeline);
+		faults = get_psi_page_faults() - faults;
+		gettimeofday(&end, NULL);
+		cpu_end = clock();
+
+		raw->engine_elapsed[e] = timediff(&start, &end);
+		printf("# elapsed time for raw writes with %s: %.3lfs\n", engine_name, raw->engine_elapsed[e]);
+		if (e == 0 || raw->engine_elapsed[e] < raw->elapsed) {
+			free_psi_timeline(&raw->timeline);
+			raw->timeline = timeline;
+			raw->best = e;
+			raw->start = start;
+			raw->end = end;
+			raw->elapsed = raw->engine_elapsed[e];
+			raw->cpu_elapsed = (double) (cpu_end - cpu_start)/(double) CLOCKS_PER_SEC;
+			raw->create_elapsed = create_elapsed;
+			raw->faults = faults;
+			raw->quiesce_wait = quiesce_wait;
+			raw->dirty_before = dirty_before;
+		} else {
+			free_psi_timeline(&timeline);
+		}
+		memset(&timeline, 0, sizeof(timeline));
 	}
-	status = gettimeofday(&wall_raw_end, NULL);
-	cpu_raw_end = clock();
 	printf("# raw write done\n");
+	return 0;
+
+fail:
+	if (fd != -1) close(fd);
+	close_psi_raw_writer(&writer);
+	free_psi_timeline(&timeline);
+	free_psi_timeline(&raw->timeline);
+	return -1;
+}
 
-	wall_raw_elapsed = timediff(&wall_raw_start, &wall_raw_end);
-	cpu_raw_elapsed = (double) (cpu_raw_end - cpu_raw_start)/(double) CLOCKS_PER_SEC;
-	printf("# elapsed time for raw writes: %.3lfs\n", wall_raw_elapsed);
+// size of the B-tree or other chunk index and of the object header of a
+// dataset. 1.12 moved both from H5O_info_t to H5O_native_info_t.
+herr_t get_dataset_meta_sizes(hid_t dset, long long *index_size, long long *header_size)
+{
+#if H5_VERSION_GE(1,12,0)
+	H5O_native_info_t info;
+	if (H5Oget_native_info(dset, &info, H5O_NATIVE_INFO_HDR | H5O_NATIVE_INFO_META_SIZE) < 0) return -1;
+#else
+	H5O_info_t info;
+	if (H5Oget_info2(dset, &info, H5O_INFO_HDR | H5O_INFO_META_SIZE) < 0) return -1;
+#endif
+	*index_size = info.meta_size.obj.index_size;
+	*header_size = info.hdr.space.total;
+	return 0;
+}
 
-	// opent the raw file again, just to ensure that the HDF5 file will get a different filedescriptor number
-	// this makes parsing of strace output much easier - the raw file has fd=3 and the h5file fd=4
-	rawfd = open(rawfile_name, O_RDONLY);
+// compress a chunk for H5DOwrite_chunk() like the filter would do. With a
+// ratio below the adaptive threshold the chunk is stored as it is. Returns
+// 1 then, 0 if *data and *size are the compressed chunk in cbuf and -1 on
+// failure.
+int compress_direct_chunk(const char *chunk, size_t chunk_size, char *cbuf, size_t cbuf_size, double adaptive,
+		const char **data, size_t *size)
+{
+	size_t csize = psi_bshuf_lz4_compress(chunk, chunk_size, 1, 0, cbuf, cbuf_size);
 
-	// create the HDF5 file
-	// --------------------
-	herr_t ret;
-	hid_t h5fileid, space, memspace, dcpl, dset, fapl;
-	hsize_t dims[NDIM], chunk[NDIM], offset[NDIM];
-	hsize_t start[NDIM], count[NDIM];
-	H5AC_cache_config_t cache_config;
+	if (csize == 0) {
+		printf("ERROR: bitshuffle+LZ4 compression failed\n");
+		return -1;
+	}
+	if (adaptive > 0. && (double)chunk_size < adaptive*(double)csize) {
+		// not worth it, the caller tells HDF5 to skip the filter on read
+		*data = chunk;
+		*size = chunk_size;
+		return 1;
+	}
+	*data = cbuf;
+	*size = csize;
+	return 0;
+}
 
-	if (args.metadata_tuning_flag) {
-		printf("# apply metadata tuning for HDF5\n");
-		fapl = H5Pcreate(H5P_FILE_ACCESS);
-		if (fapl < 0) {
-			printf("failed to create file access property list\n");
-			goto fail;
-		}
-		ret = H5Pset_meta_block_size(fapl, METADATA_BLOCK_SIZE);
-		if (ret < 0) {
-			printf("#failed to set meta block size\n");
-			goto fail;
-		}
+// create the HDF5 file with the dataset and the frame metadata, not part of
+// the timed writes. skip_mask is the filter_mask of chunks stored with the
+// bitshuffle+LZ4 filter skipped.
+int create_h5_file(const struct gengetopt_args_info *args, const char *file_name, hid_t fapl, int checksum,
+		unsigned int *skip_mask)
+{
+	hid_t h5fileid = -1, space = -1, dcpl = -1, dset = -1;
+	hsize_t dims[NDIM] = { args->nimages_arg, args->ny_arg, args->nx_arg };
+	hsize_t chunk[NDIM] = { args->chunk_size_arg, args->ny_arg, args->nx_arg };
+	unsigned int filter_mode = args->filter_mode_arg;
+	herr_t ret;
 
+	*skip_mask = 0;
+	h5fileid = H5Fcreate(file_name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+	if (h5fileid < 0) goto fail;
+	space = H5Screate_simple(NDIM, dims, NULL);
+	if (space < 0) goto fail;
+
+	// dataset creation property list
+	dcpl = H5Pcreate(H5P_DATASET_CREATE);
+	if (dcpl < 0) goto fail;
+	for (int i = 0; i < args->nfilters_arg; i++) {
+		if (H5Pset_filter(dcpl, PSI_PASSTHROUGH_FILTER, H5Z_FLAG_MANDATORY, 1, &filter_mode) < 0) goto fail;
+	}
+	if (args->bshuf_lz4_flag) {
+		if (H5Pset_filter(dcpl, PSI_BSHUF_LZ4_FILTER, H5Z_FLAG_MANDATORY, 0, NULL) < 0) goto fail;
+		*skip_mask = 1u << args->nfilters_arg;   // bit of the bitshuffle+LZ4 filter, it follows the passthrough filters
+	}
+	// the checksum comes last and covers the data as stored
+	if (checksum == PSI_CHECKSUM_FLETCHER32) {
+		if (H5Pset_fletcher32(dcpl) < 0) goto fail;
+	} else if (checksum == PSI_CHECKSUM_CRC32C) {
+		if (H5Pset_filter(dcpl, PSI_CRC32C_FILTER, H5Z_FLAG_MANDATORY, 0, NULL) < 0) goto fail;
+	}
+	if (H5Pset_chunk(dcpl, NDIM, chunk) < 0) goto fail;
+	if (args->h5_alloc_early_flag) {  // allocate all chunks now, without writing fill values
+		if (H5Pset_alloc_time(dcpl, H5D_ALLOC_TIME_EARLY) < 0) goto fail;
+		if (H5Pset_fill_time(dcpl, H5D_FILL_TIME_NEVER) < 0) goto fail;
+	}
 
-		cache_config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
-		ret = H5Pget_mdc_config(fapl, &cache_config);
-		if (ret < 0) {
-			printf("#ERROR failed to get mdc config\n");
-			goto fail;
-		}
-		cache_config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
-		cache_config.set_initial_size = 1;
-		cache_config.initial_size = 32*1024*1024;
-		cache_config.min_size = 8*1024*1024;
-		cache_config.max_size = 128*1024*1024;
+	dset = H5Dcreate(h5fileid, DATASET_NAME, H5T_STD_U8LE, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+	if (dset < 0) goto fail;
 
-		ret = H5Pset_mdc_config(fapl, &cache_config);
-		if (ret < 0) {
-			printf("#ERROR set_mdc_config failed\n");
-			goto fail;
-		}
+	if (args->frame_meta_arg > 0 && create_psi_frame_meta(h5fileid, FRAME_META_NAME) < 0) {
+		printf("ERROR: failed to create frame metadata dataset\n");
+		goto fail;
+	}
 
-		// herr_t H5Pget_mdc_config(hid_t plist_id, H5AC_cache_config_t *config_ptr)
-		// version = H5AC__CURR_CACHE_CONFIG_VERSION
-		// herr_t H5Pset_mdc_config(hid_t plist_id, H5AC_cache_config_t *config_ptr)
-		// herr_t H5Pset_meta_block_size( hid_t fapl_id, hsize_t size )
-	} else {
-		fapl = H5P_DEFAULT;
+	// close the HDF5 file and all related objects
+	H5Pclose(dcpl);
+	H5Dclose(dset);
+	H5Sclose(space);
+	ret = H5Fclose(h5fileid);
+	if (ret < 0) {
+		printf("ERROR: failed to close HDF5 file %s\n", file_name);
+		return -1;
 	}
+	return 0;
+
+fail:
+	if (dcpl >= 0) H5Pclose(dcpl);
+	if (dset >= 0) H5Dclose(dset);
+	if (space >= 0) H5Sclose(space);
+	if (h5fileid >= 0) H5Fclose(h5fileid);
+	return -1;
+}
 
+// the HDF5 phase: all chunks with H5DOwrite_chunk(), through the staging
+// log or with H5Dwrite(), and the partial chunk at the end
+typedef struct h5_phase_t {
+	struct timeval start;
+	struct timeval end;
+	double elapsed;
+	double cpu_elapsed;
+	double create_elapsed;
+	double tail_elapsed;        // write of the partial chunk
+	double close_elapsed;
+	long long faults;
+	psi_timeline_t timeline;
+	double quiesce_wait;
+	long long dirty_before;     // dirty and writeback bytes at the start
+	long long storage_size;     // of the dataset
+	long long compressed_bytes;
+	double compress_elapsed;
+	long long raw_chunks;       // stored with the filter skipped
+	double checksum_elapsed;
+	psi_latency_group_t latency_groups[LATENCY_GROUPS];
+	int nlatency_groups;
+	long long rss_before;
+	psi_mem_summary_t mem_summary;
+	psi_passthrough_stats_t filter_stats;
+	psi_trace_summary_t trace_summary;
+	psi_frame_meta_t frame_meta;
+	psi_stage_stats_t stage_stats;
+} h5_phase_t;
+
+int run_h5_phase(const struct gengetopt_args_info *args, const char *file_name, const char *stage_name, hid_t fapl,
+		char **bufs, int nbufs, size_t buf_size, size_t chunk_size, long long ncalls, const long long *chunk_order,
+		char *cbuf, size_t cbuf_size, char *tbuf, int checksum, h5_phase_t *h5)
+{
+	struct timeval create_start, create_end;
+	clock_t cpu_start, cpu_end;
+	hid_t h5fileid = -1, dset = -1, space = -1, memspace = -1;
+	hid_t write_fapl = fapl;
+	hsize_t offset[NDIM], start[NDIM], count[NDIM];
+	hsize_t step = args->chunk_size_arg;
+	long tail_images = args->nimages_arg % args->chunk_size_arg;
+	size_t tail_bytes = (size_t)args->nx_arg * (size_t)args->ny_arg * (size_t)tail_images;
+	unsigned int skip_mask = 0;   // filter_mask of chunks stored uncompressed
+	double *insert_latency = NULL;   // of the i-th write call
+	long long ninserts = 0;
+	psi_stage_t stage;
+	herr_t ret;
 
-	const char dataset_name[] = "data";
+	memset(h5, 0, sizeof(*h5));
+	insert_latency = malloc((ncalls > 0 ? ncalls : 1) * sizeof(double));
+	if (insert_latency == NULL) {
+		perror("failed to allocate the insertion latencies");
+		return -1;
+	}
 
-	ret = register_psi_passthrough_filter();
-	if (ret < 0) {
-		printf("ERROR: failed to register PSI passthrough filter in HDF5 lib\n");
-		goto fail;
+	gettimeofday(&create_start, NULL);
+	if (create_h5_file(args, file_name, fapl, checksum, &skip_mask) < 0) goto fail;
+	gettimeofday(&create_end, NULL);
+	h5->create_elapsed = timediff(&create_start, &create_end);
+
+	// trace the VFD calls of the write phase, the log is dumped after the
+	// timed section
+	if (args->trace_given) {
+		printf("# trace VFD calls of the HDF5 write phase\n");
+		write_fapl = (fapl == H5P_DEFAULT) ? H5Pcreate(H5P_FILE_ACCESS) : H5Pcopy(fapl);
+		if (write_fapl < 0) goto fail;
+		if (set_fapl_psi_trace_vfd(write_fapl, args->trace_records_arg, NULL) < 0) {
+			printf("ERROR: failed to set up the trace VFD\n");
+			goto fail;
+		}
 	}
 
-	// file
-    h5fileid = H5Fcreate(h5file_name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
-    if (h5fileid < 0) {
-    	goto fail;
-    }
-
-    // dataspace
-    dims[0] = args.nimages_arg;
-    dims[1] = args.ny_arg;
-    dims[2] = args.nx_arg;
-    space = H5Screate_simple(NDIM, dims, NULL);
-    if (space < 0) goto fail;
-
-    // dataset creation property list
-    chunk[0] = args.chunk_size_arg;
-    chunk[1] = args.ny_arg;
-    chunk[2] = args.nx_arg;
-    dcpl = H5Pcreate(H5P_DATASET_CREATE);
-    if (dcpl < 0) goto fail;
-    status = H5Pset_filter(dcpl, PSI_PASSTHROUGH_FILTER, H5Z_FLAG_MANDATORY, 0, NULL);
-    if (status < 0) goto fail;
-    status = H5Pset_chunk(dcpl, NDIM, chunk);
-    if (status < 0) goto fail;
-
-    // dataset
-    dset = H5Dcreate(h5fileid, dataset_name, H5T_STD_U8LE, space, H5P_DEFAULT, dcpl,
-                H5P_DEFAULT);
-    if (dset < 0) goto fail;
-
-    // close the HDF5 file and all related objects
-    ret = H5Pclose (dcpl);
-    ret = H5Dclose (dset);
-    ret = H5Sclose (space);
-    ret = H5Fclose (h5fileid);
-    if (ret < 0) {
-    	printf("ERROR: failed to close HDF5 file %s\n", h5file_name);
-    	goto fail;
-    }
-
-
-    // HDF5 writes
-    // -------------------
+	h5->quiesce_wait = quiesce(args);
+	h5->dirty_before = get_psi_dirty_bytes();
+	psi_proc_barrier();
 	printf("# start HDF5 writes ...\n");
-	status = gettimeofday(&wall_h5_start, NULL);
-	cpu_h5_start = clock();
+	reset_psi_passthrough_filter_stats();
+	gettimeofday(&h5->start, NULL);
+	cpu_start = clock();
+	h5->faults = get_psi_page_faults();
+	init_psi_timeline(&h5->timeline, "h5 ", args->timeline_bucket_arg*1.e-3, args->progress_arg);
 
-
-	h5fileid = H5Fopen(h5file_name,H5F_ACC_RDWR, fapl);
+	h5fileid = H5Fopen(file_name, H5F_ACC_RDWR, write_fapl);
 	if (h5fileid < 0) goto fail;
-	dset = H5Dopen(h5fileid, dataset_name, H5P_DEFAULT);
+	dset = H5Dopen(h5fileid, DATASET_NAME, H5P_DEFAULT);
 	if (dset < 0) goto fail;
 
-	if (!args.traditional_flag) {   // use new H5DOwrite_chunk() call
+	if (args->frame_meta_arg > 0) {
+		if (open_psi_frame_meta(h5fileid, FRAME_META_NAME, args->frame_meta_arg, &h5->frame_meta) < 0) {
+			printf("ERROR: failed to open frame metadata dataset\n");
+			goto fail;
+		}
+	}
+
+	// sample memory usage during the writes
+	h5->rss_before = get_psi_rss();
+	if (args->mem_interval_arg > 0) {
+		H5Freset_mdc_hit_rate_stats(h5fileid);
+		init_psi_mem_monitor(args->mem_interval_arg*1.e-3);
+		tick_psi_mem_monitor(h5fileid);
+	}
+
+	if (!args->traditional_flag) {   // use new H5DOwrite_chunk() call
 		printf("# use new H5DOwrite_chunk() call\n");
 		offset[1] = 0;
 		offset[2] = 0;
 
-		int step = args.chunk_size_arg;
+		if (args->stage_flag) {   // append to the log, a converter thread does the H5DOwrite_chunk() calls
+			size_t max_chunk = cbuf_size > buf_size ? cbuf_size : buf_size;
+			printf("# stage chunks in %s\n", stage_name);
+			if (open_psi_stage(&stage, stage_name, ncalls*(long long)(sizeof(psi_stage_record_t) + max_chunk), ncalls) < 0) {
+				printf("ERROR: failed to create staging log %s\n", stage_name);
+				goto fail;
+			}
+			if (start_psi_stage_converter(&stage, dset, args->stage_rate_arg*1024.*1024.) < 0) goto fail;
+		}
+
 		for (long long i = 0; i < ncalls; i++) {
-			offset[0] = i*step;
-			ret = H5DOwrite_chunk(dset, H5P_DEFAULT, 0, offset, chunk_size, (void *) buf);
+			long long c = chunk_order[i];   // chunk c always holds bufs[c % nbufs]
+			const char *data = bufs[c % nbufs];
+			size_t size = chunk_size;
+			unsigned int mask = 0;
+			struct timeval insert_start, insert_end;
+
+			offset[0] = c*step;
+			if (args->bshuf_lz4_flag) {  // compress the chunk like the filter would do
+				struct timeval compress_start, compress_end;
+				gettimeofday(&compress_start, NULL);
+				int stored_raw = compress_direct_chunk(bufs[c % nbufs], chunk_size, cbuf, cbuf_size, args->adaptive_arg, &data, &size);
+				gettimeofday(&compress_end, NULL);
+				h5->compress_elapsed += timediff(&compress_start, &compress_end);
+				if (stored_raw < 0) goto fail;
+				if (stored_raw) {
+					h5->raw_chunks++;
+					mask = skip_mask;
+				}
+				h5->compressed_bytes += size;
+			}
+			if (checksum != PSI_CHECKSUM_NONE) {  // the trailer the checksum filter would add
+				struct timeval checksum_start, checksum_end;
+				gettimeofday(&checksum_start, NULL);
+				size = psi_append_checksum(checksum, (void *) data, size);
+				gettimeofday(&checksum_end, NULL);
+				h5->checksum_elapsed += timediff(&checksum_start, &checksum_end);
+			}
+			if (args->stage_flag) {   // the converter inserts the chunk later, no insert latency
+				ret = append_psi_stage(&stage, c, data, size, mask);
+			} else {
+				gettimeofday(&insert_start, NULL);
+				ret = H5DOwrite_chunk(dset, H5P_DEFAULT, mask, offset, size, (void *) data);
+				gettimeofday(&insert_end, NULL);
+				insert_latency[ninserts++] = timediff(&insert_start, &insert_end);
+			}
 			if (ret < 0) {
 				printf("hdf5 write failed\n");
 				goto fail;
 			}
+			for (hsize_t f = 0; args->frame_meta_arg > 0 && f < step; f++) {
+				if (add_psi_frame_meta(&h5->frame_meta, offset[0] + f, 0) < 0) {
+					printf("ERROR: append of frame metadata failed\n");
+					goto fail;
+				}
+			}
+			add_psi_timeline(&h5->timeline, chunk_size);
+			tick_psi_mem_monitor(h5fileid);
+		}
+
+		if (args->stage_flag) {
+			printf("# staging done, wait for the converter\n");
+			ret = finish_psi_stage(&stage, &h5->stage_stats);
+			if (close_psi_stage(&stage) < 0 || ret < 0) {
+				printf("ERROR: conversion of staging log %s failed\n", stage_name);
+				goto fail;
+			}
 		}
 	} else {  // traditional, use H5Dwrite()
 		printf("# use traditional H5Dwrite() call\n");
-		// ==== traditional, no direct write
-		dims[0] = args.chunk_size_arg;
-		dims[1] = args.ny_arg;
-		dims[2] = args.nx_arg;
-		memspace = H5Screate_simple(NDIM, dims, NULL);
+		count[0] = args->chunk_size_arg;
+		count[1] = args->ny_arg;
+		count[2] = args->nx_arg;
+		memspace = H5Screate_simple(NDIM, count, NULL);
 		if (memspace < 0) {
 			printf("ERROR: failed to get memspace\n");
 			goto fail;
 		}
-
-		start[0] = 0;
 		start[1] = 0;
 		start[2] = 0;
-
-		count[0] = args.chunk_size_arg;
-		count[1] = args.ny_arg;
-		count[2] = args.nx_arg;
-
-		space = H5Dget_space (dset);
-
-		int step = args.chunk_size_arg;
+		space = H5Dget_space(dset);
+		if (space < 0) goto fail;
 
 		for (long long i = 0; i < ncalls; i++) {
+			long long c = chunk_order[i];
+			struct timeval insert_start, insert_end;
 
-			status = H5Sselect_hyperslab (space, H5S_SELECT_SET, start, NULL, count, NULL);
-			if (status < 0) {
+			start[0] = c*step;
+			if (H5Sselect_hyperslab(space, H5S_SELECT_SET, start, NULL, count, NULL) < 0) {
 				printf("ERROR: select hyperslab failed\n");
 				goto fail;
 			}
-			status = H5Dwrite (dset, H5T_NATIVE_UINT8, memspace, space, H5P_DEFAULT, buf);
-			if (status < 0) {
+			// the chunk cache inserts the chunk of an earlier write when it evicts it
+			gettimeofday(&insert_start, NULL);
+			ret = H5Dwrite(dset, H5T_NATIVE_UINT8, memspace, space, H5P_DEFAULT, bufs[c % nbufs]);
+			gettimeofday(&insert_end, NULL);
+			insert_latency[ninserts++] = timediff(&insert_start, &insert_end);
+			if (ret < 0) {
 				printf("ERROR: write to hdf5 file failed\n");
 				goto fail;
 			}
+			for (hsize_t f = 0; args->frame_meta_arg > 0 && f < step; f++) {
+				if (add_psi_frame_meta(&h5->frame_meta, start[0] + f, 0) < 0) {
+					printf("ERROR: append of frame metadata failed\n");
+					goto fail;
+				}
+			}
+			add_psi_timeline(&h5->timeline, chunk_size);
+			tick_psi_mem_monitor(h5fileid);
+		}
+		H5Sclose(memspace);
+		H5Sclose(space);
+		memspace = space = -1;
+	}
 
-			start[0] += step;
+	// the partial chunk at the end of the acquisition, either padded to a
+	// whole chunk for H5DOwrite_chunk() or left to H5Dwrite()
+	if (tail_images > 0) {
+		struct timeval tail_start, tail_end;
+		hsize_t tail_offset[NDIM] = { ncalls*args->chunk_size_arg, 0, 0 };
+		const char *tail_data = bufs[ncalls % nbufs];
+
+		gettimeofday(&tail_start, NULL);
+		if (tbuf != NULL) {
+			const char *data = tbuf;
+			size_t size = chunk_size;
+			unsigned int mask = 0;
+
+			memcpy(tbuf, tail_data, tail_bytes);
+			memset(tbuf + tail_bytes, 0, chunk_size - tail_bytes);
+			if (args->bshuf_lz4_flag) {   // the same decision as for the other chunks
+				struct timeval compress_start, compress_end;
+				gettimeofday(&compress_start, NULL);
+				int stored_raw = compress_direct_chunk(tbuf, chunk_size, cbuf, cbuf_size, args->adaptive_arg, &data, &size);
+				gettimeofday(&compress_end, NULL);
+				h5->compress_elapsed += timediff(&compress_start, &compress_end);
+				if (stored_raw < 0) goto fail;
+				if (stored_raw) {
+					h5->raw_chunks++;
+					mask = skip_mask;
+				}
+				h5->compressed_bytes += size;
+			}
+			if (checksum != PSI_CHECKSUM_NONE) size = psi_append_checksum(checksum, (void *) data, size);
+			ret = H5DOwrite_chunk(dset, H5P_DEFAULT, mask, tail_offset, size, (void *) data);
+		} else {
+			hsize_t tail_count[NDIM] = { tail_images, args->ny_arg, args->nx_arg };
+			hid_t tail_space = H5Dget_space(dset);
+			hid_t tail_memspace = H5Screate_simple(NDIM, tail_count, NULL);
+			ret = -1;
+			if (tail_space >= 0 && tail_memspace >= 0
+					&& H5Sselect_hyperslab(tail_space, H5S_SELECT_SET, tail_offset, NULL, tail_count, NULL) >= 0)
+				ret = H5Dwrite(dset, H5T_NATIVE_UINT8, tail_memspace, tail_space, H5P_DEFAULT, tail_data);
+			if (tail_memspace >= 0) H5Sclose(tail_memspace);
+			if (tail_space >= 0) H5Sclose(tail_space);
+		}
+		if (ret < 0) {
+			printf("ERROR: write of the partial chunk failed\n");
+			goto fail;
+		}
+		for (long f = 0; args->frame_meta_arg > 0 && f < tail_images; f++) {
+			if (add_psi_frame_meta(&h5->frame_meta, tail_offset[0] + f, 0) < 0) {
+				printf("ERROR: append of frame metadata failed\n");
+				goto fail;
+			}
 		}
+		add_psi_timeline(&h5->timeline, tail_bytes);
+		gettimeofday(&tail_end, NULL);
+		h5->tail_elapsed = timediff(&tail_start, &tail_end);
 	}
 
-	ret = H5Dclose(dset);
-	ret = H5Fclose(h5fileid);
-	if (ret < 0) {
+	// closing flushes what HDF5 still holds, like a partial chunk in the chunk cache
+	struct timeval close_start, close_end;
+	gettimeofday(&close_start, NULL);
+	if (args->frame_meta_arg > 0 && close_psi_frame_meta(&h5->frame_meta) < 0) {
+		printf("ERROR: failed to write the last frame metadata\n");
 		goto fail;
 	}
+	h5->storage_size = H5Dget_storage_size(dset);
+	tick_psi_mem_monitor(h5fileid);
+	get_psi_mem_summary(&h5->mem_summary);
+	H5Dclose(dset);
+	dset = -1;
+	ret = H5Fclose(h5fileid);
+	h5fileid = -1;
+	if (ret < 0) goto fail;
+	gettimeofday(&close_end, NULL);
+	h5->close_elapsed = timediff(&close_start, &close_end);
+	finish_psi_timeline(&h5->timeline);
+	h5->faults = get_psi_page_faults() - h5->faults;
 
-	status = gettimeofday(&wall_h5_end, NULL);
-	cpu_h5_end = clock();
+	gettimeofday(&h5->end, NULL);
+	cpu_end = clock();
 
 	printf("# HDF5 write done\n");
-	close(rawfd);
+	get_psi_passthrough_filter_stats(&h5->filter_stats);
+
+	h5->elapsed = timediff(&h5->start, &h5->end);
+	h5->cpu_elapsed = (double) (cpu_end - cpu_start) / (double) CLOCKS_PER_SEC;
+	printf("# elapsed time for hdf5 writes: %.3lfs\n", h5->elapsed);
+	h5->nlatency_groups = get_psi_latency_groups(insert_latency, ninserts, LATENCY_GROUPS, h5->latency_groups);
+	if (h5->nlatency_groups < 0) {
+		perror("failed to summarize the insertion latency");
+		goto fail;
+	}
 
-	wall_h5_elapsed = timediff(&wall_h5_start, &wall_h5_end);
-	cpu_h5_elapsed = (double) (cpu_h5_end - cpu_h5_start) / (double) CLOCKS_PER_SEC;
-	printf("# elapsed time for hdf5 writes: %.3lfs\n", wall_h5_elapsed);
+	if (args->trace_given) {
+		get_psi_trace_vfd_summary(&h5->trace_summary);
+		printf("# dump VFD trace to %s\n", args->trace_arg);
+		if (dump_psi_trace_vfd_log(args->trace_arg) != 0) {
+			printf("ERROR: failed to dump VFD trace to %s\n", args->trace_arg);
+			goto fail;
+		}
+		H5Pclose(write_fapl);
+	}
+	free(insert_latency);
+	return 0;
+
+fail:
+	if (memspace >= 0) H5Sclose(memspace);
+	if (space >= 0) H5Sclose(space);
+	if (dset >= 0) H5Dclose(dset);
+	if (h5fileid >= 0) H5Fclose(h5fileid);
+	if (write_fapl != fapl && write_fapl >= 0) H5Pclose(write_fapl);
+	free_psi_timeline(&h5->timeline);
+	free(insert_latency);
+	return -1;
+}
 
+// read the first chunks, one from each buffer, and the partial chunk back
+// to verify the writes, and get the sizes of the dataset metadata
+int read_back_h5_file(const struct gengetopt_args_info *args, const char *file_name, char **bufs, int nbufs,
+		size_t chunk_size, long long ncalls, char *rbuf, long long *index_size, long long *header_size)
+{
+	hid_t h5fileid = -1, dset = -1, space = -1, memspace = -1;
+	hsize_t start[NDIM] = { 0, 0, 0 };
+	hsize_t count[NDIM] = { args->chunk_size_arg, args->ny_arg, args->nx_arg };
+	long tail_images = args->nimages_arg % args->chunk_size_arg;
+	size_t tail_bytes = (size_t)args->nx_arg * (size_t)args->ny_arg * (size_t)tail_images;
+	int status = -1;
+
+	// with mixed data the second, incompressible chunk is read as well,
+	// adaptive compression usually stored it with the filter skipped
+	printf("# read first chunk back ...\n");
+	h5fileid = H5Fopen(file_name, H5F_ACC_RDWR, H5P_DEFAULT);
+	if (h5fileid < 0) goto done;
+	dset = H5Dopen(h5fileid, DATASET_NAME, H5P_DEFAULT);
+	if (dset < 0) goto done;
+
+	if (get_dataset_meta_sizes(dset, index_size, header_size) < 0) {
+		printf("ERROR: failed to get the object info of the dataset\n");
+		goto done;
+	}
 
-	// read some data back to verify the writes
-	// ----------------------------------------
-	memset(buf, 0, chunk_size);  // read data back to buffer, initialize with zeroes ...
+	space = H5Dget_space(dset);
+	memspace = H5Screate_simple(NDIM, count, NULL);
+	if (space < 0 || memspace < 0) goto done;
 
-	printf("# read first chunk back ...\n");
-	h5fileid = H5Fopen(h5file_name,H5F_ACC_RDWR, H5P_DEFAULT);
-	if (h5fileid < 0) goto fail;
-	dset = H5Dopen(h5fileid, dataset_name, H5P_DEFAULT);
-	if (dset < 0) goto fail;
+	for (long long c = 0; c < nbufs && c < ncalls; c++) {
+		start[0] = c*args->chunk_size_arg;
+		if (H5Sselect_hyperslab(space, H5S_SELECT_SET, start, NULL, count, NULL) < 0) goto done;
 
-    space = H5Dget_space (dset);
-    start[0] = 0;
-    start[1] = 0;
-    start[2] = 0;
+		memset(rbuf, 0, chunk_size);  // read data back to buffer, initialize with zeroes ...
+		if (H5Dread(dset, H5T_NATIVE_UINT8, memspace, space, H5P_DEFAULT, rbuf) < 0) {
+			printf("ERROR: failed to read back from hdf5 file\n");
+			goto done;
+		}
 
-    count[0] = args.chunk_size_arg;
-    count[1] = args.ny_arg;
-    count[2] = args.nx_arg;
+		for (size_t i=0; i<chunk_size; i++) {
+			if (rbuf[i] != bufs[c][i]) {
+				printf("ERROR: read of HDF5 file returned bogus value %i at byte %zu of chunk %lli\n", rbuf[i], i, c);
+				goto done;
+			}
+		}
+	}
+	if (tail_images > 0) {   // and the partial chunk
+		hsize_t tail_count[NDIM] = { tail_images, args->ny_arg, args->nx_arg };
+		hid_t tail_memspace = H5Screate_simple(NDIM, tail_count, NULL);
+		herr_t ret = -1;
+		start[0] = ncalls*args->chunk_size_arg;
+		memset(rbuf, 0, chunk_size);
+		if (tail_memspace >= 0 && H5Sselect_hyperslab(space, H5S_SELECT_SET, start, NULL, tail_count, NULL) >= 0)
+			ret = H5Dread(dset, H5T_NATIVE_UINT8, tail_memspace, space, H5P_DEFAULT, rbuf);
+		if (tail_memspace >= 0) H5Sclose(tail_memspace);
+		if (ret < 0) {
+			printf("ERROR: failed to read the partial chunk back from hdf5 file\n");
+			goto done;
+		}
+		if (memcmp(rbuf, bufs[ncalls % nbufs], tail_bytes) != 0) {
+			printf("ERROR: read of HDF5 file returned bogus values in the partial chunk\n");
+			goto done;
+		}
+	}
+	printf("# finished to read back first chunk.\n");
+	if (args->frame_meta_arg > 0 && verify_psi_frame_meta(h5fileid, FRAME_META_NAME, args->nimages_arg) != 0) {
+		printf("ERROR: frame metadata is wrong\n");
+		goto done;
+	}
+	status = 0;
+
+done:
+	if (memspace >= 0) H5Sclose(memspace);
+	if (space >= 0) H5Sclose(space);
+	if (dset >= 0) H5Dclose(dset);
+	if (h5fileid >= 0) H5Fclose(h5fileid);
+	return status;
+}
 
-    status = H5Sselect_hyperslab (space, H5S_SELECT_SET, start, NULL, count, NULL);
-    if (status < 0) goto fail;
+// read benchmark: decoding in the filter pipeline vs. H5Dread_chunk() and
+// decoding on a thread pool
+typedef struct read_phase_t {
+	psi_read_stats_t pipeline;
+	psi_read_stats_t parallel[MAX_READ_RUNS];
+	int threads[MAX_READ_RUNS];
+	int nruns;
+} read_phase_t;
+
+int run_read_phase(const struct gengetopt_args_info *args, const char *file_name, chunk_source_t *source,
+		read_phase_t *read)
+{
+	hid_t h5fileid = -1, dset = -1;
+	int status = -1;
 
-    status = H5Dread (dset, H5T_NATIVE_UINT8, H5S_ALL, space, H5P_DEFAULT, buf);
-    if (status < 0) {
-    	printf("ERROR: failed to read back from hdf5 file\n");
-    	goto fail;
-    }
+	memset(read, 0, sizeof(*read));
+	if (args->read_sweep_flag) {
+		for (int t = 1; t < args->read_threads_arg; t *= 2)
+			read->threads[read->nruns++] = t;
+	}
+	read->threads[read->nruns++] = args->read_threads_arg;
 
-    for (long long i=0; i<args.chunk_size_arg; i++) {
-    	if (buf[i] != INIT_VALUE) {
-    		printf("ERROR: read of HDF5 file returned bogus value %i at byte %lli\n", buf[i], i);
-    		goto fail;
-    	}
-    }
-    printf("# finished to read back first chunk.");
-    H5Sclose(space);
-    H5Dclose(dset);
-    H5Fclose(h5fileid);
+	h5fileid = H5Fopen(file_name, H5F_ACC_RDONLY, H5P_DEFAULT);
+	if (h5fileid < 0) goto done;
+	dset = H5Dopen(h5fileid, DATASET_NAME, H5P_DEFAULT);
+	if (dset < 0) goto done;
 
+	printf("# read all chunks with H5Dread() ...\n");
+	if (psi_pipeline_read(dset, check_chunk, source, &read->pipeline) < 0) {
+		printf("ERROR: read through the filter pipeline failed\n");
+		goto done;
+	}
+	for (int r = 0; r < read->nruns; r++) {
+		printf("# read all chunks with H5Dread_chunk() and %i threads ...\n", read->threads[r]);
+		if (psi_parallel_read(dset, read->threads[r], check_chunk, source, &read->parallel[r]) < 0) {
+			printf("ERROR: parallel read failed\n");
+			goto done;
+		}
+		if (read->parallel[r].mismatches > 0) {
+			printf("ERROR: parallel read returned %lli bogus chunks\n", read->parallel[r].mismatches);
+			goto done;
+		}
+	}
+	if (read->pipeline.mismatches > 0) {
+		printf("ERROR: H5Dread returned %lli bogus chunks\n", read->pipeline.mismatches);
+		goto done;
+	}
+	status = 0;
 
-	// show run parameters and node information
-	// ----------------------------------------
-	now = time(NULL);
-	printf("#PARAM date              : %s", ctime(&now));
+done:
+	if (dset >= 0) H5Dclose(dset);
+	if (h5fileid >= 0) H5Fclose(h5fileid);
+	return status;
+}
 
-	if (uname(&uts) != -1) {
-		printf("#PARAM Node name         : %s\n", uts.nodename);
-		printf("#PARAM OS Release        : %s\n", uts.release);
-		printf("#PARAM Machine           : %s\n", uts.machine);
+// basic checks of the command line arguments of a benchmark run, returns
+// 0 if they are fine
+int check_benchmark_args(const struct gengetopt_args_info *args)
+{
+	if (args->nx_arg <= 0 || args->ny_arg <= 0 || args->nimages_arg <= 0) {
+		printf("ERROR: nx, ny and nimages both must be positive and none-zero\n");
+		return -1;
 	}
 
-	printf("#PARAM rawfile name      : %s\n", rawfile_name);
+	if (args->chunk_size_arg <= 0) {
+		printf("ERROR: chunk_size must be positive and none-zero\n");
+		return -1;
+	}
+	// HDF5 rejects chunks larger than a fixed size dataset
+	if (args->chunk_size_arg > args->nimages_arg) {
+		printf("ERROR: chunk size %li exceeds the number of images %li\n", args->chunk_size_arg, args->nimages_arg);
+		return -1;
+	}
+
+	// the chunk has to fit into HDF5's 32 bit chunk size, the total into 63 bit
+	if ((double)args->nx_arg*(double)args->ny_arg*(double)args->chunk_size_arg > (double)MAX_CHUNK_BYTES) {
+		printf("ERROR: chunk of %li x %li x %li bytes exceeds the HDF5 limit of %llu bytes\n",
+				args->chunk_size_arg, args->ny_arg, args->nx_arg, MAX_CHUNK_BYTES);
+		return -1;
+	}
+	if ((double)args->nx_arg*(double)args->ny_arg*(double)args->nimages_arg > (double)LLONG_MAX) {
+		printf("ERROR: total size of %li images exceeds %lli bytes\n", args->nimages_arg, LLONG_MAX);
+		return -1;
+	}
+
+	if (args->nbuffers_arg <= 0) {
+		printf("ERROR: nbuffers must be positive and none-zero\n");
+		return -1;
+	}
+
+	if (args->nfilters_arg < 0 || args->nfilters_arg > H5Z_MAX_NFILTERS) {
+		printf("ERROR: nfilters must be between 0 and %i\n", H5Z_MAX_NFILTERS);
+		return -1;
+	}
+
+	if (args->filter_mode_arg < 0 || args->filter_mode_arg >= PSI_PASSTHROUGH_NMODES) {
+		printf("ERROR: filter mode must be between 0 and %i\n", PSI_PASSTHROUGH_NMODES-1);
+		return -1;
+	}
+
+	if (args->timeline_bucket_arg < 0 || args->progress_arg < 0) {
+		printf("ERROR: timeline bucket and progress interval must not be negative\n");
+		return -1;
+	}
+
+	if (args->progress_arg > 0 && args->timeline_bucket_arg == 0) {
+		printf("ERROR: progress lines need the timeline, timeline-bucket must not be 0\n");
+		return -1;
+	}
+
+	if (args->frame_meta_arg < 0) {
+		printf("ERROR: frame metadata batch must not be negative\n");
+		return -1;
+	}
+
+	if (args->mem_interval_arg < 0) {
+		printf("ERROR: memory sample interval must not be negative\n");
+		return -1;
+	}
+
+	if (args->free_list_limit_arg < -1) {
+		printf("ERROR: free list limit must be -1 or a size in bytes\n");
+		return -1;
+	}
+
+	if (args->read_threads_arg < 0 || args->read_threads_arg > PSI_PARALLEL_READ_MAX_THREADS) {
+		printf("ERROR: read threads must be between 0 and %i\n", PSI_PARALLEL_READ_MAX_THREADS);
+		return -1;
+	}
+
+	if (args->alignment_arg < 0) {
+		printf("ERROR: alignment must not be negative\n");
+		return -1;
+	}
+
+	if (args->writev_chunks_arg < 1 || args->writev_chunks_arg > PSI_RAW_MAX_IOV) {
+		printf("ERROR: writev chunks must be between 1 and %i\n", PSI_RAW_MAX_IOV);
+		return -1;
+	}
+
+	if (args->stage_flag && args->traditional_flag) {
+		printf("ERROR: staging needs direct writes\n");
+		return -1;
+	}
+	if (args->stage_rate_arg < 0.) {
+		printf("ERROR: staging conversion rate must not be negative\n");
+		return -1;
+	}
+#ifndef H5_HAVE_THREADSAFE
+	// the converter thread writes the HDF5 file while the main thread appends
+	if (args->stage_flag && (args->frame_meta_arg > 0 || args->mem_interval_arg > 0)) {
+		printf("ERROR: staging with frame-meta or mem-interval needs a thread-safe HDF5\n");
+		return -1;
+	}
+#endif
+
+	if (strcmp(args->tail_arg, "pad") != 0 && strcmp(args->tail_arg, "h5dwrite") != 0) {
+		printf("ERROR: unknown tail policy %s, use pad or h5dwrite\n", args->tail_arg);
+		return -1;
+	}
+	return 0;
+}
+
+// one complete benchmark run, returns 0 on success
+// --repeat: the numbers of every #RESULTS line over the runs, filled by
+// run_benchmark() directly
+typedef struct metric_t {
+	char name[MAX_METRIC_NAME];
+	double *samples;
+	int n;
+} metric_t;
+
+typedef struct results_t {
+	metric_t *metrics;      // MAX_METRICS
+	int nmetrics;
+	int nmax_samples;
+	int failed;             // too many metrics or a name too long
+} results_t;
+
+// add a sample of the k-th number of a #RESULTS line, the numbers after the
+// first get " (k)" appended to the name. Nothing is done without results.
+void add_result(results_t *results, const char *label, int k, double value)
+{
+	char name[MAX_METRIC_NAME];
+	int m, len;
+
+	if (results == NULL) return;
+	if (k == 1) len = snprintf(name, sizeof(name), "%s", label);
+	else len = snprintf(name, sizeof(name), "%s (%i)", label, k);
+	if (len >= (int) sizeof(name)) {
+		results->failed = 1;
+		return;
+	}
+	for (m = 0; m < results->nmetrics; m++)
+		if (strcmp(results->metrics[m].name, name) == 0) break;
+	if (m == results->nmetrics) {
+		if (m == MAX_METRICS) {
+			results->failed = 1;
+			return;
+		}
+		results->metrics[m].samples = calloc(results->nmax_samples, sizeof(double));
+		if (results->metrics[m].samples == NULL) {
+			results->failed = 1;
+			return;
+		}
+		strcpy(results->metrics[m].name, name);
+		results->metrics[m].n = 0;
+		results->nmetrics++;
+	}
+	if (results->metrics[m].n < results->nmax_samples)
+		results->metrics[m].samples[results->metrics[m].n++] = value;
+}
+
+// print a #RESULTS line with one number and add it to the results
+void report_result(results_t *results, const char *label, int precision, double value)
+{
+	printf("#RESULTS %-28s: %.*lf\n", label, precision, value);
+	add_result(results, label, 1, value);
+}
+
+// the results go to stdout and the json file, with results != NULL the
+// numbers are added to results too
+int run_benchmark(struct gengetopt_args_info args, results_t *results)
+{
+
+	struct timeval wall_raw_start = {0,0};
+	struct timeval wall_raw_end = {0,0};
+	struct timeval wall_h5_start = {0,0};
+	struct timeval wall_h5_end = {0,0};
+	double wall_raw_create = 0.;
+	double wall_h5_create = 0.;
+	double cpu_raw_elapsed = 0., cpu_h5_elapsed;
+	double  wall_raw_elapsed = 0.;
+	double wall_h5_elapsed = 0.;
+
+	long long nbytes = 0;
+	size_t chunk_size = 0;
+	long long ncalls = 0;         // full chunks
+	long tail_images = 0;         // in a partial chunk at the end
+	size_t tail_bytes = 0;
+	char *tbuf = NULL;            // padded partial chunk
+	int write_order = PSI_WRITE_SEQUENTIAL;
+	long write_order_param = 0;
+	long long *chunk_order = NULL;   // chunk index of the i-th write
+	long long chunk_index_size = 0, h5_object_header_size = 0;
+	double overhead, overhead_per_chunk;
+
+	time_t now;
+	struct utsname uts;
+
+	char rawfile_name[MAX_BASENAME_LENGTH+5];  // suffix .raw + trailing /0
+	char h5file_name[MAX_BASENAME_LENGTH+5];
+	char stagefile_name[MAX_BASENAME_LENGTH+7];
+	const char rawsuffix[] = ".raw";
+	const char h5suffix[] = ".h5";
+	const char stagesuffix[] = ".stage";
+
+	char **bufs = NULL;    // chunk i is written from bufs[i % nbufs]
+	int nbufs = 1;
+	long long buffer_bytes = 0;
+	long long faults_setup_start, faults_setup = 0, faults_raw = 0, faults_h5 = 0;
+	long long huge_bytes = 0;
+	int buffer_node = -1, storage_node = -1;
+	char *rbuf = NULL;
+	char *cbuf = NULL;         // compressed chunk for direct writes
+	size_t cbuf_size = 0;
+	int checksum = PSI_CHECKSUM_NONE;
+	size_t buf_size = 0;          // chunk and room for a checksum trailer
+
+	struct stat h5_filestat;
+	struct stat raw_filestat;
+
+	int rawfd = -1;
+	int status;
+	int ret = 1;
+	raw_phase_t raw_phase;
+	int h5_first = 0, raw_phase_done = 0;
+	int raw_engines[PSI_RAW_NENGINES];
+	int nraw_engines = 0;
+	double raw_engine_elapsed[PSI_RAW_NENGINES];
+	int best_raw = 0;    // index of the fastest engine, all raw results are from this one
+	h5_phase_t h5_phase;
+	read_phase_t read_phase;
+	hid_t fapl = -1;
+
+	psi_timeline_t raw_timeline, h5_timeline;
+	psi_timeline_summary_t raw_timeline_summary, h5_timeline_summary;
+
+
+	psi_proc_result_t proc_result;
+	memset(&proc_result, 0, sizeof(proc_result));
+	memset(&raw_timeline, 0, sizeof(raw_timeline));
+	memset(&h5_timeline, 0, sizeof(h5_timeline));
+
+
+	// basic checks of the command line arguments
+	// ------------------------------------------
+	if (check_benchmark_args(&args) != 0) goto fail;
+
+	nraw_engines = parse_name_list(args.raw_engines_arg, psi_raw_engine_from_name, PSI_RAW_NENGINES, raw_engines);
+	if (nraw_engines < 0) {
+		printf("ERROR: raw engines must be a list of write, pwrite, writev and mmap, or all\n");
+		goto fail;
+	}
+
+	write_order = psi_write_order_from_name(args.write_order_arg);
+	if (write_order < 0) {
+		printf("ERROR: unknown write order %s, use sequential, reverse, strided, shuffled or interleaved\n", args.write_order_arg);
+		goto fail;
+	}
+	if (write_order == PSI_WRITE_STRIDED && args.write_stride_arg < 1) {
+		printf("ERROR: write-stride must be positive and none-zero\n");
+		goto fail;
+	}
+	if (write_order == PSI_WRITE_INTERLEAVED && args.write_streams_arg < 1) {
+		printf("ERROR: write-streams must be positive and none-zero\n");
+		goto fail;
+	}
+	// the frame metadata is verified to hold the frames in ascending order
+	if (write_order != PSI_WRITE_SEQUENTIAL && args.frame_meta_arg > 0) {
+		printf("ERROR: frame-meta needs the sequential write order\n");
+		goto fail;
+	}
+	if (write_order == PSI_WRITE_STRIDED) write_order_param = args.write_stride_arg;
+	else if (write_order == PSI_WRITE_INTERLEAVED) write_order_param = args.write_streams_arg;
+	else if (write_order == PSI_WRITE_SHUFFLED) write_order_param = args.write_seed_arg;
+
+
+	// initialization
+	// --------------
+	ncalls     = args.nimages_arg / args.chunk_size_arg;
+	chunk_size = (size_t)args.nx_arg * (size_t)args.ny_arg * (size_t)args.chunk_size_arg;
+	tail_images = args.nimages_arg % args.chunk_size_arg;
+	tail_bytes = (size_t)args.nx_arg * (size_t)args.ny_arg * (size_t)tail_images;
+    nbytes     = ncalls*(long long)chunk_size + tail_bytes;
+
+	chunk_order = get_psi_write_order(write_order, ncalls, write_order_param);
+	if (chunk_order == NULL) {
+		perror("failed to allocate the write order");
+		goto fail;
+	}
+
+	// mixed data alternates compressible and incompressible chunks
+	nbufs = args.nbuffers_arg;
+	if (strcmp(args.data_arg, "mixed") == 0 && nbufs < 2) nbufs = 2;
+
+	// all buffers plus the one for the read back and the compressed chunk
+	// must fit into memory, whatever the size of the file
+	buffer_bytes = (nbufs + 1) * (long long)chunk_size;
+	if (args.bshuf_lz4_flag) buffer_bytes += psi_bshuf_lz4_bound(chunk_size, 1, 0);
+	if (physical_memory() > 0 && buffer_bytes > physical_memory()) {
+		printf("ERROR: buffers need %lli bytes, more than the %lli bytes of memory\n", buffer_bytes, physical_memory());
+		goto fail;
+	}
+
+	// placement: pin first, so that the first touch happens on the right cpus
+	if (args.cpus_given && set_psi_cpu_affinity(args.cpus_arg) != 0) {
+		printf("ERROR: failed to pin to cpus %s\n", args.cpus_arg);
+		goto fail;
+	}
+	if (args.numa_node_arg >= 0) {
+		if (set_psi_numa_preferred(args.numa_node_arg) != 0) {
+			printf("ERROR: failed to prefer NUMA node %i\n", args.numa_node_arg);
+			goto fail;
+		}
+		set_psi_buffer_pool_node(args.numa_node_arg);
+	}
+
+	if (init_psi_buffer_pool(psi_buffer_mode_from_name(args.buffers_arg), args.prefault_flag) < 0) {
+		printf("ERROR: unknown buffer backing %s\n", args.buffers_arg);
+		goto fail;
+	}
+	faults_setup_start = get_psi_page_faults();
+
+	checksum = psi_checksum_from_name(args.checksum_arg);
+	if (checksum < 0) {
+		printf("ERROR: unknown checksum %s, use none, fletcher32 or crc32c\n", args.checksum_arg);
+		goto fail;
+	}
+	// direct writes append the checksum right behind the chunk data
+	buf_size = chunk_size + (checksum != PSI_CHECKSUM_NONE ? PSI_CHECKSUM_SIZE : 0);
+
+	bufs = (char **)calloc(nbufs, sizeof(char *));
+	if (bufs == NULL) {
+		perror("failed to allocate buffer space");
+		goto fail;
+	}
+	for (int b = 0; b < nbufs; b++) {
+		bufs[b] = (char *)get_psi_buffer(buf_size);
+		if (bufs[b] == NULL) {
+			perror("failed to allocate buffer space");
+			goto fail;
+		}
+		if (strcmp(args.data_arg, "mixed") == 0) {
+			status = fill_chunk_buffer(bufs[b], chunk_size, b % 2 == 0 ? "detector" : "random", b + 1);
+		} else {
+			status = fill_chunk_buffer(bufs[b], chunk_size, args.data_arg, b + 1);
+		}
+		if (status < 0) {
+			printf("ERROR: unknown chunk data %s\n", args.data_arg);
+			goto fail;
+		}
+	}
+
+	if (args.adaptive_arg < 0.) {
+		printf("ERROR: adaptive compression ratio threshold must not be negative\n");
+		goto fail;
+	}
+	if (args.adaptive_arg > 0. && (!args.bshuf_lz4_flag || args.traditional_flag)) {
+		printf("ERROR: adaptive compression needs --bshuf-lz4 and direct writes\n");
+		goto fail;
+	}
+
+	if (args.bshuf_lz4_flag) {
+		if (set_psi_bshuf_impl(bshuf_impl_from_name(args.bshuf_impl_arg)) < 0) {
+			printf("ERROR: bitshuffle implementation %s is not available\n", args.bshuf_impl_arg);
+			goto fail;
+		}
+		cbuf_size = psi_bshuf_lz4_bound(chunk_size, 1, 0) + PSI_CHECKSUM_SIZE;
+		cbuf = (char *)get_psi_buffer(cbuf_size);
+		if (cbuf == NULL) {
+			perror("failed to allocate buffer space");
+			goto fail;
+		}
+	}
+	rbuf = (char *)get_psi_buffer(chunk_size);
+	if (rbuf == NULL) {
+		perror("failed to allocate buffer space");
+		goto fail;
+	}
+	if (tail_images > 0 && !args.traditional_flag && strcmp(args.tail_arg, "pad") == 0) {
+		tbuf = (char *)get_psi_buffer(buf_size);
+		if (tbuf == NULL) {
+			perror("failed to allocate buffer space");
+			goto fail;
+		}
+	}
+	faults_setup = get_psi_page_faults() - faults_setup_start;
+	buffer_node = get_psi_memory_node(bufs[0]);
+	huge_bytes = get_psi_huge_bytes();
+
+	if (strlen(args.basename_arg) > MAX_BASENAME_LENGTH) {
+		printf("ERROR: basename is longer than %i characters\n", MAX_BASENAME_LENGTH);
+		goto fail;
+	}
+	snprintf(rawfile_name, sizeof(rawfile_name), "%s%s", args.basename_arg, rawsuffix);
+	snprintf(h5file_name, sizeof(h5file_name), "%s%s", args.basename_arg, h5suffix);
+	snprintf(stagefile_name, sizeof(stagefile_name), "%s%s", args.basename_arg, stagesuffix);
+
+	unlink(rawfile_name);
+	unlink(h5file_name);
+
+
+
+	// phase order, the HDF5 phase either follows the raw phase or comes first
+	h5_first = h5_phase_first(args.order_arg);
+	if (!h5_first) {
+		if (run_raw_phase(&args, rawfile_name, bufs, nbufs, chunk_size, ncalls, tail_bytes, raw_engines, nraw_engines, &raw_phase) != 0)
+			goto fail;
+		raw_phase_done = 1;
+	}
+
+	// opent the raw file again, just to ensure that the HDF5 file will get a different filedescriptor number
+	// this makes parsing of strace output much easier - the raw file has fd=3 and the h5file fd=4
+	// (with the HDF5 phase first the raw file is still missing, create it empty)
+	rawfd = open(rawfile_name, O_RDONLY|O_CREAT, S_IRWXU);
+
+	// the HDF5 file and the library
+	// -----------------------------
+	if (args.metadata_tuning_flag) printf("# apply metadata tuning for HDF5\n");
+	if (args.alignment_arg > 0) printf("# align objects in the HDF5 file to %li bytes\n", args.alignment_arg);
+	fapl = create_file_access(args.metadata_tuning_flag, args.alignment_arg, chunk_size);
+	if (fapl < 0) goto fail;
+
+	if (register_psi_passthrough_filter() < 0) {
+		printf("ERROR: failed to register PSI passthrough filter in HDF5 lib\n");
+		goto fail;
+	}
+	if (register_psi_bshuf_lz4_filter() < 0) {
+		printf("ERROR: failed to register PSI bitshuffle+LZ4 filter in HDF5 lib\n");
+		goto fail;
+	}
+	if (register_psi_crc32c_filter() < 0) {
+		printf("ERROR: failed to register PSI CRC32C filter in HDF5 lib\n");
+		goto fail;
+	}
+
+	if (args.free_list_limit_arg >= 0) {
+		int limit = args.free_list_limit_arg;
+		if (H5set_free_list_limits(limit, limit, limit, limit, limit, limit) < 0) {
+			printf("ERROR: failed to set free list limits\n");
+			goto fail;
+		}
+	}
+
+
+	// HDF5 writes
+	// -----------
+	status = run_h5_phase(&args, h5file_name, stagefile_name, fapl, bufs, nbufs, buf_size, chunk_size, ncalls,
+			chunk_order, cbuf, cbuf_size, tbuf, checksum, &h5_phase);
+	if (rawfd != -1) close(rawfd);
+	rawfd = -1;
+	if (status != 0) goto fail;
+	wall_h5_start = h5_phase.start;
+	wall_h5_end = h5_phase.end;
+	wall_h5_elapsed = h5_phase.elapsed;
+	cpu_h5_elapsed = h5_phase.cpu_elapsed;
+	wall_h5_create = h5_phase.create_elapsed;
+	faults_h5 = h5_phase.faults;
+	h5_timeline = h5_phase.timeline;
+
+	if (!raw_phase_done) {
+		if (run_raw_phase(&args, rawfile_name, bufs, nbufs, chunk_size, ncalls, tail_bytes, raw_engines, nraw_engines, &raw_phase) != 0)
+			goto fail;
+		raw_phase_done = 1;
+	}
+	wall_raw_start = raw_phase.start;
+	wall_raw_end = raw_phase.end;
+	wall_raw_elapsed = raw_phase.elapsed;
+	cpu_raw_elapsed = raw_phase.cpu_elapsed;
+	wall_raw_create = raw_phase.create_elapsed;
+	faults_raw = raw_phase.faults;
+	raw_timeline = raw_phase.timeline;
+	best_raw = raw_phase.best;
+	memcpy(raw_engine_elapsed, raw_phase.engine_elapsed, sizeof(raw_engine_elapsed));
+
+
+	// read some data back to verify the writes
+	// ----------------------------------------
+	if (read_back_h5_file(&args, h5file_name, bufs, nbufs, chunk_size, ncalls, rbuf,
+			&chunk_index_size, &h5_object_header_size) != 0)
+		goto fail;
+
+
+	// read benchmark: decoding in the filter pipeline vs. H5Dread_chunk()
+	// and decoding on a thread pool. The file was just written, so this
+	// mostly reads from the page cache and measures the decoding.
+	// -------------------------------------------------------------------
+	if (args.read_threads_arg > 0) {
+		chunk_source_t source = { bufs, nbufs, ncalls, tail_bytes };
+		if (run_read_phase(&args, h5file_name, &source, &read_phase) != 0) goto fail;
+	}
+
+
+	// show run parameters and node information
+	// ----------------------------------------
+	now = time(NULL);
+	printf("#PARAM date              : %s", ctime(&now));
+
+	if (uname(&uts) != -1) {
+		printf("#PARAM Node name         : %s\n", uts.nodename);
+		printf("#PARAM OS Release        : %s\n", uts.release);
+		printf("#PARAM Machine           : %s\n", uts.machine);
+	}
+
+	printf("#PARAM rawfile name      : %s\n", rawfile_name);
 	printf("#PARAM h5file name       : %s\n", h5file_name );
 	printf("#PARAM chunk size [Byte] : %zi\n", chunk_size);
 	printf("#PARAM ncalls            : %lli\n", ncalls);
+	if (tail_images > 0) {
+		printf("#PARAM partial chunk     : %li images, %s\n", tail_images,
+				args.traditional_flag || strcmp(args.tail_arg, "h5dwrite") == 0 ? "H5Dwrite" : "padded");
+	} else {
+		printf("#PARAM partial chunk     : none\n");
+	}
 	printf("#PARAM total size [Byte] : %lli\n", nbytes);
-	printf("#PARAM array shape       : (z=%i,y=%i,x=%i)\n", args.nimages_arg, args.ny_arg, args.nx_arg);
-	printf("#PARAM chunk shape       : (z=%i,y=%i,x=%i)\n",  args.chunk_size_arg, args.ny_arg, args.nx_arg);
+	printf("#PARAM array shape       : (z=%li,y=%li,x=%li)\n", args.nimages_arg, args.ny_arg, args.nx_arg);
+	printf("#PARAM chunk shape       : (z=%li,y=%li,x=%li)\n",  args.chunk_size_arg, args.ny_arg, args.nx_arg);
+	if (write_order == PSI_WRITE_STRIDED) {
+		printf("#PARAM write order       : strided, every %li chunks\n", write_order_param);
+	} else if (write_order == PSI_WRITE_INTERLEAVED) {
+		printf("#PARAM write order       : interleaved, %li streams\n", write_order_param);
+	} else if (write_order == PSI_WRITE_SHUFFLED) {
+		printf("#PARAM write order       : shuffled, seed %li\n", write_order_param);
+	} else {
+		printf("#PARAM write order       : %s\n", get_psi_write_order_name(write_order));
+	}
+	printf("#PARAM chunk buffers     : %i (%lli Byte)\n", nbufs, buffer_bytes);
+	printf("#PARAM buffer backing    : %s%s\n", get_psi_buffer_mode_name(), args.prefault_flag?", prefaulted":"");
+	storage_node = get_psi_storage_numa_node(rawfile_name);
+	printf("#PARAM cpus              : %s\n", args.cpus_given?args.cpus_arg:"all");
+	printf("#PARAM buffer numa node  : %i\n", buffer_node);
+	printf("#PARAM storage numa node : %i\n", storage_node);
+	if (buffer_node < 0 || storage_node < 0) {
+		printf("#PARAM numa placement    : unknown\n");
+	} else {
+		printf("#PARAM numa placement    : %s\n", buffer_node == storage_node ? "local" : "remote");
+	}
 	printf("#PARAM metadata tuning   : %s\n", args.metadata_tuning_flag?"yes":"no");
+	printf("#PARAM alignment         : %li Byte\n", args.alignment_arg);
+	printf("#PARAM filters           : %i x psi_passthrough_filter, mode %i\n", args.nfilters_arg, args.filter_mode_arg);
+	printf("#PARAM chunk data        : %s\n", args.data_arg);
+	if (args.bshuf_lz4_flag) {
+		printf("#PARAM compression       : bitshuffle+LZ4 (%s)\n", get_psi_bshuf_impl_name());
+	} else {
+		printf("#PARAM compression       : none\n");
+	}
+	if (checksum == PSI_CHECKSUM_CRC32C) {
+		printf("#PARAM checksum          : crc32c (%s)\n", get_psi_crc32c_impl_name());
+	} else {
+		printf("#PARAM checksum          : %s\n", get_psi_checksum_name(checksum));
+	}
+	printf("#PARAM vfd trace         : %s\n", args.trace_given?args.trace_arg:"no");
+	if (args.frame_meta_arg > 0) {
+		printf("#PARAM frame metadata    : %i frames per append\n", args.frame_meta_arg);
+	} else {
+		printf("#PARAM frame metadata    : no\n");
+	}
+	printf("#PARAM raw allocation    : %s\n", args.raw_fallocate_flag?"fallocate":"on demand");
+	printf("#PARAM raw engines       :");
+	for (int e = 0; e < nraw_engines; e++)
+		printf(" %s", get_psi_raw_engine_name(raw_engines[e]));
+	printf("\n");
+	printf("#PARAM writev chunks     : %i\n", args.writev_chunks_arg);
+	if (args.stage_flag) {
+		printf("#PARAM staging log       : %s\n", stagefile_name);
+		if (args.stage_rate_arg > 0.) {
+			printf("#PARAM conversion rate   : %.1lf MiB/s\n", args.stage_rate_arg);
+		} else {
+			printf("#PARAM conversion rate   : unlimited\n");
+		}
+	}
+	printf("#PARAM h5 allocation     : %s\n", args.h5_alloc_early_flag?"early, fill never":"default");
+	printf("#PARAM phase order       : %s\n", args.order_arg);
+	if (args.quiesce_arg > 0.) {
+		printf("#PARAM quiesce           : %.1lf s, below %i MiB dirty\n", args.quiesce_arg, args.quiesce_dirty_arg);
+	} else {
+		printf("#PARAM quiesce           : no\n");
+	}
+	if (args.free_list_limit_arg >= 0) {
+		printf("#PARAM free list limit   : %i Byte\n", args.free_list_limit_arg);
+	} else {
+		printf("#PARAM free list limit   : none\n");
+	}
 	if (args.traditional_flag) {   
            printf("PARAM h5 write mode: traditional\n");
         } else {
@@ -412,50 +1575,187 @@ int main(int argc, char *argv[])
 		printf("#RESULTS for H5DOwrite_chunk() call\n");
 	}
 
-	printf("#RESULTS h5 elapsed time [s]         : %.3lf\n", wall_h5_elapsed);
-	printf("#RESULTS raw elapsed time [s]        : %.3lf\n", wall_raw_elapsed);
-	printf("#RESULTS h5 cpu+sys time [s]         : %.3lf\n", cpu_h5_elapsed);
-	printf("#RESULTS raw cpu+sys time [s]        : %.3lf\n", cpu_raw_elapsed);
-	printf("#RESULTS overhead [s]                : %.3lf\n",  overhead);
-	printf("#RESULTS overhead per chunk [us]     : %.3lf\n",  overhead_per_chunk*1.e+6);
-	printf("#RESULTS h5  peformance1 [call/s]    : %.3lf\n",  (double)ncalls/wall_h5_elapsed);
-	printf("#RESULTS raw peformance1 [call/s]    : %.3lf\n",  (double)ncalls/wall_raw_elapsed);
-	printf("#RESULTS h5  performance2 [MiB/s]    : %.1lf\n",  (double)nbytes/wall_h5_elapsed/(1024.*1024.));
-	printf("#RESULTS raw performance2 [MiB/s]    : %.1lf\n",  (double)nbytes/wall_raw_elapsed/(1024.*1024.));
-	printf("#RESULTS h5  relative performance [%%]: %.0lf\n", 100.*wall_raw_elapsed/wall_h5_elapsed);
-	printf("#RESULTS h5  filesize [Byte]         : %lli\n", (long long) h5_filestat.st_size);
-	printf("#RESULTS raw filesize [Byte]         : %lli\n", (long long) raw_filestat.st_size);
-	printf("#RESULTS h5 file size overhead [%%]   : %.2lf\n", 100.*(double)(h5_filestat.st_size - raw_filestat.st_size)/(double)raw_filestat.st_size);
+	report_result(results, "h5 elapsed time [s]", 3, wall_h5_elapsed);
+	report_result(results, "raw elapsed time [s]", 3, wall_raw_elapsed);
+	report_result(results, "h5 create time [s]", 3, wall_h5_create);
+	report_result(results, "raw create time [s]", 3, wall_raw_create);
+	report_result(results, "h5 cpu+sys time [s]", 3, cpu_h5_elapsed);
+	report_result(results, "raw cpu+sys time [s]", 3, cpu_raw_elapsed);
+	report_result(results, "overhead [s]", 3, overhead);
+	report_result(results, "overhead per chunk [us]", 3, overhead_per_chunk*1.e+6);
+	report_result(results, "h5  peformance1 [call/s]", 3, (double)ncalls/wall_h5_elapsed);
+	report_result(results, "raw peformance1 [call/s]", 3, (double)ncalls/wall_raw_elapsed);
+	report_result(results, "h5  performance2 [MiB/s]", 1, (double)nbytes/wall_h5_elapsed/(1024.*1024.));
+	report_result(results, "raw performance2 [MiB/s]", 1, (double)nbytes/wall_raw_elapsed/(1024.*1024.));
+	report_result(results, "h5  relative performance [%]", 0, 100.*wall_raw_elapsed/wall_h5_elapsed);
+	printf("#RESULTS raw engine                  : %s\n", get_psi_raw_engine_name(raw_engines[best_raw]));
+	report_result(results, "h5 phase first", 0, h5_first);
+	report_result(results, "h5 dirty before [MiB]", 1, h5_phase.dirty_before/(1024.*1024.));
+	report_result(results, "raw dirty before [MiB]", 1, raw_phase.dirty_before/(1024.*1024.));
+	if (args.quiesce_arg > 0.) {
+		report_result(results, "h5 quiesce wait [s]", 3, h5_phase.quiesce_wait);
+		report_result(results, "raw quiesce wait [s]", 3, raw_phase.quiesce_wait);
+	}
+	for (int e = 0; e < nraw_engines; e++) {
+		char label[MAX_METRIC_NAME];
+		snprintf(label, sizeof(label), "raw %-6s [MiB/s]", get_psi_raw_engine_name(raw_engines[e]));
+		report_result(results, label, 1, (double)nbytes/raw_engine_elapsed[e]/(1024.*1024.));
+	}
+	if (checksum != PSI_CHECKSUM_NONE && !args.traditional_flag) {
+		report_result(results, "checksum time [s]", 3, h5_phase.checksum_elapsed);
+		report_result(results, "checksum speed [MiB/s]", 1, h5_phase.checksum_elapsed > 0. ? (double)nbytes/h5_phase.checksum_elapsed/(1024.*1024.) : 0.);
+	}
+	if (tail_images > 0)
+		report_result(results, "h5 partial chunk [ms]", 3, h5_phase.tail_elapsed*1.e3);
+	report_result(results, "h5 close time [ms]", 3, h5_phase.close_elapsed*1.e3);
+	report_result(results, "h5 end of run latency [ms]", 3, (h5_phase.tail_elapsed + h5_phase.close_elapsed)*1.e3);
+	report_result(results, "h5  filesize [Byte]", 0, (long long) h5_filestat.st_size);
+	report_result(results, "raw filesize [Byte]", 0, (long long) raw_filestat.st_size);
+	report_result(results, "h5 file size overhead [%]", 2, 100.*(double)(h5_filestat.st_size - raw_filestat.st_size)/(double)raw_filestat.st_size);
+	report_result(results, "h5 dataset storage [Byte]", 0, h5_phase.storage_size);
+	report_result(results, "compression ratio", 3, (double)nbytes/(double)h5_phase.storage_size);
+	report_result(results, "h5 chunk index size [Byte]", 0, chunk_index_size);
+	report_result(results, "h5 object header [Byte]", 0, h5_object_header_size);
+	report_result(results, "h5 metadata size [Byte]", 0, (long long) h5_filestat.st_size - h5_phase.storage_size);
+	if (h5_phase.nlatency_groups > 0) {
+		printf("# insertion latency of the write calls by chunks in the index: mean / median / p99 / max\n");
+		for (int g = 0; g < h5_phase.nlatency_groups; g++) {
+			char label[MAX_METRIC_NAME];
+			snprintf(label, sizeof(label), "insert [us] %lli-%lli", h5_phase.latency_groups[g].first, h5_phase.latency_groups[g].last + 1);
+			printf("#RESULTS %-28s: %.1lf / %.1lf / %.1lf / %.1lf\n", label,
+					h5_phase.latency_groups[g].mean*1.e6, h5_phase.latency_groups[g].median*1.e6,
+					h5_phase.latency_groups[g].p99*1.e6, h5_phase.latency_groups[g].max*1.e6);
+			add_result(results, label, 1, h5_phase.latency_groups[g].mean*1.e6);
+			add_result(results, label, 2, h5_phase.latency_groups[g].median*1.e6);
+			add_result(results, label, 3, h5_phase.latency_groups[g].p99*1.e6);
+			add_result(results, label, 4, h5_phase.latency_groups[g].max*1.e6);
+		}
+	}
+	if (args.stage_flag) {   // the converter thread does the inserts, see the stage lag
+		printf("#RESULTS insert latency [us]         : n/a\n");
+	}
+	if (args.bshuf_lz4_flag && !args.traditional_flag) {
+		report_result(results, "compressed chunks [Byte]", 0, h5_phase.compressed_bytes);
+		report_result(results, "compression time [s]", 3, h5_phase.compress_elapsed);
+		report_result(results, "compression speed [MiB/s]", 1, (double)nbytes/h5_phase.compress_elapsed/(1024.*1024.));
+		if (args.adaptive_arg > 0.) {
+			report_result(results, "adaptive ratio threshold", 3, args.adaptive_arg);
+			report_result(results, "chunks stored compressed", 0, ncalls + (tail_images > 0) - h5_phase.raw_chunks);
+			report_result(results, "chunks stored uncompressed", 0, h5_phase.raw_chunks);
+		}
+	}
+	if (args.timeline_bucket_arg > 0) {
+		get_psi_timeline_summary(&raw_timeline, &raw_timeline_summary);
+		get_psi_timeline_summary(&h5_timeline, &h5_timeline_summary);
+		report_result(results, "timeline bucket [s]", 3, args.timeline_bucket_arg*1.e-3);
+		report_result(results, "raw steady rate [MiB/s]", 1, raw_timeline_summary.median_rate/(1024.*1024.));
+		printf("#RESULTS raw min/max bucket [MiB/s]  : %.1lf / %.1lf\n", raw_timeline_summary.min_rate/(1024.*1024.), raw_timeline_summary.max_rate/(1024.*1024.));
+		printf("#RESULTS raw stall buckets           : %i of %i\n", raw_timeline_summary.stall_buckets, raw_timeline_summary.nbuckets);
+		add_result(results, "raw min/max bucket [MiB/s]", 1, raw_timeline_summary.min_rate/(1024.*1024.));
+		add_result(results, "raw min/max bucket [MiB/s]", 2, raw_timeline_summary.max_rate/(1024.*1024.));
+		add_result(results, "raw stall buckets", 1, raw_timeline_summary.stall_buckets);
+		report_result(results, "raw longest stall [s]", 3, raw_timeline_summary.longest_stall);
+		report_result(results, "h5  steady rate [MiB/s]", 1, h5_timeline_summary.median_rate/(1024.*1024.));
+		printf("#RESULTS h5  min/max bucket [MiB/s]  : %.1lf / %.1lf\n", h5_timeline_summary.min_rate/(1024.*1024.), h5_timeline_summary.max_rate/(1024.*1024.));
+		printf("#RESULTS h5  stall buckets           : %i of %i\n", h5_timeline_summary.stall_buckets, h5_timeline_summary.nbuckets);
+		add_result(results, "h5  min/max bucket [MiB/s]", 1, h5_timeline_summary.min_rate/(1024.*1024.));
+		add_result(results, "h5  min/max bucket [MiB/s]", 2, h5_timeline_summary.max_rate/(1024.*1024.));
+		add_result(results, "h5  stall buckets", 1, h5_timeline_summary.stall_buckets);
+		report_result(results, "h5  longest stall [s]", 3, h5_timeline_summary.longest_stall);
+	}
+	if (args.frame_meta_arg > 0) {
+		report_result(results, "frame meta appends", 0, h5_phase.frame_meta.nappends);
+		report_result(results, "frame meta time [s]", 3, h5_phase.frame_meta.append_time);
+		report_result(results, "frame meta per append [us]", 3, h5_phase.frame_meta.append_time/h5_phase.frame_meta.nappends*1.e+6);
+		report_result(results, "frame meta share of h5 [%]", 2, 100.*h5_phase.frame_meta.append_time/wall_h5_elapsed);
+	}
+	if (args.stage_flag) {
+		report_result(results, "stage ingest [MiB/s]", 1, (double)nbytes/h5_phase.stage_stats.ingest_time/(1024.*1024.));
+		report_result(results, "stage conversion [MiB/s]", 1, (double)nbytes/h5_phase.stage_stats.convert_time/(1024.*1024.));
+		report_result(results, "stage ingest time [s]", 3, h5_phase.stage_stats.ingest_time);
+		report_result(results, "stage conversion time [s]", 3, h5_phase.stage_stats.convert_time);
+		report_result(results, "stage mean lag [s]", 3, h5_phase.stage_stats.mean_lag);
+		report_result(results, "stage max lag [s]", 3, h5_phase.stage_stats.max_lag);
+		report_result(results, "stage final lag [s]", 3, h5_phase.stage_stats.final_lag);
+		report_result(results, "stage max backlog [MiB]", 1, h5_phase.stage_stats.max_backlog/(1024.*1024.));
+		report_result(results, "stage throttle time [s]", 3, h5_phase.stage_stats.throttle_time);
+	}
+	report_result(results, "page faults buffer setup", 0, faults_setup);
+	report_result(results, "page faults raw writes", 0, faults_raw);
+	report_result(results, "page faults h5 writes", 0, faults_h5);
+	report_result(results, "huge pages in use [MiB]", 1, huge_bytes/(1024.*1024.));
+	report_result(results, "peak rss [MiB]", 1, h5_phase.mem_summary.peak_rss/(1024.*1024.));
+	report_result(results, "rss before h5 writes [MiB]", 1, h5_phase.rss_before/(1024.*1024.));
+	if (h5_phase.mem_summary.nsamples > 0) {
+		report_result(results, "memory samples", 0, h5_phase.mem_summary.nsamples);
+		report_result(results, "max sampled rss [MiB]", 1, h5_phase.mem_summary.max_rss/(1024.*1024.));
+		report_result(results, "steady state rss [MiB]", 1, h5_phase.mem_summary.steady_rss/(1024.*1024.));
+		report_result(results, "mdc max size [MiB]", 1, h5_phase.mem_summary.mdc_max_size/(1024.*1024.));
+		report_result(results, "mdc peak size [MiB]", 3, h5_phase.mem_summary.max_mdc_size/(1024.*1024.));
+		report_result(results, "mdc steady state size [MiB]", 3, h5_phase.mem_summary.steady_mdc_size/(1024.*1024.));
+		report_result(results, "mdc hit rate [%]", 2, 100.*h5_phase.mem_summary.mdc_hit_rate);
+	}
+	if (args.read_threads_arg > 0) {
+		double pipeline_rate = (double)read_phase.pipeline.bytes/read_phase.pipeline.wall_time/(1024.*1024.);
+		double single_rate = 0.;
+		report_result(results, "read H5Dread() [MiB/s]", 1, pipeline_rate);
+		for (int r = 0; r < read_phase.nruns; r++) {
+			double rate = (double)read_phase.parallel[r].bytes/read_phase.parallel[r].wall_time/(1024.*1024.);
+			if (read_phase.threads[r] == 1) single_rate = rate;
+			char label[MAX_METRIC_NAME];
+			snprintf(label, sizeof(label), "read %3i threads [MiB/s]", read_phase.threads[r]);
+			report_result(results, label, 1, rate);
+			snprintf(label, sizeof(label), "read %3i threads speedup", read_phase.threads[r]);
+			report_result(results, label, 2, rate/pipeline_rate);
+			snprintf(label, sizeof(label), "read %3i threads per thread", read_phase.threads[r]);
+			report_result(results, label, 1, rate/read_phase.threads[r]);
+			if (single_rate > 0.) {
+				snprintf(label, sizeof(label), "read %3i threads efficiency", read_phase.threads[r]);
+				report_result(results, label, 2, rate/(single_rate*read_phase.threads[r]));
+			}
+			snprintf(label, sizeof(label), "read %3i threads io busy [%%]", read_phase.threads[r]);
+			report_result(results, label, 1, 100.*read_phase.parallel[r].io_time/read_phase.parallel[r].wall_time);
+		}
+	}
+	report_result(results, "filter calls", 0, h5_phase.filter_stats.forward_calls);
+	if (h5_phase.filter_stats.forward_calls > 0) {
+		report_result(results, "filter time [s]", 6, h5_phase.filter_stats.forward_time);
+		report_result(results, "filter time per call [us]", 3, h5_phase.filter_stats.forward_time/h5_phase.filter_stats.forward_calls*1.e+6);
+		report_result(results, "filter max per call [us]", 3, h5_phase.filter_stats.max_time*1.e+6);
+		report_result(results, "filter share of h5 time [%]", 2, 100.*h5_phase.filter_stats.forward_time/wall_h5_elapsed);
+	}
+	if (args.trace_given) {
+		report_result(results, "trace writes", 0, h5_phase.trace_summary.nwrites);
+		report_result(results, "trace reads", 0, h5_phase.trace_summary.nreads);
+		report_result(results, "trace truncates", 0, h5_phase.trace_summary.ntruncates);
+		report_result(results, "trace raw data writes", 0, h5_phase.trace_summary.raw_writes);
+		report_result(results, "trace metadata writes", 0, h5_phase.trace_summary.meta_writes);
+		report_result(results, "trace raw data [Byte]", 0, h5_phase.trace_summary.raw_bytes_written);
+		report_result(results, "trace metadata [Byte]", 0, h5_phase.trace_summary.meta_bytes_written);
+		report_result(results, "trace metadata share [%]", 3, 100.*(double)h5_phase.trace_summary.meta_bytes_written/(double)(h5_phase.trace_summary.meta_bytes_written + h5_phase.trace_summary.raw_bytes_written));
+		report_result(results, "trace small nonseq writes", 0, h5_phase.trace_summary.small_nonseq_writes);
+		report_result(results, "trace dropped records", 0, h5_phase.trace_summary.dropped);
+	}
 	printf("#\n");
 
 	// json output
 	if (args.json_given) {
 		printf("# write results to %s in json format\n", args.json_arg);
-		FILE *jsonfile;
-		jsonfile = fopen(args.json_arg, "a");
-		if (jsonfile == NULL) {
-			perror("ERROR: failed to open file for json output");
-			goto fail;
-		}
+		FILE *jsonfile = open_json_record(args.json_arg, args.traditional_flag ? "traditional" : "direct-write");
+		if (jsonfile == NULL) goto fail;
 
-		char jsonformat[] = "{ \n"
-				"  \"mode\":\"%s\", \n"
-				"  \"nodename\":\"%s\", \n"
-				"  \"chunk-size\":%zi, \n"
+		char jsonformat[] = "  \"chunk-size\":%zi, \n"
 				"  \"ncalls\":%lli, \n"
 				"  \"nbytes\":%lli, \n"
-				"  \"array-shape\":[%i,%i,%i], \n"
-				"  \"chunk-shape\":[%i,%i,%i], \n"
+				"  \"array-shape\":[%li,%li,%li], \n"
+				"  \"chunk-shape\":[%li,%li,%li], \n"
 				"  \"h5-elapsed-wall\":%.3lf, \n"
 				"  \"raw-elapsed-wall\":%.3lf, \n"
 				"  \"h5-elapsed-cpu\":%.3lf, \n"
 				"  \"raw-elapsed-cpu\":%.3lf, \n"
 				"  \"h5-filesize\":%lli, \n"
-				"  \"raw-filesize\":%lli \n"
-				"}\n#\n";
+				"  \"raw-filesize\":%lli";
 		fprintf(jsonfile,jsonformat,
-				args.traditional_flag ? "traditional" : "direct-write",
-				uts.nodename,
 				chunk_size,
 				ncalls,
 				nbytes,
@@ -468,19 +1768,1800 @@ int main(int argc, char *argv[])
 				h5_filestat.st_size,
 				raw_filestat.st_size
 				);
+		fprintf(jsonfile, ", \n"
+				"  \"raw-fallocate\":%s, \n"
+				"  \"h5-alloc-early\":%s, \n"
+				"  \"raw-create-elapsed\":%.3lf, \n"
+				"  \"h5-create-elapsed\":%.3lf, \n"
+				"  \"data\":\"%s\", \n"
+				"  \"nbuffers\":%i, \n"
+				"  \"compression\":\"%s\", \n"
+				"  \"h5-storage-size\":%lli, \n"
+				"  \"compress-elapsed\":%.3lf, \n"
+				"  \"adaptive-threshold\":%.3lf, \n"
+				"  \"uncompressed-chunks\":%lli, \n"
+				"  \"checksum\":\"%s\", \n"
+				"  \"checksum-elapsed\":%.3lf, \n"
+				"  \"tail-images\":%li, \n"
+				"  \"tail-policy\":\"%s\", \n"
+				"  \"tail-elapsed\":%.6lf, \n"
+				"  \"close-elapsed\":%.6lf, \n"
+				"  \"write-order\":\"%s\", \n"
+				"  \"write-order-param\":%li, \n"
+				"  \"chunk-index-size\":%lli, \n"
+				"  \"object-header-size\":%lli, \n"
+				"  \"h5-metadata-size\":%lli",
+				args.raw_fallocate_flag ? "true" : "false",
+				args.h5_alloc_early_flag ? "true" : "false",
+				wall_raw_create,
+				wall_h5_create,
+				args.data_arg,
+				nbufs,
+				args.bshuf_lz4_flag ? "bshuf-lz4" : "none",
+				h5_phase.storage_size,
+				h5_phase.compress_elapsed,
+				args.adaptive_arg,
+				h5_phase.raw_chunks,
+				get_psi_checksum_name(checksum),
+				h5_phase.checksum_elapsed,
+				tail_images,
+				args.traditional_flag ? "h5dwrite" : args.tail_arg,
+				h5_phase.tail_elapsed,
+				h5_phase.close_elapsed,
+				get_psi_write_order_name(write_order),
+				write_order_param,
+				chunk_index_size,
+				h5_object_header_size,
+				(long long) h5_filestat.st_size - h5_phase.storage_size);
+		if (h5_phase.nlatency_groups > 0) {
+			fprintf(jsonfile, ", \n  \"insert-latency\":[");
+			for (int g = 0; g < h5_phase.nlatency_groups; g++) {
+				fprintf(jsonfile, "%s{\"first\":%lli, \"last\":%lli, \"mean\":%.7lf, \"median\":%.7lf, \"p99\":%.7lf, \"max\":%.7lf}",
+						g > 0 ? ", " : "",
+						h5_phase.latency_groups[g].first,
+						h5_phase.latency_groups[g].last,
+						h5_phase.latency_groups[g].mean,
+						h5_phase.latency_groups[g].median,
+						h5_phase.latency_groups[g].p99,
+						h5_phase.latency_groups[g].max);
+			}
+			fprintf(jsonfile, "]");
+		}
+		if (args.stage_flag) {
+			fprintf(jsonfile, ", \n  \"insert-latency\":null");
+		}
+		fprintf(jsonfile, ", \n"
+				"  \"alignment\":%li, \n"
+				"  \"raw-engine\":\"%s\", \n"
+				"  \"writev-chunks\":%i, \n"
+				"  \"raw-engines-mibs\":{",
+				args.alignment_arg,
+				get_psi_raw_engine_name(raw_engines[best_raw]),
+				args.writev_chunks_arg);
+		for (int e = 0; e < nraw_engines; e++) {
+			fprintf(jsonfile, "%s\"%s\":%.1lf", e > 0 ? ", " : "", get_psi_raw_engine_name(raw_engines[e]),
+					(double)nbytes/raw_engine_elapsed[e]/(1024.*1024.));
+		}
+		fprintf(jsonfile, "}");
+		fprintf(jsonfile, ", \n"
+				"  \"phase-order\":\"%s\", \n"
+				"  \"h5-first\":%s, \n"
+				"  \"quiesce-timeout\":%.1lf, \n"
+				"  \"h5-quiesce-wait\":%.3lf, \n"
+				"  \"raw-quiesce-wait\":%.3lf, \n"
+				"  \"h5-dirty-before\":%lli, \n"
+				"  \"raw-dirty-before\":%lli",
+				args.order_arg,
+				h5_first ? "true" : "false",
+				args.quiesce_arg,
+				h5_phase.quiesce_wait,
+				raw_phase.quiesce_wait,
+				h5_phase.dirty_before,
+				raw_phase.dirty_before);
+		if (args.stage_flag) {
+			fprintf(jsonfile, ", \n"
+					"  \"stage-rate-limit-mibs\":%.1lf, \n"
+					"  \"stage-ingest-elapsed\":%.3lf, \n"
+					"  \"stage-convert-elapsed\":%.3lf, \n"
+					"  \"stage-mean-lag\":%.3lf, \n"
+					"  \"stage-max-lag\":%.3lf, \n"
+					"  \"stage-final-lag\":%.3lf, \n"
+					"  \"stage-max-backlog\":%lli",
+					args.stage_rate_arg,
+					h5_phase.stage_stats.ingest_time,
+					h5_phase.stage_stats.convert_time,
+					h5_phase.stage_stats.mean_lag,
+					h5_phase.stage_stats.max_lag,
+					h5_phase.stage_stats.final_lag,
+					h5_phase.stage_stats.max_backlog);
+		}
+		fprintf(jsonfile, ", \n"
+				"  \"nfilters\":%i, \n"
+				"  \"filter-mode\":%i, \n"
+				"  \"filter-calls\":%lli, \n"
+				"  \"filter-time\":%.6lf",
+				args.nfilters_arg,
+				args.filter_mode_arg,
+				h5_phase.filter_stats.forward_calls,
+				h5_phase.filter_stats.forward_time);
+		if (args.trace_given) {
+			fprintf(jsonfile, ", \n"
+					"  \"trace-writes\":%lli, \n"
+					"  \"trace-raw-bytes\":%lli, \n"
+					"  \"trace-meta-bytes\":%lli, \n"
+					"  \"trace-small-nonseq-writes\":%lli",
+					h5_phase.trace_summary.nwrites,
+					h5_phase.trace_summary.raw_bytes_written,
+					h5_phase.trace_summary.meta_bytes_written,
+					h5_phase.trace_summary.small_nonseq_writes);
+		}
+		if (args.frame_meta_arg > 0) {
+			fprintf(jsonfile, ", \n"
+					"  \"frame-meta-batch\":%i, \n"
+					"  \"frame-meta-appends\":%lli, \n"
+					"  \"frame-meta-time\":%.6lf",
+					args.frame_meta_arg,
+					h5_phase.frame_meta.nappends,
+					h5_phase.frame_meta.append_time);
+		}
+		fprintf(jsonfile, ", \n"
+				"  \"cpus\":\"%s\", \n"
+				"  \"buffer-numa-node\":%i, \n"
+				"  \"storage-numa-node\":%i, \n"
+				"  \"buffers\":\"%s\", \n"
+				"  \"prefault\":%s, \n"
+				"  \"faults-setup\":%lli, \n"
+				"  \"faults-raw\":%lli, \n"
+				"  \"faults-h5\":%lli, \n"
+				"  \"huge-bytes\":%lli",
+				args.cpus_given ? args.cpus_arg : "all",
+				buffer_node,
+				storage_node,
+				get_psi_buffer_mode_name(),
+				args.prefault_flag ? "true" : "false",
+				faults_setup,
+				faults_raw,
+				faults_h5,
+				huge_bytes);
+		fprintf(jsonfile, ", \n"
+				"  \"free-list-limit\":%i, \n"
+				"  \"peak-rss\":%lli, \n"
+				"  \"rss-before-h5\":%lli",
+				args.free_list_limit_arg,
+				h5_phase.mem_summary.peak_rss,
+				h5_phase.rss_before);
+		if (h5_phase.mem_summary.nsamples > 0) {
+			fprintf(jsonfile, ", \n"
+					"  \"mem-samples\":%i, \n"
+					"  \"steady-rss\":%lli, \n"
+					"  \"mdc-max-size\":%lli, \n"
+					"  \"mdc-peak-size\":%lli, \n"
+					"  \"mdc-steady-size\":%lli, \n"
+					"  \"mdc-hit-rate\":%.4lf",
+					h5_phase.mem_summary.nsamples,
+					h5_phase.mem_summary.steady_rss,
+					h5_phase.mem_summary.mdc_max_size,
+					h5_phase.mem_summary.max_mdc_size,
+					h5_phase.mem_summary.steady_mdc_size,
+					h5_phase.mem_summary.mdc_hit_rate);
+		}
+		if (args.timeline_bucket_arg > 0) {
+			fprintf(jsonfile, ", \n  \"raw-timeline\":");
+			print_psi_timeline_json(jsonfile, &raw_timeline);
+			fprintf(jsonfile, ", \n  \"h5-timeline\":");
+			print_psi_timeline_json(jsonfile, &h5_timeline);
+		}
+		if (args.read_threads_arg > 0) {
+			fprintf(jsonfile, ", \n"
+					"  \"read-pipeline-elapsed\":%.3lf, \n"
+					"  \"read-parallel\":[",
+					read_phase.pipeline.wall_time);
+			for (int r = 0; r < read_phase.nruns; r++) {
+				fprintf(jsonfile, "%s{\"threads\":%i, \"elapsed\":%.3lf, \"io-time\":%.3lf, \"decompress-time\":%.3lf}",
+						r > 0 ? ", " : "",
+						read_phase.threads[r],
+						read_phase.parallel[r].wall_time,
+						read_phase.parallel[r].io_time,
+						read_phase.parallel[r].decompress_time);
+			}
+			fprintf(jsonfile, "]");
+		}
+		fprintf(jsonfile, " \n}\n#\n");
+		fclose(jsonfile);
+	}
+
+
+
+	proc_result.ok = 1;
+	proc_result.raw_start = wall_raw_start.tv_sec + wall_raw_start.tv_usec*1.e-6;
+	proc_result.raw_end = wall_raw_end.tv_sec + wall_raw_end.tv_usec*1.e-6;
+	proc_result.h5_start = wall_h5_start.tv_sec + wall_h5_start.tv_usec*1.e-6;
+	proc_result.h5_end = wall_h5_end.tv_sec + wall_h5_end.tv_usec*1.e-6;
+	proc_result.nbytes = nbytes;
+	proc_result.nchunks = ncalls + (tail_images > 0);
+	ret = 0;
+
+	fail:
+	if (ret != 0) printf("# FAILURE\n");
+	report_psi_proc_result(&proc_result);
+
+	// --repeat runs this again in the same process, also after a failure
+	if (rawfd != -1) close(rawfd);
+	if (fapl >= 0 && fapl != H5P_DEFAULT) H5Pclose(fapl);
+	if (bufs != NULL)
+		for (int b = 0; b < nbufs; b++)
+			free_psi_buffer(bufs[b], buf_size);
+	free(bufs);
+	free_psi_buffer(rbuf, chunk_size);
+	free_psi_buffer(tbuf, buf_size);
+	free_psi_buffer(cbuf, cbuf_size);
+	// raw_timeline is only a copy, the raw phase may have run before a failure
+	if (raw_phase_done) free_psi_timeline(&raw_phase.timeline);
+	free_psi_timeline(&h5_timeline);
+	free(chunk_order);
+	return ret;
+
+}
 
-//		fclose(jsonfile);
 
+// --nprocs: fork one run_benchmark() per process, start their raw and
+// HDF5 writes together and report the aggregate
+// --------------------------------------------------------------------
+int run_nprocs(struct gengetopt_args_info args)
+{
+	int nprocs_list[MAX_SWEEP_RUNS];
+	int nruns = 0;
+	psi_proc_result_t *results = NULL;
+	double *rates = NULL;
+	double best_h5_rate = 0.;
+	int best_nprocs = 0;
+	FILE *jsonfile = NULL;
+	int status = 1;
+
+	if (args.nprocs_sweep_flag) {
+		for (int n = 1; n < args.nprocs_arg; n *= 2)
+			nprocs_list[nruns++] = n;
 	}
+	nprocs_list[nruns++] = args.nprocs_arg;
 
+	results = calloc(args.nprocs_arg, sizeof(psi_proc_result_t));
+	rates = calloc(args.nprocs_arg, sizeof(double));
+	if (results == NULL || rates == NULL) {
+		perror("failed to allocate result space");
+		goto done;
+	}
 
+	if (args.json_given) {
+		jsonfile = open_json_record(args.json_arg, args.traditional_flag ? "traditional-nprocs" : "direct-write-nprocs");
+		if (jsonfile == NULL) goto done;
+		fprintf(jsonfile, "  \"array-shape\":[%li,%li,%li], \n"
+				"  \"chunk-shape\":[%li,%li,%li], \n"
+				"  \"runs\":[",
+				args.nimages_arg,   args.ny_arg, args.nx_arg,
+				args.chunk_size_arg,args.ny_arg, args.nx_arg);
+	}
 
-    exit(0);
+	for (int run = 0; run < nruns; run++) {
+		int n = nprocs_list[run];
+		printf("# start %i processes, output in %s.p<rank>.log\n", n, args.basename_arg);
 
-	fail:
-	printf("# FAILURE\n");
-	exit(1);
+		int rank = start_psi_procs(n);
+		if (rank == -2) {
+			printf("ERROR: failed to start %i processes\n", n);
+			goto done;
+		}
+		if (rank >= 0) {    // child: own files and output, the parent writes the json
+			char *basename = malloc(strlen(args.basename_arg) + 16);
+			char logname[MAX_BASENAME_LENGTH+32];
+			if (basename == NULL) exit(1);
+			sprintf(basename, "%s.p%i", args.basename_arg, rank);
+			snprintf(logname, sizeof(logname), "%s.log", basename);
+			if (freopen(logname, "w", stdout) == NULL) exit(1);
+			args.basename_arg = basename;
+			args.json_given = 0;
+			exit(run_benchmark(args, NULL));
+		}
+
+		int nok = collect_psi_proc_results(results);
+		printf("#\n");
+		printf("#RESULTS for %i processes\n", n);
+		printf("#RESULTS processes ok                : %i of %i\n", nok, n);
+		if (nok != n) {
+			printf("ERROR: %i processes failed, see their log files\n", n - nok);
+			goto done;
+		}
 
+		// aggregate rate over the span from the first start to the last end
+		double raw_first = 0., raw_last = 0., h5_first = 0., h5_last = 0.;
+		long long total = 0;
+		for (int i = 0; i < n; i++) {
+			if (i == 0 || results[i].raw_start < raw_first) raw_first = results[i].raw_start;
+			if (i == 0 || results[i].h5_start < h5_first) h5_first = results[i].h5_start;
+			if (results[i].raw_end > raw_last) raw_last = results[i].raw_end;
+			if (results[i].h5_end > h5_last) h5_last = results[i].h5_end;
+			total += results[i].nbytes;
+		}
+		double raw_rate = total/(raw_last - raw_first)/(1024.*1024.);
+		double h5_rate = total/(h5_last - h5_first)/(1024.*1024.);
+		double h5_min = 0., h5_max = 0.;
+
+		for (int i = 0; i < n; i++) {
+			rates[i] = results[i].nbytes/(results[i].raw_end - results[i].raw_start)/(1024.*1024.);
+		}
+		double raw_fairness = psi_fairness(rates, n);
+		for (int i = 0; i < n; i++) {
+			rates[i] = results[i].nbytes/(results[i].h5_end - results[i].h5_start)/(1024.*1024.);
+			if (i == 0 || rates[i] < h5_min) h5_min = rates[i];
+			if (rates[i] > h5_max) h5_max = rates[i];
+		}
+		double h5_fairness = psi_fairness(rates, n);
+
+		printf("#RESULTS aggregate raw [MiB/s]       : %.1lf\n", raw_rate);
+		printf("#RESULTS aggregate h5  [MiB/s]       : %.1lf\n", h5_rate);
+		printf("#RESULTS h5 per process min [MiB/s]  : %.1lf\n", h5_min);
+		printf("#RESULTS h5 per process max [MiB/s]  : %.1lf\n", h5_max);
+		printf("#RESULTS raw fairness (Jain)         : %.3lf\n", raw_fairness);
+		printf("#RESULTS h5 fairness (Jain)          : %.3lf\n", h5_fairness);
+		printf("#\n");
+		if (h5_rate > best_h5_rate) {
+			best_h5_rate = h5_rate;
+			best_nprocs = n;
+		}
+
+		if (jsonfile != NULL) {
+			fprintf(jsonfile, "%s\n    {\"nprocs\":%i, \"raw-aggregate-mibs\":%.1lf, \"h5-aggregate-mibs\":%.1lf, "
+					"\"raw-fairness\":%.3lf, \"h5-fairness\":%.3lf, \"h5-mibs\":[",
+					run > 0 ? "," : "", n, raw_rate, h5_rate, raw_fairness, h5_fairness);
+			for (int i = 0; i < n; i++)
+				fprintf(jsonfile, "%s%.1lf", i > 0 ? "," : "", rates[i]);
+			fprintf(jsonfile, "]}");
+		}
+	}
+
+	if (nruns > 1) {
+		printf("#RESULTS best aggregate h5 [MiB/s]   : %.1lf\n", best_h5_rate);
+		printf("#RESULTS best nprocs                 : %i\n", best_nprocs);
+	}
+	if (jsonfile != NULL) fprintf(jsonfile, "], \n  \"best-nprocs\":%i \n}\n#\n", best_nprocs);
+	status = 0;
+
+done:
+	if (jsonfile != NULL) fclose(jsonfile);
+	free(results);
+	free(rates);
+	return status;
+}
+
+
+// create a file with ndsets datasets in the shape of the benchmark dataset,
+// without filters
+hid_t create_writer_file(const char *name, const struct gengetopt_args_info *args, int ndsets, hid_t *dsets)
+{
+	hsize_t dims[NDIM] = { args->nimages_arg, args->ny_arg, args->nx_arg };
+	hsize_t chunk[NDIM] = { args->chunk_size_arg, args->ny_arg, args->nx_arg };
+	hid_t file = -1, space = -1, dcpl = -1;
+	char dset_name[32];
+	int i = 0;
+
+	for (i = 0; i < ndsets; i++)
+		dsets[i] = -1;
+	file = H5Fcreate(name, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+	space = H5Screate_simple(NDIM, dims, NULL);
+	dcpl = H5Pcreate(H5P_DATASET_CREATE);
+	if (file < 0 || space < 0 || dcpl < 0) goto fail;
+	if (H5Pset_chunk(dcpl, NDIM, chunk) < 0) goto fail;
+	for (i = 0; i < ndsets; i++) {
+		snprintf(dset_name, sizeof(dset_name), "data%i", i);
+		dsets[i] = H5Dcreate(file, dset_name, H5T_STD_U8LE, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+		if (dsets[i] < 0) goto fail;
+	}
+	H5Pclose(dcpl);
+	H5Sclose(space);
+	return file;
+
+fail:
+	printf("ERROR: failed to create HDF5 file %s\n", name);
+	for (i = 0; i < ndsets; i++)
+		if (dsets[i] >= 0) H5Dclose(dsets[i]);
+	if (dcpl >= 0) H5Pclose(dcpl);
+	if (space >= 0) H5Sclose(space);
+	if (file >= 0) H5Fclose(file);
+	return -1;
+}
+
+// throughput and time inside H5DOwrite_chunk() of a set of writers
+typedef struct writer_summary_t {
+	double rate;          // MiB/s from the first start to the last end
+	double api_time;      // summed over all writers
+	double api_cpu;
+	double wait_pct;      // share of api_time without cpu
+	double wait_per_call; // microseconds
+} writer_summary_t;
+
+void summarize_writers(const psi_writer_stats_t *stats, int n, writer_summary_t *summary)
+{
+	double first = stats[0].start, last = stats[0].end;
+	long long bytes = 0, calls = 0;
+
+	memset(summary, 0, sizeof(*summary));
+	for (int i = 0; i < n; i++) {
+		if (stats[i].start < first) first = stats[i].start;
+		if (stats[i].end > last) last = stats[i].end;
+		bytes += stats[i].bytes;
+		calls += stats[i].chunks;
+		summary->api_time += stats[i].call_time;
+		summary->api_cpu += stats[i].call_cpu;
+	}
+	double wait = summary->api_time - summary->api_cpu;
+	if (wait < 0.) wait = 0.;
+	summary->rate = last > first ? bytes/(last - first)/(1024.*1024.) : 0.;
+	summary->wait_pct = summary->api_time > 0. ? 100.*wait/summary->api_time : 0.;
+	summary->wait_per_call = calls > 0 ? 1.e6*wait/calls : 0.;
+}
+
+void print_writer_summary(const char *title, int n, const writer_summary_t *summary)
+{
+	printf("#\n");
+	printf("#RESULTS for %i writer %s\n", n, title);
+	printf("#RESULTS aggregate h5  [MiB/s]       : %.1lf\n", summary->rate);
+	printf("#RESULTS time in H5DOwrite_chunk [s] : %.3lf\n", summary->api_time);
+	printf("#RESULTS cpu in H5DOwrite_chunk [s]  : %.3lf\n", summary->api_cpu);
+	printf("#RESULTS wait in H5DOwrite_chunk [%%] : %.1lf\n", summary->wait_pct);
+	printf("#RESULTS wait per call [us]          : %.1lf\n", summary->wait_per_call);
+}
+
+// writer threads in one process against writer processes with a file each.
+// The threads share the global lock of a thread-safe HDF5, the processes
+// share nothing but the storage.
+int run_write_threads(struct gengetopt_args_info args)
+{
+	int nthreads_list[MAX_SWEEP_RUNS];
+	int nruns = 0;
+	int nmax = args.write_threads_arg;
+	size_t chunk_bytes = (size_t) args.chunk_size_arg * args.ny_arg * args.nx_arg;
+	char *buf = NULL;
+	char *file_name = NULL;
+	hid_t dsets[PSI_WRITE_MAX_THREADS];
+	psi_writer_stats_t stats[PSI_WRITE_MAX_THREADS];
+	psi_proc_result_t results[PSI_WRITE_MAX_THREADS];
+	writer_summary_t thread_summary, proc_summary;
+	FILE *jsonfile = NULL;
+	int status = 1;
+
+	if (nmax < 1 || nmax > PSI_WRITE_MAX_THREADS) {
+		printf("ERROR: write-threads must be between 1 and %i\n", PSI_WRITE_MAX_THREADS);
+		return 1;
+	}
+#ifndef H5_HAVE_THREADSAFE
+	if (nmax > 1) {
+		printf("ERROR: more than one writer thread needs a thread-safe HDF5, see 'make threadsafe'\n");
+		return 1;
+	}
+#endif
+	if (chunk_bytes == 0 || chunk_bytes > MAX_CHUNK_BYTES) {
+		printf("ERROR: chunk size must be between 1 byte and 4 GiB\n");
+		return 1;
+	}
+
+	if (args.write_threads_sweep_flag) {
+		for (int n = 1; n < nmax; n *= 2)
+			nthreads_list[nruns++] = n;
+	}
+	nthreads_list[nruns++] = nmax;
+
+	buf = malloc(chunk_bytes);
+	file_name = malloc(strlen(args.basename_arg) + 32);
+	if (buf == NULL || file_name == NULL) {
+		perror("failed to allocate chunk buffer");
+		goto done;
+	}
+	if (fill_chunk_buffer(buf, chunk_bytes, args.data_arg, 0) != 0) {
+		printf("ERROR: data %s is not supported with write-threads\n", args.data_arg);
+		goto done;
+	}
+
+	if (args.json_given) {
+		jsonfile = open_json_record(args.json_arg, "direct-write-threads");
+		if (jsonfile == NULL) goto done;
+		fprintf(jsonfile, "  \"array-shape\":[%li,%li,%li], \n"
+				"  \"chunk-shape\":[%li,%li,%li], \n"
+				"  \"runs\":[",
+				args.nimages_arg,   args.ny_arg, args.nx_arg,
+				args.chunk_size_arg,args.ny_arg, args.nx_arg);
+	}
+
+	for (int run = 0; run < nruns; run++) {
+		int n = nthreads_list[run];
+		hid_t file;
+
+		// threads, a dataset each in one file
+		sprintf(file_name, "%s.threads.h5", args.basename_arg);
+		file = create_writer_file(file_name, &args, n, dsets);
+		if (file < 0) goto done;
+		if (psi_threaded_write(dsets, n, buf, chunk_bytes, stats) < 0) {
+			printf("ERROR: threaded write to %s failed\n", file_name);
+			goto done;
+		}
+		for (int t = 0; t < n; t++)
+			H5Dclose(dsets[t]);
+		if (H5Fclose(file) < 0) {
+			printf("ERROR: failed to close HDF5 file %s\n", file_name);
+			goto done;
+		}
+		summarize_writers(stats, n, &thread_summary);
+		print_writer_summary("threads, one file", n, &thread_summary);
+
+		// processes, a file each
+		int rank = start_psi_procs(n);
+		if (rank == -2) {
+			printf("ERROR: failed to start %i processes\n", n);
+			goto done;
+		}
+		if (rank >= 0) {
+			psi_proc_result_t result;
+			psi_writer_stats_t s;
+			memset(&result, 0, sizeof(result));
+			sprintf(file_name, "%s.shard%i.h5", args.basename_arg, rank);
+			file = create_writer_file(file_name, &args, 1, dsets);
+			psi_proc_barrier();
+			if (file >= 0 && psi_write_chunks(dsets[0], buf, chunk_bytes, &s) >= 0) {
+				H5Dclose(dsets[0]);
+				result.ok = H5Fclose(file) >= 0;
+				result.h5_start = s.start;
+				result.h5_end = s.end;
+				result.nbytes = s.bytes;
+				result.nchunks = s.chunks;
+				result.api_time = s.call_time;
+				result.api_cpu = s.call_cpu;
+			}
+			report_psi_proc_result(&result);
+			exit(result.ok ? 0 : 1);
+		}
+		int nok = collect_psi_proc_results(results);
+		if (nok != n) {
+			printf("ERROR: %i writer processes failed\n", n - nok);
+			goto done;
+		}
+		for (int i = 0; i < n; i++) {
+			memset(&stats[i], 0, sizeof(stats[i]));
+			stats[i].start = results[i].h5_start;
+			stats[i].end = results[i].h5_end;
+			stats[i].bytes = results[i].nbytes;
+			stats[i].chunks = results[i].nchunks;
+			stats[i].call_time = results[i].api_time;
+			stats[i].call_cpu = results[i].api_cpu;
+		}
+		summarize_writers(stats, n, &proc_summary);
+		print_writer_summary("processes, a file each", n, &proc_summary);
+		printf("#RESULTS threads / processes         : %.2lf\n",
+				proc_summary.rate > 0. ? thread_summary.rate/proc_summary.rate : 0.);
+		// not measured: the processes see the same I/O and scheduling, but no
+		// common lock, so the extra wait of the threads is put down to the lock
+		double lock_wait = thread_summary.wait_per_call - proc_summary.wait_per_call;
+		printf("#RESULTS lock wait estimate/call [us]: %.1lf\n", lock_wait > 0. ? lock_wait : 0.);
+		printf("#\n");
+
+		if (jsonfile != NULL) {
+			fprintf(jsonfile, "%s\n    {\"nwriters\":%i, "
+					"\"threads\":{\"h5-aggregate-mibs\":%.1lf, \"api-time\":%.3lf, \"api-cpu\":%.3lf, \"api-wait-pct\":%.1lf}, "
+					"\"processes\":{\"h5-aggregate-mibs\":%.1lf, \"api-time\":%.3lf, \"api-cpu\":%.3lf, \"api-wait-pct\":%.1lf}, \"lock-wait-estimate-us\":%.1lf}",
+					run > 0 ? "," : "", n,
+					thread_summary.rate, thread_summary.api_time, thread_summary.api_cpu, thread_summary.wait_pct,
+					proc_summary.rate, proc_summary.api_time, proc_summary.api_cpu, proc_summary.wait_pct,
+					lock_wait > 0. ? lock_wait : 0.);
+		}
+	}
+
+	if (jsonfile != NULL) fprintf(jsonfile, "] \n}\n#\n");
+	status = 0;
+
+done:
+	if (jsonfile != NULL) fclose(jsonfile);
+	free(file_name);
+	free(buf);
+	return status;
+}
+
+
+// one tuner trial: append chunks to a fresh file until the time is up, the
+// first part of the time is a warm-up and doesn't count. The dataset starts
+// with room for -z images and is extended when the trial needs more.
+typedef struct tune_arg_t {
+	const struct gengetopt_args_info *args;
+	const char *file_name;
+	int verbose;
+} tune_arg_t;
+
+double run_tune_trial(const psi_tune_config_t *config, double seconds, void *arg)
+{
+	const tune_arg_t *tune = arg;
+	const struct gengetopt_args_info *args = tune->args;
+	size_t chunk_bytes = (size_t) config->chunk_images * args->ny_arg * args->nx_arg;
+	long long nchunks = (args->nimages_arg + config->chunk_images - 1) / config->chunk_images;
+	hsize_t dims[NDIM] = { nchunks * config->chunk_images, args->ny_arg, args->nx_arg };
+	hsize_t maxdims[NDIM] = { H5S_UNLIMITED, args->ny_arg, args->nx_arg };
+	hsize_t chunk[NDIM] = { config->chunk_images, args->ny_arg, args->nx_arg };
+	hsize_t offset[NDIM] = { 0, 0, 0 };
+	hid_t fapl = -1, file = -1, space = -1, dcpl = -1, dset = -1;
+	char *buf = NULL, *cbuf = NULL;
+	size_t cbuf_size = 0;
+	struct timeval trial_start, start, t, measure_start = {0,0};
+	long long measured = 0;
+	double rate = -1.;
+
+	gettimeofday(&trial_start, NULL);   // the setup counts against the time of the trial
+	buf = malloc(chunk_bytes);
+	if (buf == NULL) goto done;
+	if (fill_chunk_buffer(buf, chunk_bytes, strcmp(args->data_arg, "mixed") == 0 ? "detector" : args->data_arg, 1) < 0)
+		goto done;
+	if (args->bshuf_lz4_flag) {
+		cbuf_size = psi_bshuf_lz4_bound(chunk_bytes, 1, 0);
+		cbuf = malloc(cbuf_size);
+		if (cbuf == NULL) goto done;
+	}
+
+	fapl = create_file_access(config->metadata_tuning, config->alignment, chunk_bytes);
+	if (fapl < 0) goto done;
+	file = H5Fcreate(tune->file_name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+	space = H5Screate_simple(NDIM, dims, maxdims);
+	dcpl = H5Pcreate(H5P_DATASET_CREATE);
+	if (file < 0 || space < 0 || dcpl < 0) goto done;
+	if (H5Pset_chunk(dcpl, NDIM, chunk) < 0) goto done;
+	if (args->bshuf_lz4_flag && H5Pset_filter(dcpl, PSI_BSHUF_LZ4_FILTER, H5Z_FLAG_MANDATORY, 0, NULL) < 0)
+		goto done;
+	dset = H5Dcreate(file, "data", H5T_STD_U8LE, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+	if (dset < 0) goto done;
+
+	gettimeofday(&start, NULL);
+	t = start;
+	for (long long i = 0; ; i++) {
+		const char *data = buf;
+		size_t size = chunk_bytes;
+
+		if (i == nchunks) {   // a short dataset, double it
+			nchunks *= 2;
+			dims[0] = nchunks * config->chunk_images;
+			if (H5Dset_extent(dset, dims) < 0) goto done;
+		}
+		if (args->bshuf_lz4_flag) {
+			size = psi_bshuf_lz4_compress(buf, chunk_bytes, 1, 0, cbuf, cbuf_size);
+			if (size == 0) goto done;
+			data = cbuf;
+		}
+		offset[0] = i * config->chunk_images;
+		if (H5DOwrite_chunk(dset, H5P_DEFAULT, 0, offset, size, (void *) data) < 0) goto done;
+
+		gettimeofday(&t, NULL);
+		double elapsed = timediff(&start, &t);
+		if (measure_start.tv_sec == 0 && measure_start.tv_usec == 0) {
+			if (elapsed >= 0.2*seconds) measure_start = t;   // end of the warm-up
+		} else {
+			measured += chunk_bytes;
+		}
+		if (timediff(&trial_start, &t) >= seconds && measured > 0) break;
+	}
+	rate = measured/timediff(&measure_start, &t)/(1024.*1024.);
+
+done:
+	if (dset >= 0) H5Dclose(dset);
+	if (dcpl >= 0) H5Pclose(dcpl);
+	if (space >= 0) H5Sclose(space);
+	if (file >= 0 && H5Fclose(file) < 0) rate = -1.;
+	if (fapl >= 0 && fapl != H5P_DEFAULT) H5Pclose(fapl);
+	unlink(tune->file_name);
+	free(cbuf);
+	free(buf);
+	if (tune->verbose) {
+		printf("# trial chunk-size %6li alignment %8lli metadata tuning %-3s: %.1lf MiB/s\n",
+				config->chunk_images, config->alignment, config->metadata_tuning ? "yes" : "no", rate);
+	}
+	return rate;
+}
+
+// search chunk size, alignment and metadata tuning for the best sustained
+// H5DOwrite_chunk() rate within --tune seconds
+int run_tune(struct gengetopt_args_info args)
+{
+	static const char *phase_names[] = { "coarse", "fine", "settings" };
+	const long long alignments[] = { 0, 4096, 1024*1024 };
+	// powers of two and the steps half way between them, up to 2^62
+	long candidates[2*64];
+	int ncandidates = 0;
+	char *file_name = NULL;
+	tune_arg_t tune;
+	psi_tune_result_t result;
+	FILE *jsonfile = NULL;
+	int status = 1;
+
+	if (args.nx_arg <= 0 || args.ny_arg <= 0 || args.nimages_arg <= 0) {
+		printf("ERROR: nx, ny and nimages both must be positive and none-zero\n");
+		goto done;
+	}
+	if (register_psi_bshuf_lz4_filter() < 0) {
+		printf("ERROR: failed to register PSI bitshuffle+LZ4 filter in HDF5 lib\n");
+		goto done;
+	}
+
+	// chunk sizes up to the number of images with a chunk buffer that HDF5
+	// and the memory can take, the benchmark pads a partial last chunk. The
+	// coarse pass of the tuner takes the powers of two, the fine pass the
+	// steps of 1.5 between the neighbours of the best one.
+	long long frame = (long long) args.nx_arg * args.ny_arg;
+	long long max_bytes = MAX_CHUNK_BYTES;
+	if (physical_memory() > 0 && physical_memory()/4 < max_bytes) max_bytes = physical_memory()/4;
+	long max_images = max_bytes / frame < args.nimages_arg ? max_bytes / frame : args.nimages_arg;
+	for (long c = 1; c <= max_images; c *= 2) {
+		candidates[ncandidates++] = c;
+		if (c > 1 && c + c/2 < max_images) candidates[ncandidates++] = c + c/2;
+		if (c > max_images/2) break;
+	}
+	if (ncandidates > 0 && candidates[ncandidates-1] < max_images)
+		candidates[ncandidates++] = max_images;
+	if (ncandidates == 0) {
+		printf("ERROR: a single image of %lli bytes is too large for a chunk\n", frame);
+		goto done;
+	}
+
+	file_name = malloc(strlen(args.basename_arg) + 16);
+	if (file_name == NULL) goto done;
+	sprintf(file_name, "%s.tune.h5", args.basename_arg);
+	tune.args = &args;
+	tune.file_name = file_name;
+	tune.verbose = 1;
+
+	printf("# tune chunk size from %li to %li images within %.1lf s\n", candidates[0], candidates[ncandidates-1], args.tune_arg);
+	if (psi_tune(candidates, ncandidates, alignments, sizeof(alignments)/sizeof(alignments[0]),
+			args.tune_arg, run_tune_trial, &tune, &result) < 0) {
+		printf("ERROR: no tuner trial succeeded\n");
+		goto done;
+	}
+	unlink(file_name);
+
+	printf("#\n");
+	printf("#RESULTS tuner trials                : %i\n", result.ntrials);
+	printf("#RESULTS tuner time [s]              : %.1lf\n", result.time);
+	printf("#RESULTS tuner budget exceeded       : %s\n", result.budget_exceeded ? "yes" : "no");
+	printf("#RESULTS tuned chunk-size            : %li\n", result.best.chunk_images);
+	printf("#RESULTS tuned chunk [MiB]           : %.3lf\n", result.best.chunk_images*frame/(1024.*1024.));
+	printf("#RESULTS tuned alignment [Byte]      : %lli\n", result.best.alignment);
+	printf("#RESULTS tuned metadata tuning       : %s\n", result.best.metadata_tuning ? "yes" : "no");
+	printf("#RESULTS tuned h5 rate [MiB/s]       : %.1lf\n", result.best_rate);
+	printf("#\n");
+	printf("# recommended:\n");
+	printf("h5direct_write_benchmark -x %li -y %li -z %li -c %li%s --alignment %lli%s --data %s\n",
+			args.nx_arg, args.ny_arg, args.nimages_arg, result.best.chunk_images,
+			result.best.metadata_tuning ? " -m" : "", result.best.alignment,
+			args.bshuf_lz4_flag ? " --bshuf-lz4" : "", args.data_arg);
+
+	if (args.json_given) {
+		jsonfile = open_json_record(args.json_arg, "tune");
+		if (jsonfile == NULL) goto done;
+		fprintf(jsonfile, "  \"array-shape\":[%li,%li,%li], \n"
+				"  \"compression\":\"%s\", \n"
+				"  \"data\":\"%s\", \n"
+				"  \"budget\":%.1lf, \n"
+				"  \"elapsed\":%.1lf, \n"
+				"  \"trials\":[",
+				args.nimages_arg, args.ny_arg, args.nx_arg,
+				args.bshuf_lz4_flag ? "bshuf-lz4" : "none",
+				args.data_arg,
+				args.tune_arg,
+				result.time);
+		for (int i = 0; i < result.ntrials; i++) {
+			const psi_tune_trial_t *trial = &result.trials[i];
+			fprintf(jsonfile, "%s\n    {\"phase\":\"%s\", \"chunk-size\":%li, \"alignment\":%lli, "
+					"\"metadata-tuning\":%s, \"h5-mibs\":%.1lf, \"elapsed\":%.3lf}",
+					i > 0 ? "," : "", phase_names[trial->phase], trial->config.chunk_images,
+					trial->config.alignment, trial->config.metadata_tuning ? "true" : "false",
+					trial->rate, trial->time);
+		}
+		fprintf(jsonfile, "], \n"
+				"  \"recommended\":{\"chunk-size\":%li, \"alignment\":%lli, \"metadata-tuning\":%s, \"h5-mibs\":%.1lf, \n"
+				"    \"command-line\":\"h5direct_write_benchmark -x %li -y %li -z %li -c %li%s --alignment %lli%s --data %s\"} \n"
+				"}\n#\n",
+				result.best.chunk_images, result.best.alignment, result.best.metadata_tuning ? "true" : "false",
+				result.best_rate,
+				args.nx_arg, args.ny_arg, args.nimages_arg, result.best.chunk_images,
+				result.best.metadata_tuning ? " -m" : "", result.best.alignment,
+				args.bshuf_lz4_flag ? " --bshuf-lz4" : "", args.data_arg);
+		fclose(jsonfile);
+	}
+	status = 0;
+
+done:
+	free(file_name);
+	return status;
+}
+
+const metric_t *find_metric(const metric_t *metrics, int nmetrics, const char *name)
+{
+	for (int m = 0; m < nmetrics; m++)
+		if (strcmp(metrics[m].name, name) == 0) return &metrics[m];
+	return NULL;
+}
+
+// --order alternate or random: mean of a metric over the runs with the
+// given phase first, -1 without such runs
+double order_mean(const metric_t *metric, const metric_t *h5_first, int first)
+{
+	double sum = 0.;
+	int n = 0;
+
+	for (int i = 0; i < metric->n && i < h5_first->n; i++) {
+		if ((h5_first->samples[i] != 0.) != first) continue;
+		sum += metric->samples[i];
+		n++;
+	}
+	return n > 0 ? sum/n : -1.;
+}
+
+// run the benchmark warmup + repeat times in this process and report the
+// statistics of every #RESULTS number of the repeated runs
+int run_repeat(struct gengetopt_args_info args)
+{
+	int nruns = args.warmup_arg + args.repeat_arg;
+	results_t results;
+	metric_t *metrics = NULL;
+	int nmetrics = 0;
+	int *outlier = NULL;
+	FILE *jsonfile = NULL;
+	FILE *capture = NULL;
+	int saved_stdout = -1;
+	int status = 1;
+
+	memset(&results, 0, sizeof(results));
+	results.nmax_samples = args.repeat_arg;
+	results.metrics = calloc(MAX_METRICS, sizeof(metric_t));
+	outlier = calloc(args.repeat_arg, sizeof(int));
+	if (results.metrics == NULL || outlier == NULL) {
+		perror("failed to allocate result space");
+		goto done;
+	}
+	int json_given = args.json_given;
+	args.json_given = 0;    // one json object for all runs below
+
+	for (int run = 0; run < nruns; run++) {
+		int warmup = run < args.warmup_arg;
+		char line[512];
+
+		// the output of the run goes to a temporary file, it is only shown
+		// if the run fails, the numbers come with results
+		fflush(stdout);
+		capture = tmpfile();
+		saved_stdout = dup(STDOUT_FILENO);
+		if (capture == NULL || saved_stdout == -1 || dup2(fileno(capture), STDOUT_FILENO) == -1) {
+			perror("ERROR: failed to capture the output of the run");
+			goto done;
+		}
+		int ret = run_benchmark(args, warmup ? NULL : &results);
+		fflush(stdout);
+		dup2(saved_stdout, STDOUT_FILENO);
+		close(saved_stdout);
+		saved_stdout = -1;
+		rewind(capture);
+
+		if (ret != 0) {   // show what went wrong
+			while (fgets(line, sizeof(line), capture) != NULL)
+				fputs(line, stdout);
+			printf("ERROR: run %i failed\n", run + 1);
+			goto done;
+		}
+		if (results.failed) {
+			printf("ERROR: more than %i results per run or a result name of %i characters or more\n",
+					MAX_METRICS, MAX_METRIC_NAME);
+			goto done;
+		}
+		if (run == args.warmup_arg) {   // the parameters of the first counted run
+			while (fgets(line, sizeof(line), capture) != NULL)
+				if (strncmp(line, "#PARAM", 6) == 0) fputs(line, stdout);
+		}
+		fclose(capture);
+		capture = NULL;
+
+		if (warmup) {
+			printf("# warm-up run %i of %i done\n", run + 1, args.warmup_arg);
+		} else {
+			printf("# run %i of %i done\n", run - args.warmup_arg + 1, args.repeat_arg);
+		}
+	}
+
+	metrics = results.metrics;
+	nmetrics = results.nmetrics;
+	printf("#\n");
+	printf("#RESULTS repeated runs               : %i\n", args.repeat_arg);
+	printf("#RESULTS warm-up runs                : %i\n", args.warmup_arg);
+	printf("# metric: mean +- 95%% confidence interval (median, standard deviation, outlier runs)\n");
+	for (int m = 0; m < nmetrics; m++) {
+		psi_stats_t stats;
+		get_psi_stats(metrics[m].samples, metrics[m].n, &stats, outlier);
+		printf("#RESULTS %-28s: %.3lf +- %.3lf (median %.3lf, sd %.3lf, outliers",
+				metrics[m].name, stats.mean, stats.ci95, stats.median, stats.sd);
+		if (stats.noutliers == 0) printf(" none");
+		for (int i = 0; i < metrics[m].n; i++)
+			if (outlier[i]) printf(" %i", i + 1);
+		printf(")\n");
+	}
+
+	// with mixed phase orders show whether the order matters
+	const char *order_metrics[] = { "h5  performance2 [MiB/s]", "raw performance2 [MiB/s]", "h5  relative performance [%]" };
+	const int norder_metrics = sizeof(order_metrics)/sizeof(order_metrics[0]);
+	const metric_t *h5_first = find_metric(metrics, nmetrics, "h5 phase first");
+	int by_order = h5_first != NULL && strcmp(args.order_arg, "raw-first") != 0 && strcmp(args.order_arg, "h5-first") != 0;
+	if (by_order) {
+		printf("# by phase order: mean with the raw phase first / with the HDF5 phase first\n");
+		for (int o = 0; o < norder_metrics; o++) {
+			const metric_t *metric = find_metric(metrics, nmetrics, order_metrics[o]);
+			if (metric == NULL) continue;
+			printf("#RESULTS %-28s: %.3lf / %.3lf\n", order_metrics[o],
+					order_mean(metric, h5_first, 0), order_mean(metric, h5_first, 1));
+		}
+	}
+
+	if (json_given) {
+		jsonfile = open_json_record(args.json_arg, args.traditional_flag ? "traditional-repeat" : "direct-write-repeat");
+		if (jsonfile == NULL) goto done;
+		fprintf(jsonfile, "  \"array-shape\":[%li,%li,%li], \n"
+				"  \"chunk-shape\":[%li,%li,%li], \n"
+				"  \"repeat\":%i, \n"
+				"  \"warmup\":%i, \n"
+				"  \"metrics\":{",
+				args.nimages_arg,   args.ny_arg, args.nx_arg,
+				args.chunk_size_arg,args.ny_arg, args.nx_arg,
+				args.repeat_arg,
+				args.warmup_arg);
+		for (int m = 0; m < nmetrics; m++) {
+			psi_stats_t stats;
+			get_psi_stats(metrics[m].samples, metrics[m].n, &stats, outlier);
+			fprintf(jsonfile, "%s\n    \"%s\":{\"mean\":%.6g, \"median\":%.6g, \"sd\":%.6g, \"ci95\":%.6g, \"outliers\":[",
+					m > 0 ? "," : "", metrics[m].name, stats.mean, stats.median, stats.sd, stats.ci95);
+			for (int i = 0, first = 1; i < metrics[m].n; i++) {
+				if (!outlier[i]) continue;
+				fprintf(jsonfile, "%s%i", first ? "" : ",", i + 1);
+				first = 0;
+			}
+			fprintf(jsonfile, "], \"samples\":[");
+			for (int i = 0; i < metrics[m].n; i++)
+				fprintf(jsonfile, "%s%.6g", i > 0 ? "," : "", metrics[m].samples[i]);
+			fprintf(jsonfile, "]}");
+		}
+		fprintf(jsonfile, "\n  }");
+		if (by_order) {
+			fprintf(jsonfile, ", \n  \"by-phase-order\":{");
+			for (int o = 0, first = 1; o < norder_metrics; o++) {
+				const metric_t *metric = find_metric(metrics, nmetrics, order_metrics[o]);
+				if (metric == NULL) continue;
+				fprintf(jsonfile, "%s\n    \"%s\":{\"raw-first\":%.6g, \"h5-first\":%.6g}", first ? "" : ",",
+						order_metrics[o], order_mean(metric, h5_first, 0), order_mean(metric, h5_first, 1));
+				first = 0;
+			}
+			fprintf(jsonfile, "\n  }");
+		}
+		fprintf(jsonfile, " \n}\n#\n");
+		fclose(jsonfile);
+	}
+	status = 0;
+
+done:
+	if (saved_stdout != -1) {   // failed with stdout still going to the capture
+		fflush(stdout);
+		dup2(saved_stdout, STDOUT_FILENO);
+		close(saved_stdout);
+	}
+	if (capture != NULL) fclose(capture);
+	if (results.metrics != NULL)
+		for (int m = 0; m < results.nmetrics; m++)
+			free(results.metrics[m].samples);
+	free(results.metrics);
+	free(outlier);
+	return status;
+}
+
+// --scenario: the datasets of a scenario file written into one file, each
+// at its own frame rate, by one thread in the order the chunks are due
+// --------------------------------------------------------------------
+typedef struct scenario_stream_t {
+	const psi_scenario_dataset_t *def;
+	hid_t dset;
+	hid_t type;
+	hid_t memspace;            // one chunk, traditional writes
+	char *buf;                 // every chunk is written from this
+	char *cbuf;                // compressed chunk, direct writes
+	size_t cbuf_size;
+	size_t chunk_bytes;
+	long long nchunks;
+	long long written;         // chunks
+	psi_frame_meta_t meta;
+	double end;                // end of the last write [s after the start]
+	double late_sum;           // of the chunks written after they were due
+	double max_late;
+	long long stored_bytes;    // dataset storage size
+	double write_time;         // in the HDF5 calls
+} scenario_stream_t;
+
+// when the next chunk of a stream is due, the time its last frame is taken
+double scenario_due(const scenario_stream_t *s)
+{
+	if (s->def->rate <= 0.) return s->def->start;
+	return s->def->start + (double) (s->written + 1) * s->def->chunk_frames / s->def->rate;
+}
+
+int write_scenario_chunk(scenario_stream_t *s)
+{
+	const psi_scenario_dataset_t *d = s->def;
+	hsize_t offset[NDIM] = { s->written * d->chunk_frames, 0, 0 };
+	hsize_t count[NDIM] = { d->chunk_frames, d->ny, d->nx };
+	const char *data = s->buf;
+	size_t size = s->chunk_bytes;
+	herr_t ret;
+
+	if (d->traditional) {
+		hid_t space = H5Dget_space(s->dset);
+		if (space < 0) return -1;
+		ret = H5Sselect_hyperslab(space, H5S_SELECT_SET, offset, NULL, count, NULL);
+		if (ret >= 0) ret = H5Dwrite(s->dset, s->type, s->memspace, space, H5P_DEFAULT, s->buf);
+		H5Sclose(space);
+	} else {
+		if (d->bshuf_lz4) {
+			size = psi_bshuf_lz4_compress(s->buf, s->chunk_bytes, get_psi_dtype_size(d->dtype), 0, s->cbuf, s->cbuf_size);
+			if (size == 0) {
+				printf("ERROR: bitshuffle+LZ4 compression failed\n");
+				return -1;
+			}
+			data = s->cbuf;
+		}
+		ret = H5DOwrite_chunk(s->dset, H5P_DEFAULT, 0, offset, size, (void *) data);
+	}
+	if (ret < 0) {
+		printf("ERROR: write of chunk %lli of dataset %s failed\n", s->written, d->name);
+		return -1;
+	}
+	for (long f = 0; d->frame_meta > 0 && f < d->chunk_frames; f++) {
+		if (add_psi_frame_meta(&s->meta, offset[0] + f, 0) < 0) {
+			printf("ERROR: append of frame metadata of dataset %s failed\n", d->name);
+			return -1;
+		}
+	}
+	s->written++;
+	return 0;
+}
+
+int run_scenario(struct gengetopt_args_info args)
+{
+	psi_scenario_t scenario;
+	scenario_stream_t *streams = NULL;
+	int nstreams = 0;
+	char *file_name = NULL;
+	hid_t fapl = -1, file = -1;
+	size_t max_chunk = 0;
+	long long total_bytes = 0, stored_bytes = 0;
+	struct timeval start, t;
+	double elapsed = 0.;
+	int next_unlimited = 0;    // round robin over the streams without rate
+	int ok = 0;
+	struct stat filestat;
+	FILE *jsonfile = NULL;
+
+	if (load_psi_scenario(args.scenario_arg, &scenario) < 0) return 1;
+	if (register_psi_bshuf_lz4_filter() < 0) {
+		printf("ERROR: failed to register PSI bitshuffle+LZ4 filter in HDF5 lib\n");
+		return 1;
+	}
+	file_name = malloc(strlen(args.basename_arg) + 16);
+	streams = calloc(scenario.ndatasets, sizeof(scenario_stream_t));
+	if (file_name == NULL || streams == NULL) {
+		perror("failed to allocate scenario space");
+		goto done;
+	}
+	sprintf(file_name, "%s.scenario.h5", args.basename_arg);
+
+	printf("#PARAM scenario          : %s\n", args.scenario_arg);
+	printf("#PARAM description       : %s\n", scenario.description);
+	printf("#PARAM h5file name       : %s\n", file_name);
+	printf("#PARAM metadata tuning   : %s\n", scenario.metadata_tuning?"yes":"no");
+	printf("#PARAM alignment         : %lli Byte\n", scenario.alignment);
+	for (int i = 0; i < scenario.ndatasets; i++) {
+		const psi_scenario_dataset_t *d = &scenario.datasets[i];
+		printf("#PARAM dataset           : %s %lli x %li x %li %s, %li frames per chunk, ", d->name, d->frames,
+				d->ny, d->nx, get_psi_dtype_name(d->dtype), d->chunk_frames);
+		if (d->rate > 0.) printf("%.1lf frames/s", d->rate);
+		else printf("unlimited");
+		printf(" from %.1lf s, %s data, %s, %s", d->start, d->data, d->bshuf_lz4 ? "bshuf-lz4" : "uncompressed",
+				d->traditional ? "H5Dwrite" : "direct");
+		if (d->frame_meta > 0) printf(", frame metadata");
+		printf("\n");
+		if (get_psi_scenario_chunk_bytes(d) > max_chunk) max_chunk = get_psi_scenario_chunk_bytes(d);
+	}
+
+	// file and datasets, not timed
+	fapl = create_file_access(scenario.metadata_tuning, scenario.alignment, max_chunk);
+	if (fapl < 0) goto done;
+	file = H5Fcreate(file_name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+	if (file < 0) goto done;
+	for (int i = 0; i < scenario.ndatasets; i++) {
+		scenario_stream_t *s = &streams[nstreams++];
+		const psi_scenario_dataset_t *d = &scenario.datasets[i];
+		hsize_t dims[NDIM] = { d->frames, d->ny, d->nx };
+		hsize_t chunk[NDIM] = { d->chunk_frames, d->ny, d->nx };
+		char meta_name[PSI_SCENARIO_MAX_NAME + 8];
+		hid_t space, dcpl;
+
+		s->def = d;
+		s->dset = -1;
+		s->memspace = -1;
+		s->type = get_psi_dtype_h5type(d->dtype);
+		s->chunk_bytes = get_psi_scenario_chunk_bytes(d);
+		s->nchunks = d->frames / d->chunk_frames;
+		s->buf = malloc(s->chunk_bytes);
+		if (s->buf == NULL || fill_chunk_buffer(s->buf, s->chunk_bytes, d->data, i + 1) < 0) goto done;
+		if (d->bshuf_lz4 && !d->traditional) {
+			s->cbuf_size = psi_bshuf_lz4_bound(s->chunk_bytes, get_psi_dtype_size(d->dtype), 0);
+			s->cbuf = malloc(s->cbuf_size);
+			if (s->cbuf == NULL) goto done;
+		}
+		if (d->traditional) {
+			s->memspace = H5Screate_simple(NDIM, chunk, NULL);
+			if (s->memspace < 0) goto done;
+		}
+
+		space = H5Screate_simple(NDIM, dims, NULL);
+		dcpl = H5Pcreate(H5P_DATASET_CREATE);
+		if (space < 0 || dcpl < 0) goto done;
+		if (H5Pset_chunk(dcpl, NDIM, chunk) >= 0
+				&& (!d->bshuf_lz4 || H5Pset_filter(dcpl, PSI_BSHUF_LZ4_FILTER, H5Z_FLAG_MANDATORY, 0, NULL) >= 0))
+			s->dset = H5Dcreate(file, d->name, s->type, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+		H5Pclose(dcpl);
+		H5Sclose(space);
+		if (s->dset < 0) {
+			printf("ERROR: failed to create dataset %s\n", d->name);
+			goto done;
+		}
+		if (d->frame_meta > 0) {
+			snprintf(meta_name, sizeof(meta_name), "%s_meta", d->name);
+			if (create_psi_frame_meta(file, meta_name) < 0
+					|| open_psi_frame_meta(file, meta_name, d->frame_meta, &s->meta) < 0) {
+				printf("ERROR: failed to create frame metadata dataset %s\n", meta_name);
+				goto done;
+			}
+		}
+	}
+
+	// the chunks with a rate when they are due, the others in between
+	printf("# start scenario ...\n");
+	gettimeofday(&start, NULL);
+	for (;;) {
+		scenario_stream_t *s = NULL;
+		double due = 0., next_due = -1.;
+
+		gettimeofday(&t, NULL);
+		elapsed = timediff(&start, &t);
+		for (int i = 0; i < nstreams; i++) {
+			if (streams[i].written == streams[i].nchunks || streams[i].def->rate <= 0.) continue;
+			double d = scenario_due(&streams[i]);
+			if (d <= elapsed && (s == NULL || d < due)) {
+				s = &streams[i];
+				due = d;
+			}
+			if (next_due < 0. || d < next_due) next_due = d;
+		}
+		for (int k = 0; s == NULL && k < nstreams; k++) {
+			int i = (next_unlimited + k) % nstreams;
+			if (streams[i].written == streams[i].nchunks || streams[i].def->rate > 0.) continue;
+			double d = scenario_due(&streams[i]);
+			if (d <= elapsed) {
+				s = &streams[i];
+				next_unlimited = i + 1;
+			} else if (next_due < 0. || d < next_due) {
+				next_due = d;
+			}
+		}
+		if (s == NULL) {
+			if (next_due < 0.) break;   // all written
+			double left = next_due - elapsed;
+			struct timespec ts = { (time_t) left, (long) ((left - (time_t) left)*1.e9) };
+			nanosleep(&ts, NULL);
+			continue;
+		}
+
+		if (s->def->rate > 0.) {
+			double late = elapsed - due;
+			s->late_sum += late;
+			if (late > s->max_late) s->max_late = late;
+		}
+		if (write_scenario_chunk(s) < 0) goto done;
+		gettimeofday(&t, NULL);
+		s->end = timediff(&start, &t);
+		s->write_time += s->end - elapsed;
+	}
+
+	for (int i = 0; i < nstreams; i++) {
+		if (streams[i].def->frame_meta > 0 && close_psi_frame_meta(&streams[i].meta) < 0) {
+			printf("ERROR: failed to write the last frame metadata of dataset %s\n", streams[i].def->name);
+			goto done;
+		}
+		streams[i].stored_bytes = H5Dget_storage_size(streams[i].dset);
+		H5Dclose(streams[i].dset);
+		streams[i].dset = -1;
+	}
+	if (H5Fclose(file) < 0) goto done;
+	file = -1;
+	gettimeofday(&t, NULL);
+	elapsed = timediff(&start, &t);
+	printf("# scenario done\n");
+
+	// read the first chunk of every dataset back
+	file = H5Fopen(file_name, H5F_ACC_RDONLY, H5P_DEFAULT);
+	if (file < 0) goto done;
+	for (int i = 0; i < nstreams; i++) {
+		scenario_stream_t *s = &streams[i];
+		hsize_t offset[NDIM] = { 0, 0, 0 };
+		hsize_t count[NDIM] = { s->def->chunk_frames, s->def->ny, s->def->nx };
+		hid_t dset = H5Dopen(file, s->def->name, H5P_DEFAULT);
+		hid_t space = dset < 0 ? -1 : H5Dget_space(dset);
+		hid_t memspace = H5Screate_simple(NDIM, count, NULL);
+		char *rbuf = calloc(1, s->chunk_bytes);
+		int same = 0;
+
+		if (dset >= 0 && space >= 0 && memspace >= 0 && rbuf != NULL
+				&& H5Sselect_hyperslab(space, H5S_SELECT_SET, offset, NULL, count, NULL) >= 0
+				&& H5Dread(dset, s->type, memspace, space, H5P_DEFAULT, rbuf) >= 0)
+			same = memcmp(rbuf, s->buf, s->chunk_bytes) == 0;
+		free(rbuf);
+		if (memspace >= 0) H5Sclose(memspace);
+		if (space >= 0) H5Sclose(space);
+		if (dset >= 0) H5Dclose(dset);
+		if (!same) {
+			printf("ERROR: first chunk of dataset %s read back differs\n", s->def->name);
+			goto done;
+		}
+	}
+	H5Fclose(file);
+	file = -1;
+	printf("# data verified\n");
+
+	if (stat(file_name, &filestat) == -1) {
+		perror("ERROR: failed to stat the scenario file");
+		goto done;
+	}
+	for (int i = 0; i < nstreams; i++) {
+		total_bytes += streams[i].nchunks * (long long) streams[i].chunk_bytes;
+		stored_bytes += streams[i].stored_bytes;
+	}
+
+	printf("#\n");
+	printf("#RESULTS scenario elapsed time [s]   : %.3lf\n", elapsed);
+	printf("#RESULTS scenario data [MiB]         : %.1lf\n", total_bytes/(1024.*1024.));
+	printf("#RESULTS scenario performance [MiB/s]: %.1lf\n", total_bytes/elapsed/(1024.*1024.));
+	printf("#RESULTS scenario filesize [Byte]    : %lli\n", (long long) filestat.st_size);
+	for (int i = 0; i < nstreams; i++) {
+		const scenario_stream_t *s = &streams[i];
+		double active = s->end - s->def->start;
+		char label[PSI_SCENARIO_MAX_NAME + 32];
+
+		snprintf(label, sizeof(label), "%s rate [frames/s]", s->def->name);
+		printf("#RESULTS %-28s: %.1lf\n", label, active > 0. ? s->def->frames/active : 0.);
+		snprintf(label, sizeof(label), "%s performance [MiB/s]", s->def->name);
+		printf("#RESULTS %-28s: %.1lf\n", label, active > 0. ? s->nchunks*(double)s->chunk_bytes/active/(1024.*1024.) : 0.);
+		snprintf(label, sizeof(label), "%s stored [Byte]", s->def->name);
+		printf("#RESULTS %-28s: %lli\n", label, s->stored_bytes);
+		snprintf(label, sizeof(label), "%s write time [s]", s->def->name);
+		printf("#RESULTS %-28s: %.3lf\n", label, s->write_time);
+		if (s->def->rate > 0.) {
+			snprintf(label, sizeof(label), "%s late mean/max [ms]", s->def->name);
+			printf("#RESULTS %-28s: %.3lf / %.3lf\n", label, s->late_sum/s->nchunks*1.e3, s->max_late*1.e3);
+		}
+	}
+
+	if (args.json_given) {
+		jsonfile = open_json_record(args.json_arg, "scenario");
+		if (jsonfile == NULL) goto done;
+		fprintf(jsonfile, "  \"scenario\":\"%s\", \n"
+				"  \"metadata-tuning\":%s, \n"
+				"  \"alignment\":%lli, \n"
+				"  \"elapsed\":%.3lf, \n"
+				"  \"nbytes\":%lli, \n"
+				"  \"stored-bytes\":%lli, \n"
+				"  \"filesize\":%lli, \n"
+				"  \"datasets\":[",
+				args.scenario_arg,
+				scenario.metadata_tuning ? "true" : "false",
+				scenario.alignment,
+				elapsed,
+				total_bytes,
+				stored_bytes,
+				(long long) filestat.st_size);
+		for (int i = 0; i < nstreams; i++) {
+			const scenario_stream_t *s = &streams[i];
+			const psi_scenario_dataset_t *d = s->def;
+			fprintf(jsonfile, "%s\n    {\"name\":\"%s\", \"shape\":[%lli,%li,%li], \"dtype\":\"%s\", \"chunk-frames\":%li, "
+					"\"rate\":%.1lf, \"start\":%.3lf, \"data\":\"%s\", \"compression\":\"%s\", \"mode\":\"%s\", "
+					"\"frame-meta\":%i, \"end\":%.3lf, \"stored-bytes\":%lli, \"write-time\":%.3lf, "
+					"\"mean-late\":%.6lf, \"max-late\":%.6lf}",
+					i > 0 ? "," : "", d->name, d->frames, d->ny, d->nx, get_psi_dtype_name(d->dtype), d->chunk_frames,
+					d->rate, d->start, d->data, d->bshuf_lz4 ? "bshuf-lz4" : "none",
+					d->traditional ? "traditional" : "direct-write", d->frame_meta, s->end, s->stored_bytes,
+					s->write_time, d->rate > 0. ? s->late_sum/s->nchunks : 0., s->max_late);
+		}
+		fprintf(jsonfile, "\n  ] \n}\n#\n");
+		fclose(jsonfile);
+	}
+	ok = 1;
+
+done:
+	if (file >= 0) H5Fclose(file);
+	if (fapl > 0 && fapl != H5P_DEFAULT) H5Pclose(fapl);
+	for (int i = 0; i < nstreams; i++) {
+		if (streams[i].dset >= 0) H5Dclose(streams[i].dset);
+		if (streams[i].memspace >= 0) H5Sclose(streams[i].memspace);
+		free(streams[i].buf);
+		free(streams[i].cbuf);
+	}
+	free(streams);
+	free(file_name);
+	return ok ? 0 : 1;
+}
+
+// --overwrite: reprocessing rewrites chunks of an existing file. A
+// compressed chunk of another size doesn't fit its old place, HDF5 frees
+// it and allocates new space. Whether later passes reuse these holes
+// depends on the file space strategy: free space that is not persisted is
+// forgotten when the file is closed.
+// --------------------------------------------------------------------
+enum { OVERWRITE_VARIANTS=8, NFS_STRATEGIES=6 };
+
+typedef struct fs_strategy_t {
+	const char *name;
+	H5F_fspace_strategy_t strategy;
+	hbool_t persist;
+} fs_strategy_t;
+
+static const fs_strategy_t fs_strategies[NFS_STRATEGIES] = {
+	{ "fsm-aggr",     H5F_FSPACE_STRATEGY_FSM_AGGR, 0 },   // the default of HDF5
+	{ "fsm-persist",  H5F_FSPACE_STRATEGY_FSM_AGGR, 1 },
+	{ "page",         H5F_FSPACE_STRATEGY_PAGE,     0 },
+	{ "page-persist", H5F_FSPACE_STRATEGY_PAGE,     1 },
+	{ "aggr",         H5F_FSPACE_STRATEGY_AGGR,     0 },
+	{ "none",         H5F_FSPACE_STRATEGY_NONE,     0 },
+};
+
+int fs_strategy_from_name(const char *name)
+{
+	for (int s = 0; s < NFS_STRATEGIES; s++)
+		if (strcmp(name, fs_strategies[s].name) == 0) return s;
+	return -1;
+}
+
+typedef struct overwrite_pass_t {
+	long long nchunks;          // written in the pass
+	long long stored_bytes;     // compressed, as written
+	double elapsed;             // open, writes and close
+	long long filesize;
+	long long live_bytes;       // storage of the dataset after the pass
+	long long free_at_open;     // free space HDF5 knew of when the pass opened the file
+	long long free_at_close;
+	long long free_sections;    // at the close
+} overwrite_pass_t;
+
+// pass 0 creates the file and writes every chunk, the later passes rewrite
+// the chunks in order[0 .. nchunks-1] with another variant
+int overwrite_pass(const char *file_name, hid_t fcpl, hid_t fapl, const struct gengetopt_args_info *args,
+		char **cbufs, const size_t *csizes, int *variant, const long long *order, long long nchunks,
+		int pass, overwrite_pass_t *result)
+{
+	const char dataset_name[] = "data";
+	hsize_t offset[NDIM] = { 0, 0, 0 };
+	struct timeval start, end, close_start, close_end;
+	hid_t file = -1, dset = -1, space = -1, dcpl = -1;
+	int ok = 0;
+
+	memset(result, 0, sizeof(*result));
+	gettimeofday(&start, NULL);
+	if (pass == 0) {
+		hsize_t dims[NDIM] = { args->nimages_arg, args->ny_arg, args->nx_arg };
+		hsize_t chunk[NDIM] = { args->chunk_size_arg, args->ny_arg, args->nx_arg };
+
+		file = H5Fcreate(file_name, H5F_ACC_TRUNC, fcpl, fapl);
+		if (file < 0) goto done;
+		space = H5Screate_simple(NDIM, dims, NULL);
+		dcpl = H5Pcreate(H5P_DATASET_CREATE);
+		if (space < 0 || dcpl < 0) goto done;
+		if (H5Pset_filter(dcpl, PSI_BSHUF_LZ4_FILTER, H5Z_FLAG_MANDATORY, 0, NULL) < 0) goto done;
+		if (H5Pset_chunk(dcpl, NDIM, chunk) < 0) goto done;
+		dset = H5Dcreate(file, dataset_name, H5T_STD_U8LE, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+	} else {
+		file = H5Fopen(file_name, H5F_ACC_RDWR, fapl);
+		if (file < 0) goto done;
+		result->free_at_open = H5Fget_freespace(file);
+		dset = H5Dopen(file, dataset_name, H5P_DEFAULT);
+	}
+	if (dset < 0) goto done;
+
+	for (long long i = 0; i < nchunks; i++) {
+		long long c = order[i];
+		int v = pass == 0 ? c % OVERWRITE_VARIANTS
+				: (variant[c] + 1 + (c + pass) % (OVERWRITE_VARIANTS - 1)) % OVERWRITE_VARIANTS;
+
+		offset[0] = c*args->chunk_size_arg;
+		if (H5DOwrite_chunk(dset, H5P_DEFAULT, 0, offset, csizes[v], cbufs[v]) < 0) {
+			printf("ERROR: write of chunk %lli in pass %i failed\n", c, pass);
+			goto done;
+		}
+		variant[c] = v;
+		result->stored_bytes += csizes[v];
+	}
+	result->nchunks = nchunks;
+	gettimeofday(&end, NULL);
+
+	// not timed
+	result->live_bytes = H5Dget_storage_size(dset);
+	result->free_at_close = H5Fget_freespace(file);
+	result->free_sections = H5Fget_free_sections(file, H5FD_MEM_DEFAULT, 0, NULL);
+
+	gettimeofday(&close_start, NULL);
+	if (H5Dclose(dset) < 0) goto done;
+	dset = -1;
+	if (H5Fclose(file) < 0) goto done;
+	file = -1;
+	gettimeofday(&close_end, NULL);
+	result->elapsed = timediff(&start, &end) + timediff(&close_start, &close_end);
+	ok = 1;
+
+done:
+	if (!ok) printf("ERROR: overwrite pass %i of %s failed\n", pass, file_name);
+	if (dset >= 0) H5Dclose(dset);
+	if (dcpl >= 0) H5Pclose(dcpl);
+	if (space >= 0) H5Sclose(space);
+	if (file >= 0) H5Fclose(file);
+	return ok ? 0 : -1;
+}
+
+int run_overwrite(struct gengetopt_args_info args)
+{
+	int strategies[NFS_STRATEGIES];
+	int nstrategies;
+	int npasses = args.overwrite_arg + 1;       // pass 0 is the first write
+	long long nchunks, nrewrite;
+	size_t chunk_size;
+	char *bufs[OVERWRITE_VARIANTS] = { NULL };
+	char *cbufs[OVERWRITE_VARIANTS] = { NULL };
+	size_t csizes[OVERWRITE_VARIANTS];
+	size_t cbuf_size;
+	int *variant = NULL;
+	long long *sequential = NULL;
+	long long **rewrites = NULL;           // chunks of every pass, the same for all strategies
+	overwrite_pass_t *results = NULL;      // [strategy][pass]
+	char *file_name = NULL;
+	char *rbuf = NULL;
+	hid_t fapl = -1, fcpl = -1;
+	FILE *jsonfile = NULL;
+	int ok = 0;
+
+	if (args.nx_arg <= 0 || args.ny_arg <= 0 || args.nimages_arg <= 0 || args.chunk_size_arg <= 0) {
+		printf("ERROR: nx, ny, nimages and chunk_size must be positive and none-zero\n");
+		return 1;
+	}
+	if (args.nimages_arg % args.chunk_size_arg != 0) {
+		printf("ERROR: overwrite needs nimages %li to be a multiple of chunk size %li\n", args.nimages_arg, args.chunk_size_arg);
+		return 1;
+	}
+	if ((double)args.nx_arg*(double)args.ny_arg*(double)args.chunk_size_arg > (double)MAX_CHUNK_BYTES) {
+		printf("ERROR: chunk of %li x %li x %li bytes exceeds the HDF5 limit of %llu bytes\n",
+				args.chunk_size_arg, args.ny_arg, args.nx_arg, MAX_CHUNK_BYTES);
+		return 1;
+	}
+	if (args.overwrite_fraction_arg <= 0. || args.overwrite_fraction_arg > 1.) {
+		printf("ERROR: overwrite fraction must be above 0 and at most 1\n");
+		return 1;
+	}
+	nstrategies = parse_name_list(args.fs_strategies_arg, fs_strategy_from_name, NFS_STRATEGIES, strategies);
+	if (nstrategies < 0) {
+		printf("ERROR: unknown file space strategy in %s\n", args.fs_strategies_arg);
+		return 1;
+	}
+	if (register_psi_bshuf_lz4_filter() < 0) {
+		printf("ERROR: failed to register PSI bitshuffle+LZ4 filter in HDF5 lib\n");
+		return 1;
+	}
+
+	nchunks = args.nimages_arg / args.chunk_size_arg;
+	nrewrite = (long long) (args.overwrite_fraction_arg*nchunks + 0.5);
+	if (nrewrite < 1) nrewrite = 1;
+	chunk_size = (size_t)args.nx_arg * (size_t)args.ny_arg * (size_t)args.chunk_size_arg;
+	cbuf_size = psi_bshuf_lz4_bound(chunk_size, 1, 0);
+
+	file_name = malloc(strlen(args.basename_arg) + 16);
+	variant = calloc(nchunks, sizeof(int));
+	rewrites = calloc(npasses, sizeof(long long *));
+	results = calloc((size_t) nstrategies*npasses, sizeof(overwrite_pass_t));
+	rbuf = malloc(chunk_size);
+	sequential = get_psi_write_order(PSI_WRITE_SEQUENTIAL, nchunks, 0);
+	if (file_name == NULL || variant == NULL || rewrites == NULL || results == NULL || rbuf == NULL || sequential == NULL) {
+		perror("failed to allocate overwrite space");
+		goto done;
+	}
+	sprintf(file_name, "%s.overwrite.h5", args.basename_arg);
+	for (int p = 1; p < npasses; p++) {
+		rewrites[p] = get_psi_write_order(PSI_WRITE_SHUFFLED, nchunks, p);   // the first nrewrite of them
+		if (rewrites[p] == NULL) {
+			perror("failed to allocate overwrite space");
+			goto done;
+		}
+	}
+
+	// variant v has (v+1)/OVERWRITE_VARIANTS of the chunk incompressible,
+	// the rest zero, so every variant compresses to another size
+	for (int v = 0; v < OVERWRITE_VARIANTS; v++) {
+		size_t noisy = chunk_size/OVERWRITE_VARIANTS*(v + 1);
+		bufs[v] = malloc(chunk_size);
+		cbufs[v] = malloc(cbuf_size);
+		if (bufs[v] == NULL || cbufs[v] == NULL) {
+			perror("failed to allocate buffer space");
+			goto done;
+		}
+		fill_chunk_buffer(bufs[v], noisy, "random", v + 1);
+		memset(bufs[v] + noisy, 0, chunk_size - noisy);
+		csizes[v] = psi_bshuf_lz4_compress(bufs[v], chunk_size, 1, 0, cbufs[v], cbuf_size);
+		if (csizes[v] == 0) {
+			printf("ERROR: bitshuffle+LZ4 compression failed\n");
+			goto done;
+		}
+	}
+
+	printf("#PARAM h5file name       : %s\n", file_name);
+	printf("#PARAM chunk size [Byte] : %zi\n", chunk_size);
+	printf("#PARAM array shape       : (z=%li,y=%li,x=%li)\n", args.nimages_arg, args.ny_arg, args.nx_arg);
+	printf("#PARAM chunk shape       : (z=%li,y=%li,x=%li)\n",  args.chunk_size_arg, args.ny_arg, args.nx_arg);
+	printf("#PARAM compressed chunks : %zu to %zu Byte, bitshuffle+LZ4 (%s)\n", csizes[0], csizes[OVERWRITE_VARIANTS - 1],
+			get_psi_bshuf_impl_name());
+	printf("#PARAM overwrite passes  : %i, %lli of %lli chunks each\n", args.overwrite_arg, nrewrite, nchunks);
+	printf("#PARAM metadata tuning   : %s\n", args.metadata_tuning_flag?"yes":"no");
+	printf("#PARAM alignment         : %li Byte\n", args.alignment_arg);
+	printf("#PARAM fs strategies     :");
+	for (int s = 0; s < nstrategies; s++)
+		printf(" %s", fs_strategies[strategies[s]].name);
+	printf("\n");
+
+	for (int s = 0; s < nstrategies; s++) {
+		const fs_strategy_t *strategy = &fs_strategies[strategies[s]];
+		overwrite_pass_t *r = &results[s*npasses];
+
+		printf("# file space strategy %s\n", strategy->name);
+		fapl = create_file_access(args.metadata_tuning_flag, args.alignment_arg, chunk_size);
+		fcpl = H5Pcreate(H5P_FILE_CREATE);
+		if (fapl < 0 || fcpl < 0) goto done;
+		if (H5Pset_file_space_strategy(fcpl, strategy->strategy, strategy->persist, 1) < 0) {
+			printf("ERROR: failed to set file space strategy %s\n", strategy->name);
+			goto done;
+		}
+
+		for (int p = 0; p < npasses; p++) {
+			struct stat filestat;
+
+			if (overwrite_pass(file_name, fcpl, fapl, &args, cbufs, csizes, variant,
+					p == 0 ? sequential : rewrites[p], p == 0 ? nchunks : nrewrite, p, &r[p]) < 0)
+				goto done;
+			if (stat(file_name, &filestat) == -1) {
+				perror("ERROR: failed to stat the overwrite file");
+				goto done;
+			}
+			r[p].filesize = filestat.st_size;
+		}
+
+		// every chunk holds the variant it was last written with
+		hid_t file = H5Fopen(file_name, H5F_ACC_RDONLY, fapl);
+		hid_t dset = file < 0 ? -1 : H5Dopen(file, "data", H5P_DEFAULT);
+		hid_t space = dset < 0 ? -1 : H5Dget_space(dset);
+		hsize_t start[NDIM] = { 0, 0, 0 };
+		hsize_t count[NDIM] = { args.chunk_size_arg, args.ny_arg, args.nx_arg };
+		hid_t memspace = H5Screate_simple(NDIM, count, NULL);
+		long long c = 0;
+		for (; space >= 0 && memspace >= 0 && c < nchunks; c++) {
+			start[0] = c*args.chunk_size_arg;
+			if (H5Sselect_hyperslab(space, H5S_SELECT_SET, start, NULL, count, NULL) < 0
+					|| H5Dread(dset, H5T_NATIVE_UINT8, memspace, space, H5P_DEFAULT, rbuf) < 0
+					|| memcmp(rbuf, bufs[variant[c]], chunk_size) != 0)
+				break;
+		}
+		if (memspace >= 0) H5Sclose(memspace);
+		if (space >= 0) H5Sclose(space);
+		if (dset >= 0) H5Dclose(dset);
+		if (file >= 0) H5Fclose(file);
+		if (c < nchunks) {
+			printf("ERROR: chunk %lli of %s read back differs\n", c, file_name);
+			goto done;
+		}
+		printf("# data verified\n");
+
+		H5Pclose(fcpl);
+		fcpl = -1;
+		if (fapl != H5P_DEFAULT) H5Pclose(fapl);
+		fapl = -1;
+	}
+
+	printf("#\n");
+	printf("# per pass: rate [MiB/s] / file size [MiB] / growth [%%] / not chunk data [%%] / free at open [MiB] / free sections\n");
+	for (int s = 0; s < nstrategies; s++) {
+		const overwrite_pass_t *r = &results[s*npasses];
+		const char *name = fs_strategies[strategies[s]].name;
+		char label[MAX_METRIC_NAME];
+		double rewrite_time = 0.;
+
+		for (int p = 0; p < npasses; p++) {
+			snprintf(label, sizeof(label), "%s pass %i", name, p);
+			printf("#RESULTS %-28s: %.1lf / %.1lf / %.1lf / %.1lf / %.1lf / %lli\n", label,
+					r[p].nchunks*(double)chunk_size/r[p].elapsed/(1024.*1024.),
+					r[p].filesize/(1024.*1024.),
+					100.*(double)(r[p].filesize - r[0].filesize)/(double)r[0].filesize,
+					100.*(double)(r[p].filesize - r[p].live_bytes)/(double)r[p].filesize,
+					r[p].free_at_open/(1024.*1024.),
+					r[p].free_sections);
+			if (p > 0) rewrite_time += r[p].elapsed;
+		}
+		if (npasses > 1) {
+			snprintf(label, sizeof(label), "%s rewrite [MiB/s]", name);
+			printf("#RESULTS %-28s: %.1lf\n", label, (npasses - 1)*nrewrite*(double)chunk_size/rewrite_time/(1024.*1024.));
+		}
+		snprintf(label, sizeof(label), "%s growth [%%]", name);
+		printf("#RESULTS %-28s: %.1lf\n", label,
+				100.*(double)(r[npasses - 1].filesize - r[0].filesize)/(double)r[0].filesize);
+	}
+
+	if (args.json_given) {
+		jsonfile = open_json_record(args.json_arg, "overwrite");
+		if (jsonfile == NULL) goto done;
+		fprintf(jsonfile, "  \"chunk-size\":%zi, \n"
+				"  \"shape\":[%li,%li,%li], \n"
+				"  \"chunk\":[%li,%li,%li], \n"
+				"  \"metadata-tuning\":%s, \n"
+				"  \"alignment\":%li, \n"
+				"  \"passes\":%i, \n"
+				"  \"rewrite-chunks\":%lli, \n"
+				"  \"strategies\":[",
+				chunk_size,
+				args.nimages_arg,   args.ny_arg, args.nx_arg,
+				args.chunk_size_arg,args.ny_arg, args.nx_arg,
+				args.metadata_tuning_flag ? "true" : "false",
+				args.alignment_arg,
+				args.overwrite_arg,
+				nrewrite);
+		for (int s = 0; s < nstrategies; s++) {
+			const overwrite_pass_t *r = &results[s*npasses];
+			fprintf(jsonfile, "%s\n    {\"name\":\"%s\", \"persist\":%s, \"passes\":[", s > 0 ? "," : "",
+					fs_strategies[strategies[s]].name, fs_strategies[strategies[s]].persist ? "true" : "false");
+			for (int p = 0; p < npasses; p++) {
+				fprintf(jsonfile, "%s\n      {\"pass\":%i, \"chunks\":%lli, \"stored-bytes\":%lli, \"elapsed\":%.6lf, "
+						"\"filesize\":%lli, \"live-bytes\":%lli, \"free-at-open\":%lli, \"free-at-close\":%lli, "
+						"\"free-sections\":%lli}",
+						p > 0 ? "," : "", p, r[p].nchunks, r[p].stored_bytes, r[p].elapsed, r[p].filesize,
+						r[p].live_bytes, r[p].free_at_open, r[p].free_at_close, r[p].free_sections);
+			}
+			fprintf(jsonfile, "]}");
+		}
+		fprintf(jsonfile, "\n  ] \n}\n#\n");
+		fclose(jsonfile);
+	}
+	ok = 1;
+
+done:
+	if (fcpl >= 0) H5Pclose(fcpl);
+	if (fapl > 0 && fapl != H5P_DEFAULT) H5Pclose(fapl);
+	for (int v = 0; v < OVERWRITE_VARIANTS; v++) {
+		free(bufs[v]);
+		free(cbufs[v]);
+	}
+	for (int p = 0; rewrites != NULL && p < npasses; p++)
+		free(rewrites[p]);
+	free(rewrites);
+	free(sequential);
+	free(results);
+	free(variant);
+	free(rbuf);
+	free(file_name);
+	return ok ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+	struct gengetopt_args_info args;
+	// a scenario has its own shapes, -x -y -z are required otherwise
+	if (cmdline_parser2(argc, argv, &args, 0, 1, 0) != 0) exit(1);
+	if (!args.scenario_given && cmdline_parser_required(&args, argv[0]) != 0) exit(1);
+
+	if (args.nprocs_arg < 1 || args.nprocs_arg > MAX_NPROCS) {
+		printf("ERROR: nprocs must be between 1 and %i\n", MAX_NPROCS);
+		printf("# FAILURE\n");
+		exit(1);
+	}
+	if (strcmp(args.order_arg, "raw-first") != 0 && strcmp(args.order_arg, "h5-first") != 0
+			&& strcmp(args.order_arg, "alternate") != 0 && strcmp(args.order_arg, "random") != 0) {
+		printf("ERROR: unknown phase order %s, use raw-first, h5-first, alternate or random\n", args.order_arg);
+		printf("# FAILURE\n");
+		exit(1);
+	}
+	if (args.quiesce_arg < 0. || args.quiesce_dirty_arg < 0) {
+		printf("ERROR: quiesce and quiesce-dirty must not be negative\n");
+		printf("# FAILURE\n");
+		exit(1);
+	}
+	srand((unsigned int) time(NULL) ^ (unsigned int) getpid());   // --order random
+	if (args.repeat_arg < 1 || args.warmup_arg < 0) {
+		printf("ERROR: repeat must be at least 1 and warmup must not be negative\n");
+		printf("# FAILURE\n");
+		exit(1);
+	}
+	if (args.repeat_arg > 1 || args.warmup_arg > 0) {
+		if (args.nprocs_arg > 1 || args.nprocs_sweep_flag || args.write_threads_arg > 0 || args.tune_arg > 0.
+				|| args.scenario_given || args.overwrite_arg > 0) {
+			printf("ERROR: repeat and warmup work for single benchmark runs only\n");
+			printf("# FAILURE\n");
+			exit(1);
+		}
+		if (run_repeat(args) != 0) {
+			printf("# FAILURE\n");
+			exit(1);
+		}
+		exit(0);
+	}
+	if (args.scenario_given) {
+		if (args.nprocs_arg > 1 || args.nprocs_sweep_flag || args.write_threads_arg > 0 || args.tune_arg > 0.) {
+			printf("ERROR: a scenario is a run of its own, don't combine it with nprocs, write-threads or tune\n");
+			printf("# FAILURE\n");
+			exit(1);
+		}
+		if (run_scenario(args) != 0) {
+			printf("# FAILURE\n");
+			exit(1);
+		}
+		exit(0);
+	}
+	if (args.overwrite_arg < 0) {
+		printf("ERROR: overwrite passes must not be negative\n");
+		printf("# FAILURE\n");
+		exit(1);
+	}
+	if (args.overwrite_arg > 0) {
+		if (args.nprocs_arg > 1 || args.nprocs_sweep_flag || args.write_threads_arg > 0 || args.tune_arg > 0.) {
+			printf("ERROR: overwrite is a run of its own, don't combine it with nprocs, write-threads or tune\n");
+			printf("# FAILURE\n");
+			exit(1);
+		}
+		if (run_overwrite(args) != 0) {
+			printf("# FAILURE\n");
+			exit(1);
+		}
+		exit(0);
+	}
+	if (args.tune_arg < 0.) {
+		printf("ERROR: tuner budget must not be negative\n");
+		printf("# FAILURE\n");
+		exit(1);
+	}
+	if (args.tune_arg > 0.) {
+		if (run_tune(args) != 0) {
+			printf("# FAILURE\n");
+			exit(1);
+		}
+		exit(0);
+	}
+	if (args.write_threads_arg > 0) {
+		if (args.nprocs_arg > 1) {
+			printf("ERROR: write-threads runs its own writer processes, don't combine it with nprocs\n");
+			printf("# FAILURE\n");
+			exit(1);
+		}
+		if (run_write_threads(args) != 0) {
+			printf("# FAILURE\n");
+			exit(1);
+		}
+		exit(0);
+	}
+	if (args.nprocs_arg > 1 || args.nprocs_sweep_flag) {
+		if (run_nprocs(args) != 0) {
+			printf("# FAILURE\n");
+			exit(1);
+		}
+		exit(0);
+	}
+	return run_benchmark(args, NULL);
 }
 
 
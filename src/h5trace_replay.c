@@ -0,0 +1,382 @@
+/*
+ * h5trace_replay.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * replay the I/O of a trace recorded with h5direct_write_benchmark --trace
+ * with plain pwrite(), without the HDF5 library. Same offsets, sizes and order,
+ * optionally with several requests in flight. The difference to the HDF5
+ * timing is the CPU cost inside the library, the difference to the raw timing
+ * is the cost of the I/O pattern HDF5 produces.
+ *
+ * usage: h5trace_replay [-q depth] [-o outfile] [-r] [-f] [-j jsonfile] tracefile
+ *
+ *   -q  number of requests in flight (threads), default 1
+ *   -o  file to write to, default replay.out
+ *   -r  replay reads too, default is writes only
+ *   -f  fsync() the file before the clock is stopped
+ *   -j  append results to given file using json formating
+ *
+ * Truncates are replayed with ftruncate() at their place in the trace: a
+ * truncate waits for all records before it to finish and no record after it
+ * is started before it is done. The writes share one buffer that is never
+ * changed, every thread reads into its own. The traced file did exist before
+ * the traced writes, so with -r the replay file is sized to the traced end of
+ * file before the clock starts and the reads of data the replay has not
+ * written yet return zeros. Reads past the traced end of file (HDF5 probing
+ * for the superblock, say) are skipped and counted.
+ */
+
+#define _XOPEN_SOURCE 500   /* pread, pwrite */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+enum { INIT_VALUE=127, MAX_LINE_LENGTH=256, MAX_QUEUE_DEPTH=256 };
+
+typedef struct replay_record_t {
+	long long offset;
+	size_t size;
+	char op;
+} replay_record_t;
+
+typedef struct replay_t {
+	replay_record_t *records;
+	long long nrecords;
+	long long next;           // next record to submit, shared by all threads
+	long long inflight;       // records submitted and not finished yet
+	pthread_mutex_t lock;
+	pthread_cond_t idle;      // inflight dropped to 0
+	int fd;
+	char *buf;                // source of all writes, only read
+	int failed;               // next, inflight and failed are guarded by lock
+} replay_t;
+
+typedef struct replay_thread_t {
+	replay_t *replay;
+	char *rbuf;               // destination of the reads of this thread
+} replay_thread_t;
+
+static double
+timediff(const struct timeval *start, const struct timeval *end)
+{
+	return (double) (end->tv_sec - start->tv_sec + (end->tv_usec - start->tv_usec)*1.e-6);
+}
+
+static int
+read_trace(const char *name, int with_reads, replay_t *replay, size_t *max_size, double *trace_elapsed,
+		long long *eof, long long *skipped_reads)
+{
+	char line[MAX_LINE_LENGTH];
+	long long capacity = 0;
+	FILE *trace;
+
+	trace = fopen(name, "r");
+	if (trace == NULL) {
+		perror("ERROR: failed to open trace file");
+		return -1;
+	}
+
+	*max_size = 0;
+	*trace_elapsed = 0.;
+	*eof = 0;
+	*skipped_reads = 0;
+	while (fgets(line, sizeof(line), trace) != NULL) {
+		char op;
+		double time;
+		int type;
+		unsigned long long offset;
+		size_t size;
+
+		if (line[0] == '#') continue;
+		if (sscanf(line, "%c %lf %i %llu %zu", &op, &time, &type, &offset, &size) != 5) {
+			printf("ERROR: bad line in trace file: %s", line);
+			fclose(trace);
+			return -1;
+		}
+		*trace_elapsed = time;
+		if (op == 'W' && (long long) (offset + size) > *eof) *eof = (long long) (offset + size);
+		if (op == 'T' && (long long) offset > *eof) *eof = (long long) offset;
+		if (op == 'R' && !with_reads) continue;
+		if (op != 'W' && op != 'R' && op != 'T') continue;
+
+		if (replay->nrecords == capacity) {
+			capacity = capacity ? 2*capacity : 4096;
+			replay_record_t *records = realloc(replay->records, capacity*sizeof(replay_record_t));
+			if (records == NULL) {
+				perror("ERROR: failed to allocate space for trace records");
+				fclose(trace);
+				return -1;
+			}
+			replay->records = records;
+		}
+		replay->records[replay->nrecords].op = op;
+		replay->records[replay->nrecords].offset = (long long) offset;
+		replay->records[replay->nrecords].size = size;
+		replay->nrecords++;
+		if (size > *max_size) *max_size = size;
+	}
+	fclose(trace);
+
+	// the end of file is only known after the last record
+	if (with_reads) {
+		long long n = 0;
+		for (long long i = 0; i < replay->nrecords; i++) {
+			const replay_record_t *rec = &replay->records[i];
+			if (rec->op == 'R' && rec->offset + (long long) rec->size > *eof) {
+				(*skipped_reads)++;
+				continue;
+			}
+			replay->records[n++] = *rec;
+		}
+		replay->nrecords = n;
+	}
+	return 0;
+}
+
+// the next record to submit, nrecords when done. A truncate is done here
+// once the records before it have finished, holding the lock keeps the
+// other threads from submitting the records after it meanwhile.
+static long long
+next_record(replay_t *replay)
+{
+	long long i;
+
+	pthread_mutex_lock(&replay->lock);
+	while (1) {
+		if (replay->failed || replay->next >= replay->nrecords) {
+			i = replay->nrecords;
+			break;
+		}
+		const replay_record_t *rec = &replay->records[replay->next];
+		if (rec->op != 'T') {
+			i = replay->next++;
+			replay->inflight++;
+			break;
+		}
+		if (replay->inflight > 0) {
+			pthread_cond_wait(&replay->idle, &replay->lock);
+			continue;
+		}
+		if (ftruncate(replay->fd, rec->offset) == -1) {
+			perror("ERROR: replay truncate failed");
+			replay->failed = 1;
+		}
+		replay->next++;
+	}
+	pthread_mutex_unlock(&replay->lock);
+	return i;
+}
+
+static void *
+replay_worker(void *arg)
+{
+	replay_thread_t *thread = arg;
+	replay_t *replay = thread->replay;
+
+	while (1) {
+		long long i = next_record(replay);
+		ssize_t n;
+
+		if (i >= replay->nrecords) break;
+
+		const replay_record_t *rec = &replay->records[i];
+		if (rec->op == 'W') {
+			n = pwrite(replay->fd, replay->buf, rec->size, rec->offset);
+		} else {
+			n = pread(replay->fd, thread->rbuf, rec->size, rec->offset);
+		}
+		if (n == -1) perror("ERROR: replay I/O failed");
+
+		pthread_mutex_lock(&replay->lock);
+		if (n == -1) replay->failed = 1;
+		if (--replay->inflight == 0) pthread_cond_broadcast(&replay->idle);
+		pthread_mutex_unlock(&replay->lock);
+		if (n == -1) break;
+	}
+	return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+	struct timeval wall_start = {0,0};
+	struct timeval wall_end = {0,0};
+	double wall_elapsed, trace_elapsed;
+	pthread_t threads[MAX_QUEUE_DEPTH];
+	replay_thread_t thread_args[MAX_QUEUE_DEPTH];
+	replay_t replay;
+	long long nbytes = 0;
+	long long nbytes_read = 0;
+	long long eof, skipped_reads;
+	size_t max_size;
+
+	int queue_depth = 1;
+	int with_reads = 0;
+	int do_fsync = 0;
+	const char *outfile_name = "replay.out";
+	const char *json_name = NULL;
+	int c;
+
+	while ((c = getopt(argc, argv, "q:o:rfj:")) != -1) {
+		switch (c) {
+		case 'q': queue_depth = atoi(optarg); break;
+		case 'o': outfile_name = optarg; break;
+		case 'r': with_reads = 1; break;
+		case 'f': do_fsync = 1; break;
+		case 'j': json_name = optarg; break;
+		default:
+			printf("usage: %s [-q depth] [-o outfile] [-r] [-f] [-j jsonfile] tracefile\n", argv[0]);
+			exit(1);
+		}
+	}
+	if (optind != argc - 1) {
+		printf("usage: %s [-q depth] [-o outfile] [-r] [-f] [-j jsonfile] tracefile\n", argv[0]);
+		exit(1);
+	}
+	if (queue_depth < 1 || queue_depth > MAX_QUEUE_DEPTH) {
+		printf("ERROR: queue depth must be between 1 and %i\n", MAX_QUEUE_DEPTH);
+		goto fail;
+	}
+
+	memset(&replay, 0, sizeof(replay));
+	memset(thread_args, 0, sizeof(thread_args));
+	pthread_mutex_init(&replay.lock, NULL);
+	pthread_cond_init(&replay.idle, NULL);
+	if (read_trace(argv[optind], with_reads, &replay, &max_size, &trace_elapsed, &eof, &skipped_reads) < 0) goto fail;
+	if (replay.nrecords == 0) {
+		printf("ERROR: no records to replay in %s\n", argv[optind]);
+		goto fail;
+	}
+	for (long long i = 0; i < replay.nrecords; i++) {
+		if (replay.records[i].op == 'W') nbytes += replay.records[i].size;
+		if (replay.records[i].op == 'R') nbytes_read += replay.records[i].size;
+	}
+
+	replay.buf = malloc(max_size ? max_size : 1);
+	if (replay.buf == NULL) {
+		perror("failed to allocate buffer space");
+		goto fail;
+	}
+	memset(replay.buf, INIT_VALUE, max_size);
+	for (int i = 0; i < queue_depth; i++) {
+		thread_args[i].replay = &replay;
+		if (nbytes_read == 0) continue;
+		thread_args[i].rbuf = malloc(max_size);
+		if (thread_args[i].rbuf == NULL) {
+			perror("failed to allocate buffer space");
+			goto fail;
+		}
+	}
+	unlink(outfile_name);
+	if (with_reads) {
+		int fd = open(outfile_name, O_RDWR|O_CREAT|O_TRUNC, S_IRWXU);
+		if (fd == -1 || ftruncate(fd, eof) == -1 || close(fd) == -1) {
+			printf("ERROR: failed to size %s to the traced end of file\n", outfile_name);
+			perror(NULL);
+			goto fail;
+		}
+	}
+
+	// replay
+	// ------
+	printf("# start replay of %lli records ...\n", replay.nrecords);
+	gettimeofday(&wall_start, NULL);
+
+	replay.fd = open(outfile_name, with_reads ? O_RDWR : O_RDWR|O_CREAT|O_TRUNC, S_IRWXU);
+	if (replay.fd == -1) {
+		printf("ERROR:open failed for %s\n", outfile_name);
+		perror(NULL);
+		goto fail;
+	}
+
+	if (queue_depth == 1) {
+		replay_worker(&thread_args[0]);
+	} else {
+		for (int i = 0; i < queue_depth; i++) {
+			if (pthread_create(&threads[i], NULL, replay_worker, &thread_args[i]) != 0) {
+				printf("ERROR: failed to start replay thread\n");
+				goto fail;
+			}
+		}
+		for (int i = 0; i < queue_depth; i++) {
+			pthread_join(threads[i], NULL);
+		}
+	}
+	if (replay.failed) goto fail;
+
+	if (do_fsync && fsync(replay.fd) == -1) {
+		perror("ERROR: fsync of replay file failed");
+		goto fail;
+	}
+	if (close(replay.fd) == -1) {
+		perror("ERROR: close of replay file failed");
+		goto fail;
+	}
+	gettimeofday(&wall_end, NULL);
+	printf("# replay done\n");
+
+	wall_elapsed = timediff(&wall_start, &wall_end);
+
+
+	// report results
+	// --------------
+	printf("#PARAM trace file          : %s\n", argv[optind]);
+	printf("#PARAM replay file         : %s\n", outfile_name);
+	printf("#PARAM queue depth         : %i\n", queue_depth);
+	printf("#PARAM replay reads        : %s\n", with_reads?"yes":"no");
+	printf("#PARAM fsync               : %s\n", do_fsync?"yes":"no");
+	printf("#\n");
+	printf("#RESULTS replay records                     : %lli\n", replay.nrecords);
+	printf("#RESULTS replay bytes written               : %lli\n", nbytes);
+	if (with_reads) {
+		printf("#RESULTS replay bytes read                  : %lli\n", nbytes_read);
+		printf("#RESULTS reads skipped past traced EOF      : %lli\n", skipped_reads);
+	}
+	printf("#RESULTS replay elapsed time [s]            : %.3lf\n", wall_elapsed);
+	printf("#RESULTS replay performance1 [call/s]       : %.3lf\n", (double)replay.nrecords/wall_elapsed);
+	printf("#RESULTS replay performance2 [MiB/s]        : %.1lf\n", (double)nbytes/wall_elapsed/(1024.*1024.));
+	printf("#RESULTS traced elapsed time [s]            : %.3lf\n", trace_elapsed);
+	if (trace_elapsed > 0.) {
+		printf("#RESULTS traced performance2 [MiB/s]        : %.1lf\n", (double)nbytes/trace_elapsed/(1024.*1024.));
+		printf("#RESULTS replay relative to traced [%%]      : %.0lf\n", 100.*trace_elapsed/wall_elapsed);
+	}
+	printf("#\n");
+
+	if (json_name != NULL) {
+		FILE *jsonfile = fopen(json_name, "a");
+		if (jsonfile == NULL) {
+			perror("ERROR: failed to open file for json output");
+			goto fail;
+		}
+		fprintf(jsonfile, "{ \n"
+				"  \"mode\":\"replay\", \n"
+				"  \"queue-depth\":%i, \n"
+				"  \"records\":%lli, \n"
+				"  \"nbytes\":%lli, \n"
+				"  \"nbytes-read\":%lli, \n"
+				"  \"skipped-reads\":%lli, \n"
+				"  \"replay-elapsed-wall\":%.3lf, \n"
+				"  \"traced-elapsed-wall\":%.3lf \n"
+				"}\n#\n",
+				queue_depth, replay.nrecords, nbytes, nbytes_read, skipped_reads, wall_elapsed, trace_elapsed);
+		fclose(jsonfile);
+	}
+
+	for (int i = 0; i < queue_depth; i++)
+		free(thread_args[i].rbuf);
+	free(replay.buf);
+	free(replay.records);
+	exit(0);
+
+	fail:
+	printf("# FAILURE\n");
+	exit(1);
+}
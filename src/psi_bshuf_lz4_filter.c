@@ -0,0 +1,655 @@
+/*
+ * psi_bshuf_lz4_filter.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * bitshuffle + LZ4 codec and HDF5 filter.
+ *
+ * The data is cut into blocks, the bits of each block are transposed (all bit 0
+ * of the elements first, then all bit 1, ...) and the block is compressed with
+ * LZ4. Stream layout, all integers big endian:
+ *
+ *   uint64 uncompressed size [Byte]
+ *   uint32 block size [Byte]
+ *   per block: uint32 compressed size, LZ4 block data
+ *
+ * The bit transposition of complete groups of 8 elements uses SSE2 or AVX2 if
+ * the cpu has it, the byte transposition for multi byte types and leftover
+ * bytes at the end of a block are done in scalar code. The layout is similar
+ * to the bitshuffle filter but not compatible with it, the filter has its own
+ * id.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "hdf5.h"
+#include "psi_bshuf_lz4_filter.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "psi_bshuf_lz4_filter.c assumes a little endian machine"
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
+
+enum { DEFAULT_BLOCK_BYTES=8192, HASH_LOG=12, MIN_MATCH=4, LAST_LITERALS=5, MF_LIMIT=12, MAX_OFFSET=65535 };
+
+static int bshuf_impl = PSI_BSHUF_IMPL_AUTO;
+
+static const char *impl_names[] = { "auto", "scalar", "sse2", "avx2" };
+
+
+// byte order helpers
+// ------------------
+
+static void
+write_u32_be(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16); p[2] = (uint8_t)(v >> 8); p[3] = (uint8_t) v;
+}
+
+static uint32_t
+read_u32_be(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static void
+write_u64_be(uint8_t *p, uint64_t v)
+{
+	write_u32_be(p, (uint32_t)(v >> 32));
+	write_u32_be(p + 4, (uint32_t) v);
+}
+
+static uint64_t
+read_u64_be(const uint8_t *p)
+{
+	return ((uint64_t) read_u32_be(p) << 32) | read_u32_be(p + 4);
+}
+
+static uint32_t
+read_u32(const uint8_t *p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static uint64_t
+read_u64(const uint8_t *p)
+{
+	uint64_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+
+// bit transposition
+// -----------------
+// a plane is the byte b of m consecutive elements (m multiple of 8). It is
+// transposed into 8 rows of m/8 bytes, row k holds bit k of all elements,
+// element j in bit j%8 of byte j/8.
+
+// transpose the 8x8 bit matrix held in x (byte i = row i), self inverse
+static uint64_t
+transpose8x8(uint64_t x)
+{
+	uint64_t t;
+	t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+	x = x ^ t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+	x = x ^ t ^ (t << 14);
+	t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+	x = x ^ t ^ (t << 28);
+	return x;
+}
+
+static void
+bitshuffle_plane_scalar(const uint8_t *in, uint8_t *out, size_t m, size_t j0)
+{
+	size_t row = m/8;
+	for (size_t j = j0; j < m; j += 8) {
+		uint64_t x;
+		memcpy(&x, in + j, 8);
+		x = transpose8x8(x);
+		for (int k = 0; k < 8; k++) {
+			out[k*row + j/8] = (uint8_t)(x >> (8*k));
+		}
+	}
+}
+
+static void
+bitunshuffle_plane_scalar(const uint8_t *in, uint8_t *out, size_t m, size_t j0)
+{
+	size_t row = m/8;
+	for (size_t j = j0; j < m; j += 8) {
+		uint64_t x = 0;
+		for (int k = 0; k < 8; k++) {
+			x |= (uint64_t) in[k*row + j/8] << (8*k);
+		}
+		x = transpose8x8(x);
+		memcpy(out + j, &x, 8);
+	}
+}
+
+#ifdef HAVE_X86_SIMD
+
+// movemask collects bit 7 of each byte, adding the vector to itself shifts
+// every byte left by one, so bit k is collected in step 7-k
+__attribute__((target("sse2")))
+static size_t
+bitshuffle_plane_sse2(const uint8_t *in, uint8_t *out, size_t m)
+{
+	size_t row = m/8;
+	size_t j;
+	for (j = 0; j + 16 <= m; j += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(in + j));
+		for (int k = 7; k >= 0; k--) {
+			uint16_t bits = (uint16_t) _mm_movemask_epi8(v);
+			memcpy(out + k*row + j/8, &bits, 2);
+			v = _mm_add_epi8(v, v);
+		}
+	}
+	return j;
+}
+
+// gather byte h of every row into byte 8*h+k, then bit t of all gathered
+// bytes is element 8*h+t
+__attribute__((target("sse2")))
+static size_t
+bitunshuffle_plane_sse2(const uint8_t *in, uint8_t *out, size_t m)
+{
+	size_t row = m/8;
+	size_t j;
+	for (j = 0; j + 16 <= m; j += 16) {
+		const uint8_t *p = in + j/8;
+		__m128i v = _mm_setr_epi8(
+				p[0], p[row], p[2*row], p[3*row], p[4*row], p[5*row], p[6*row], p[7*row],
+				p[1], p[row+1], p[2*row+1], p[3*row+1], p[4*row+1], p[5*row+1], p[6*row+1], p[7*row+1]);
+		for (int t = 7; t >= 0; t--) {
+			int bits = _mm_movemask_epi8(v);
+			out[j + t] = (uint8_t) bits;
+			out[j + 8 + t] = (uint8_t)(bits >> 8);
+			v = _mm_add_epi8(v, v);
+		}
+	}
+	return j;
+}
+
+__attribute__((target("avx2")))
+static size_t
+bitshuffle_plane_avx2(const uint8_t *in, uint8_t *out, size_t m)
+{
+	size_t row = m/8;
+	size_t j;
+	for (j = 0; j + 32 <= m; j += 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)(in + j));
+		for (int k = 7; k >= 0; k--) {
+			uint32_t bits = (uint32_t) _mm256_movemask_epi8(v);
+			memcpy(out + k*row + j/8, &bits, 4);
+			v = _mm256_add_epi8(v, v);
+		}
+	}
+	return j;
+}
+
+__attribute__((target("avx2")))
+static size_t
+bitunshuffle_plane_avx2(const uint8_t *in, uint8_t *out, size_t m)
+{
+	size_t row = m/8;
+	size_t j;
+	for (j = 0; j + 32 <= m; j += 32) {
+		const uint8_t *p = in + j/8;
+		__m256i v = _mm256_setr_epi8(
+				p[0], p[row], p[2*row], p[3*row], p[4*row], p[5*row], p[6*row], p[7*row],
+				p[1], p[row+1], p[2*row+1], p[3*row+1], p[4*row+1], p[5*row+1], p[6*row+1], p[7*row+1],
+				p[2], p[row+2], p[2*row+2], p[3*row+2], p[4*row+2], p[5*row+2], p[6*row+2], p[7*row+2],
+				p[3], p[row+3], p[2*row+3], p[3*row+3], p[4*row+3], p[5*row+3], p[6*row+3], p[7*row+3]);
+		for (int t = 7; t >= 0; t--) {
+			uint32_t bits = (uint32_t) _mm256_movemask_epi8(v);
+			out[j + t] = (uint8_t) bits;
+			out[j + 8 + t] = (uint8_t)(bits >> 8);
+			out[j + 16 + t] = (uint8_t)(bits >> 16);
+			out[j + 24 + t] = (uint8_t)(bits >> 24);
+			v = _mm256_add_epi8(v, v);
+		}
+	}
+	return j;
+}
+
+#endif /* HAVE_X86_SIMD */
+
+static int
+resolve_impl(void)
+{
+	if (bshuf_impl != PSI_BSHUF_IMPL_AUTO) return bshuf_impl;
+#ifdef HAVE_X86_SIMD
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) return PSI_BSHUF_IMPL_AVX2;
+	if (__builtin_cpu_supports("sse2")) return PSI_BSHUF_IMPL_SSE2;
+#endif
+	return PSI_BSHUF_IMPL_SCALAR;
+}
+
+static void
+bitshuffle_plane(const uint8_t *in, uint8_t *out, size_t m, int impl)
+{
+	size_t done = 0;
+#ifdef HAVE_X86_SIMD
+	if (impl == PSI_BSHUF_IMPL_AVX2) done = bitshuffle_plane_avx2(in, out, m);
+	else if (impl == PSI_BSHUF_IMPL_SSE2) done = bitshuffle_plane_sse2(in, out, m);
+#endif
+	bitshuffle_plane_scalar(in, out, m, done);
+}
+
+static void
+bitunshuffle_plane(const uint8_t *in, uint8_t *out, size_t m, int impl)
+{
+	size_t done = 0;
+#ifdef HAVE_X86_SIMD
+	if (impl == PSI_BSHUF_IMPL_AVX2) done = bitunshuffle_plane_avx2(in, out, m);
+	else if (impl == PSI_BSHUF_IMPL_SSE2) done = bitunshuffle_plane_sse2(in, out, m);
+#endif
+	bitunshuffle_plane_scalar(in, out, m, done);
+}
+
+// transpose nbytes of elements into out, tmp has nbytes space.
+// Only complete groups of 8 elements are transposed, the rest is copied.
+static void
+bitshuffle(const uint8_t *in, uint8_t *out, uint8_t *tmp, size_t nbytes, size_t elem_size, int impl)
+{
+	size_t m = nbytes/elem_size & ~(size_t)7;
+	size_t shuffled = m*elem_size;
+
+	if (elem_size == 1) {
+		bitshuffle_plane(in, out, m, impl);
+	} else {
+		for (size_t j = 0; j < m; j++) {
+			for (size_t b = 0; b < elem_size; b++) {
+				tmp[b*m + j] = in[j*elem_size + b];
+			}
+		}
+		for (size_t b = 0; b < elem_size; b++) {
+			bitshuffle_plane(tmp + b*m, out + b*m, m, impl);
+		}
+	}
+	memcpy(out + shuffled, in + shuffled, nbytes - shuffled);
+}
+
+static void
+bitunshuffle(const uint8_t *in, uint8_t *out, uint8_t *tmp, size_t nbytes, size_t elem_size, int impl)
+{
+	size_t m = nbytes/elem_size & ~(size_t)7;
+	size_t shuffled = m*elem_size;
+
+	if (elem_size == 1) {
+		bitunshuffle_plane(in, out, m, impl);
+	} else {
+		for (size_t b = 0; b < elem_size; b++) {
+			bitunshuffle_plane(in + b*m, tmp + b*m, m, impl);
+		}
+		for (size_t j = 0; j < m; j++) {
+			for (size_t b = 0; b < elem_size; b++) {
+				out[j*elem_size + b] = tmp[b*m + j];
+			}
+		}
+	}
+	memcpy(out + shuffled, in + shuffled, nbytes - shuffled);
+}
+
+
+// LZ4 block format
+// ----------------
+
+static size_t
+lz4_bound(size_t n)
+{
+	return n + n/255 + 16;
+}
+
+static uint8_t *
+lz4_write_length(uint8_t *op, size_t len)
+{
+	while (len >= 255) {
+		*op++ = 255;
+		len -= 255;
+	}
+	*op++ = (uint8_t) len;
+	return op;
+}
+
+static uint8_t *
+lz4_write_sequence(uint8_t *op, const uint8_t *literals, size_t nlit, size_t offset, size_t match_len)
+{
+	uint8_t *token = op++;
+	*token = (uint8_t)((nlit >= 15 ? 15 : nlit) << 4);
+	if (nlit >= 15) op = lz4_write_length(op, nlit - 15);
+	memcpy(op, literals, nlit);
+	op += nlit;
+	if (match_len == 0) return op;   // last sequence
+
+	*op++ = (uint8_t) offset;
+	*op++ = (uint8_t)(offset >> 8);
+	match_len -= MIN_MATCH;
+	*token |= (uint8_t)(match_len >= 15 ? 15 : match_len);
+	if (match_len >= 15) op = lz4_write_length(op, match_len - 15);
+	return op;
+}
+
+// the hash table holds positions relative to src and is not cleared between
+// blocks, stale entries fail the byte comparison
+static size_t
+lz4_compress(const uint8_t *src, size_t n, uint8_t *dst, uint32_t *table)
+{
+	uint8_t *op = dst;
+	size_t ip = 0;
+	size_t anchor = 0;
+
+	if (n > MF_LIMIT) {
+		size_t mflimit = n - MF_LIMIT;
+		size_t matchlimit = n - LAST_LITERALS;
+		unsigned misses = 0;
+
+		while (ip < mflimit) {
+			uint32_t seq = read_u32(src + ip);
+			uint32_t h = (seq * 2654435761U) >> (32 - HASH_LOG);
+			size_t ref = table[h];
+			table[h] = (uint32_t) ip;
+
+			if (ref >= ip || ip - ref > MAX_OFFSET || read_u32(src + ref) != seq) {
+				ip += 1 + (misses++ >> 6);
+				continue;
+			}
+			misses = 0;
+
+			while (ip > anchor && ref > 0 && src[ip-1] == src[ref-1]) {
+				ip--;
+				ref--;
+			}
+			// extend the match 8 bytes at a time, the first differing byte
+			// is the lowest set byte of the xor on little endian machines
+			size_t len = MIN_MATCH;
+			while (ip + len + 8 <= matchlimit) {
+				uint64_t diff = read_u64(src + ip + len) ^ read_u64(src + ref + len);
+				if (diff != 0) {
+					len += __builtin_ctzll(diff) >> 3;
+					goto match_found;
+				}
+				len += 8;
+			}
+			while (ip + len < matchlimit && src[ref + len] == src[ip + len]) len++;
+			match_found:
+
+			op = lz4_write_sequence(op, src + anchor, ip - anchor, ip - ref, len);
+			ip += len;
+			anchor = ip;
+		}
+	}
+	op = lz4_write_sequence(op, src + anchor, n - anchor, 0, 0);
+	return op - dst;
+}
+
+// returns the number of bytes written to dst or 0 on corrupt input
+static size_t
+lz4_decompress(const uint8_t *src, size_t n, uint8_t *dst, size_t dst_size)
+{
+	const uint8_t *ip = src;
+	const uint8_t *iend = src + n;
+	uint8_t *op = dst;
+	uint8_t *oend = dst + dst_size;
+
+	while (ip < iend) {
+		unsigned token = *ip++;
+		size_t nlit = token >> 4;
+		if (nlit == 15) {
+			unsigned b;
+			do {
+				if (ip >= iend) return 0;
+				b = *ip++;
+				nlit += b;
+			} while (b == 255);
+		}
+		if ((size_t)(iend - ip) < nlit || (size_t)(oend - op) < nlit) return 0;
+		memcpy(op, ip, nlit);
+		ip += nlit;
+		op += nlit;
+		if (ip == iend) break;   // last sequence has no match
+
+		if (iend - ip < 2) return 0;
+		size_t offset = ip[0] | ((size_t) ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > (size_t)(op - dst)) return 0;
+
+		size_t len = token & 15;
+		if (len == 15) {
+			unsigned b;
+			do {
+				if (ip >= iend) return 0;
+				b = *ip++;
+				len += b;
+			} while (b == 255);
+		}
+		len += MIN_MATCH;
+		if ((size_t)(oend - op) < len) return 0;
+
+		// overlapping copy: the region in front of op repeats with period
+		// offset, copy from as far back as a multiple of the period allows
+		size_t done = 0;
+		while (done < len) {
+			size_t span = (done + offset)/offset*offset;
+			size_t count = len - done < span ? len - done : span;
+			memcpy(op + done, op + done - span, count);
+			done += count;
+		}
+		op += len;
+	}
+	return op - dst;
+}
+
+
+// codec
+// -----
+
+static size_t
+block_bytes(size_t elem_size, size_t block_size)
+{
+	if (block_size == 0) {
+		block_size = DEFAULT_BLOCK_BYTES/elem_size;
+	}
+	block_size &= ~(size_t)7;
+	if (block_size < 8) block_size = 8;
+	return block_size*elem_size;
+}
+
+size_t
+psi_bshuf_lz4_bound(size_t nbytes, size_t elem_size, size_t block_size)
+{
+	size_t bsize = block_bytes(elem_size, block_size);
+	size_t nblocks = (nbytes + bsize - 1)/bsize;
+	return PSI_BSHUF_LZ4_HEADER_SIZE + nblocks*(4 + lz4_bound(bsize));
+}
+
+size_t
+psi_bshuf_lz4_compress(const void *in, size_t nbytes, size_t elem_size, size_t block_size,
+		void *out, size_t out_size)
+{
+	const uint8_t *src = in;
+	uint8_t *dst = out;
+	size_t bsize, pos;
+	uint8_t *shuffled = NULL, *tmp = NULL;
+	uint32_t *table = NULL;
+	int impl = resolve_impl();
+
+	if (elem_size == 0) return 0;
+	bsize = block_bytes(elem_size, block_size);
+	if (out_size < psi_bshuf_lz4_bound(nbytes, elem_size, block_size)) return 0;
+
+	shuffled = malloc(bsize);
+	tmp = malloc(bsize);
+	table = calloc((size_t)1 << HASH_LOG, sizeof(uint32_t));
+	if (shuffled == NULL || tmp == NULL || table == NULL) {
+		pos = 0;
+		goto done;
+	}
+
+	write_u64_be(dst, nbytes);
+	write_u32_be(dst + 8, (uint32_t) bsize);
+	pos = PSI_BSHUF_LZ4_HEADER_SIZE;
+
+	for (size_t offset = 0; offset < nbytes; offset += bsize) {
+		size_t n = nbytes - offset < bsize ? nbytes - offset : bsize;
+		bitshuffle(src + offset, shuffled, tmp, n, elem_size, impl);
+		size_t c = lz4_compress(shuffled, n, dst + pos + 4, table);
+		write_u32_be(dst + pos, (uint32_t) c);
+		pos += 4 + c;
+	}
+
+	done:
+	free(shuffled);
+	free(tmp);
+	free(table);
+	return pos;
+}
+
+size_t
+psi_bshuf_lz4_decompressed_size(const void *in, size_t in_size)
+{
+	if (in_size < PSI_BSHUF_LZ4_HEADER_SIZE) return 0;
+	return (size_t) read_u64_be(in);
+}
+
+size_t
+psi_bshuf_lz4_decompress(const void *in, size_t in_size, size_t elem_size,
+		void *out, size_t out_size)
+{
+	const uint8_t *src = in;
+	uint8_t *dst = out;
+	size_t nbytes, bsize, pos, offset;
+	uint8_t *shuffled = NULL, *tmp = NULL;
+	int impl = resolve_impl();
+
+	if (in_size < PSI_BSHUF_LZ4_HEADER_SIZE || elem_size == 0) return 0;
+	nbytes = (size_t) read_u64_be(src);
+	bsize = read_u32_be(src + 8);
+	if (nbytes > out_size || bsize == 0 || bsize % elem_size != 0) return 0;
+
+	shuffled = malloc(bsize);
+	tmp = malloc(bsize);
+	if (shuffled == NULL || tmp == NULL) {
+		offset = 0;
+		goto done;
+	}
+
+	pos = PSI_BSHUF_LZ4_HEADER_SIZE;
+	for (offset = 0; offset < nbytes; offset += bsize) {
+		size_t n = nbytes - offset < bsize ? nbytes - offset : bsize;
+		if (in_size - pos < 4) break;
+		size_t c = read_u32_be(src + pos);
+		pos += 4;
+		if (in_size - pos < c) break;
+		if (lz4_decompress(src + pos, c, shuffled, n) != n) break;
+		bitunshuffle(shuffled, dst + offset, tmp, n, elem_size, impl);
+		pos += c;
+	}
+
+	done:
+	free(shuffled);
+	free(tmp);
+	return offset >= nbytes ? nbytes : 0;
+}
+
+int
+set_psi_bshuf_impl(int impl)
+{
+	if (impl < PSI_BSHUF_IMPL_AUTO || impl > PSI_BSHUF_IMPL_AVX2) return -1;
+#ifdef HAVE_X86_SIMD
+	__builtin_cpu_init();
+	if (impl == PSI_BSHUF_IMPL_AVX2 && !__builtin_cpu_supports("avx2")) return -1;
+	if (impl == PSI_BSHUF_IMPL_SSE2 && !__builtin_cpu_supports("sse2")) return -1;
+#else
+	if (impl == PSI_BSHUF_IMPL_AVX2 || impl == PSI_BSHUF_IMPL_SSE2) return -1;
+#endif
+	bshuf_impl = impl;
+	return 0;
+}
+
+const char *
+get_psi_bshuf_impl_name(void)
+{
+	return impl_names[resolve_impl()];
+}
+
+
+// HDF5 filter
+// -----------
+// cd_values[0] element size [Byte], set by set_local from the dataset type
+// cd_values[1] block size [elements], 0 for the default
+
+static herr_t
+psi_bshuf_lz4_set_local(hid_t dcpl, hid_t type, hid_t space)
+{
+	unsigned int flags;
+	size_t nelmts = 2;
+	unsigned int values[2] = {0, 0};
+	size_t type_size;
+
+	if (H5Pget_filter_by_id2(dcpl, PSI_BSHUF_LZ4_FILTER, &flags, &nelmts, values, 0, NULL, NULL) < 0) return -1;
+	type_size = H5Tget_size(type);
+	if (type_size == 0) return -1;
+	if (nelmts < 2) values[1] = 0;
+	values[0] = (unsigned int) type_size;
+	return H5Pmodify_filter(dcpl, PSI_BSHUF_LZ4_FILTER, flags, 2, values);
+}
+
+static size_t
+psi_bshuf_lz4_filter(unsigned int flags, size_t cd_nelmts, const unsigned int cd_values[], size_t nbytes, size_t *buf_size, void **buf)
+{
+	size_t elem_size = cd_nelmts > 0 ? cd_values[0] : 1;
+	size_t block_size = cd_nelmts > 1 ? cd_values[1] : 0;
+	size_t out_size, n;
+	void *out;
+
+	if (flags & H5Z_FLAG_REVERSE) {  // incoming data, decompress
+		out_size = psi_bshuf_lz4_decompressed_size(*buf, nbytes);
+		out = malloc(out_size);
+		if (out == NULL) return 0;
+		n = psi_bshuf_lz4_decompress(*buf, nbytes, elem_size, out, out_size);
+	} else {  // outgoing data, compress
+		out_size = psi_bshuf_lz4_bound(nbytes, elem_size, block_size);
+		out = malloc(out_size);
+		if (out == NULL) return 0;
+		n = psi_bshuf_lz4_compress(*buf, nbytes, elem_size, block_size, out, out_size);
+	}
+	if (n == 0) {
+		free(out);
+		return 0;
+	}
+	free(*buf);
+	*buf = out;
+	*buf_size = out_size;
+	return n;
+}
+
+static H5Z_class2_t psi_bshuf_lz4_filter_definition =
+{
+	    H5Z_CLASS_T_VERS,       /* H5Z_class_t version */
+	    PSI_BSHUF_LZ4_FILTER,         /* Filter id number             */
+	    1,              /* encoder_present flag (set to true) */
+	    1,              /* decoder_present flag (set to true) */
+	    "psi_bshuf_lz4_filter",                  /* Filter name for debugging    */
+	    NULL,                       /* The "can apply" callback     */
+	    psi_bshuf_lz4_set_local,    /* The "set local" callback     */
+	    psi_bshuf_lz4_filter,         /* The actual filter function   */
+};
+
+herr_t
+register_psi_bshuf_lz4_filter(void) {
+    herr_t status = H5Zregister(&psi_bshuf_lz4_filter_definition);
+    return(status);
+}
@@ -0,0 +1,51 @@
+/*
+ * psi_bshuf_lz4_filter.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_BSHUF_LZ4_FILTER_H_
+#define PSI_BSHUF_LZ4_FILTER_H_
+
+#include <stddef.h>
+#include "hdf5.h"
+
+#define PSI_BSHUF_LZ4_FILTER  401
+
+// size of the header in front of the compressed blocks
+#define PSI_BSHUF_LZ4_HEADER_SIZE  12
+
+// implementations of the bit transposition
+#define PSI_BSHUF_IMPL_AUTO    0
+#define PSI_BSHUF_IMPL_SCALAR  1
+#define PSI_BSHUF_IMPL_SSE2    2
+#define PSI_BSHUF_IMPL_AVX2    3
+
+herr_t
+register_psi_bshuf_lz4_filter(void);
+
+// standalone codec, e.g. to compress chunks for H5DOwrite_chunk().
+// block_size is in elements, 0 selects the default.
+size_t
+psi_bshuf_lz4_bound(size_t nbytes, size_t elem_size, size_t block_size);
+
+size_t
+psi_bshuf_lz4_compress(const void *in, size_t nbytes, size_t elem_size, size_t block_size,
+		void *out, size_t out_size);
+
+size_t
+psi_bshuf_lz4_decompressed_size(const void *in, size_t in_size);
+
+size_t
+psi_bshuf_lz4_decompress(const void *in, size_t in_size, size_t elem_size,
+		void *out, size_t out_size);
+
+// select the bit transposition, returns -1 if not supported by the cpu
+int
+set_psi_bshuf_impl(int impl);
+
+const char *
+get_psi_bshuf_impl_name(void);
+
+#endif /* PSI_BSHUF_LZ4_FILTER_H_ */
@@ -0,0 +1,170 @@
+/*
+ * psi_buffer_pool.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * chunk buffers backed by normal or huge pages. The mmap() based buffers
+ * are aligned to the huge page size, otherwise the kernel can't use huge
+ * pages for the first and last part of the buffer. With prefault every
+ * page is touched right away, so the page faults don't show up in the
+ * timed sections.
+ */
+
+#define _GNU_SOURCE   /* MAP_ANONYMOUS, MAP_HUGETLB, MADV_HUGEPAGE */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include "psi_buffer_pool.h"
+#include "psi_numa.h"
+
+static int pool_mode = PSI_BUFFER_MALLOC;
+static int pool_prefault = 0;
+static long long hugetlb_bytes = 0;
+static int pool_node = -1;
+
+static const char *mode_names[] = { "malloc", "thp", "hugetlb" };
+
+int
+init_psi_buffer_pool(int mode, int prefault)
+{
+	if (mode < PSI_BUFFER_MALLOC || mode > PSI_BUFFER_HUGETLB) return -1;
+	pool_mode = mode;
+	pool_prefault = prefault;
+	return 0;
+}
+
+int
+psi_buffer_mode_from_name(const char *name)
+{
+	for (int i = 0; i < (int)(sizeof(mode_names)/sizeof(mode_names[0])); i++)
+		if (strcmp(name, mode_names[i]) == 0) return i;
+	return -1;
+}
+
+const char *
+get_psi_buffer_mode_name(void)
+{
+	return mode_names[pool_mode];
+}
+
+void
+set_psi_buffer_pool_node(int node)
+{
+	pool_node = node;
+}
+
+// mmap() size bytes aligned to a huge page
+static void *
+map_aligned(size_t size, int flags)
+{
+	size_t len = size + PSI_HUGE_PAGE_SIZE;
+	char *p = mmap(NULL, len, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|flags, -1, 0);
+	if (p == MAP_FAILED) return NULL;
+
+	char *aligned = (char *)(((uintptr_t)p + PSI_HUGE_PAGE_SIZE - 1) & ~((uintptr_t)PSI_HUGE_PAGE_SIZE - 1));
+	if (aligned > p) munmap(p, aligned - p);
+	if (p + len > aligned + size) munmap(aligned + size, p + len - (aligned + size));
+	return aligned;
+}
+
+void *
+get_psi_buffer(size_t size)
+{
+	size_t rounded = (size + PSI_HUGE_PAGE_SIZE - 1) / PSI_HUGE_PAGE_SIZE * PSI_HUGE_PAGE_SIZE;
+	char *buf = NULL;
+
+	if (size == 0) size = rounded = PSI_HUGE_PAGE_SIZE;
+
+	switch (pool_mode) {
+	case PSI_BUFFER_MALLOC:
+		if (pool_node < 0) {
+			buf = malloc(size);
+		} else {  // mbind() works on whole pages, don't share them with other data
+			long page = sysconf(_SC_PAGESIZE);
+			size_t len = (size + page - 1) / page * page;
+			if (posix_memalign((void **) &buf, page, len) != 0) buf = NULL;
+			if (buf != NULL && bind_psi_numa_memory(buf, len, pool_node) != 0)
+				perror("mbind failed, buffer is not bound to the NUMA node");
+		}
+		break;
+	case PSI_BUFFER_THP:
+		buf = map_aligned(rounded, 0);
+		if (buf != NULL && pool_node >= 0 && bind_psi_numa_memory(buf, rounded, pool_node) != 0)
+			perror("mbind failed, buffer is not bound to the NUMA node");
+		if (buf != NULL && madvise(buf, rounded, MADV_HUGEPAGE) != 0)
+			perror("madvise(MADV_HUGEPAGE) failed, continue with normal pages");
+		break;
+	case PSI_BUFFER_HUGETLB:
+		// hugetlb mappings are aligned by the kernel
+		buf = mmap(NULL, rounded, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+		if (buf == MAP_FAILED) {
+			perror("mmap(MAP_HUGETLB) failed, are huge pages reserved in /proc/sys/vm/nr_hugepages?");
+			buf = NULL;
+		} else {
+			hugetlb_bytes += rounded;
+			if (pool_node >= 0 && bind_psi_numa_memory(buf, rounded, pool_node) != 0)
+				perror("mbind failed, buffer is not bound to the NUMA node");
+		}
+		break;
+	}
+	if (buf != NULL && pool_prefault) {
+		for (size_t i = 0; i < size; i += 4096)
+			buf[i] = 0;
+	}
+	return buf;
+}
+
+void
+free_psi_buffer(void *buf, size_t size)
+{
+	size_t rounded = (size + PSI_HUGE_PAGE_SIZE - 1) / PSI_HUGE_PAGE_SIZE * PSI_HUGE_PAGE_SIZE;
+
+	if (buf == NULL) return;
+	if (size == 0) rounded = PSI_HUGE_PAGE_SIZE;
+	switch (pool_mode) {
+	case PSI_BUFFER_MALLOC:
+		free(buf);
+		break;
+	case PSI_BUFFER_THP:
+		munmap(buf, rounded);
+		break;
+	case PSI_BUFFER_HUGETLB:
+		munmap(buf, rounded);
+		hugetlb_bytes -= rounded;
+		break;
+	}
+}
+
+long long
+get_psi_page_faults(void)
+{
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+	return (long long) usage.ru_minflt + usage.ru_majflt;
+}
+
+long long
+get_psi_huge_bytes(void)
+{
+	char line[256];
+	long long kib, total = -1;
+	FILE *f = fopen("/proc/self/smaps_rollup", "r");
+
+	if (f != NULL) {
+		while (fgets(line, sizeof(line), f) != NULL) {
+			if (sscanf(line, "AnonHugePages: %lld kB", &kib) == 1) {
+				total = kib * 1024;
+				break;
+			}
+		}
+		fclose(f);
+	}
+	if (total < 0) return hugetlb_bytes > 0 ? hugetlb_bytes : -1;
+	return total + hugetlb_bytes;
+}
@@ -0,0 +1,51 @@
+/*
+ * psi_buffer_pool.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_BUFFER_POOL_H_
+#define PSI_BUFFER_POOL_H_
+
+#include <stddef.h>
+
+// backing of the chunk buffers
+#define PSI_BUFFER_MALLOC   0   // plain malloc()
+#define PSI_BUFFER_THP      1   // mmap() with madvise(MADV_HUGEPAGE), transparent hugepages
+#define PSI_BUFFER_HUGETLB  2   // mmap() with MAP_HUGETLB, needs reserved pages in /proc/sys/vm/nr_hugepages
+
+#define PSI_HUGE_PAGE_SIZE  (2*1024*1024)
+
+// returns -1 for an unknown mode
+int
+init_psi_buffer_pool(int mode, int prefault);
+
+int
+psi_buffer_mode_from_name(const char *name);
+
+const char *
+get_psi_buffer_mode_name(void);
+
+// bind all further buffers to a NUMA node, -1 for no binding
+void
+set_psi_buffer_pool_node(int node);
+
+// NULL on failure
+void *
+get_psi_buffer(size_t size);
+
+// give back a buffer of get_psi_buffer(), size as it was requested
+void
+free_psi_buffer(void *buf, size_t size);
+
+// minor plus major page faults of the process so far
+long long
+get_psi_page_faults(void);
+
+// anonymous memory backed by transparent hugepages plus the hugetlb
+// buffers of the pool, in bytes
+long long
+get_psi_huge_bytes(void);
+
+#endif /* PSI_BUFFER_POOL_H_ */
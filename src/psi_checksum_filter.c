@@ -0,0 +1,314 @@
+/*
+ * psi_checksum_filter.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * CRC32C checksum filter, the counterpart of the Fletcher32 filter of HDF5:
+ * the forward direction appends the checksum of the chunk, the reverse
+ * direction checks and removes it. The CRC32C instructions of SSE4.2 and
+ * ARMv8 are used if the cpu has them, otherwise a table driven software
+ * version. psi_fletcher32() computes the same checksum as HDF5 does, so
+ * direct writes can store chunks that pass H5Pset_fletcher32() checks.
+ * Both trailers are little endian.
+ */
+
+#define _GNU_SOURCE   /* getauxval */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "hdf5.h"
+#include "psi_checksum_filter.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_CRC32C 1
+#elif defined(__aarch64__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#define HAVE_ARM_CRC32C 1
+#endif
+
+// reflected Castagnoli polynomial
+#define CRC32C_POLY  0x82f63b78u
+
+#define IMPL_SOFTWARE  0
+#define IMPL_SSE42     1
+#define IMPL_ARMV8     2
+
+static const char *impl_names[] = { "software", "sse4.2", "armv8" };
+static const char *checksum_names[] = { "none", "fletcher32", "crc32c" };
+
+static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+static int crc32c_impl = IMPL_SOFTWARE;
+static uint32_t crc32c_table[8][256];    // slicing by 8
+
+static void
+init_crc32c(void)
+{
+	for (int i = 0; i < 256; i++) {
+		uint32_t c = i;
+		for (int k = 0; k < 8; k++)
+			c = c & 1 ? (c >> 1) ^ CRC32C_POLY : c >> 1;
+		crc32c_table[0][i] = c;
+	}
+	for (int i = 0; i < 256; i++)
+		for (int t = 1; t < 8; t++)
+			crc32c_table[t][i] = (crc32c_table[t-1][i] >> 8) ^ crc32c_table[0][crc32c_table[t-1][i] & 0xff];
+
+#if defined(HAVE_X86_CRC32C)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse4.2")) crc32c_impl = IMPL_SSE42;
+#elif defined(HAVE_ARM_CRC32C)
+	if (getauxval(AT_HWCAP) & HWCAP_CRC32) crc32c_impl = IMPL_ARMV8;
+#endif
+}
+
+static uint32_t
+crc32c_software(uint32_t crc, const uint8_t *p, size_t n)
+{
+	while (n > 0 && ((uintptr_t) p & 7)) {
+		crc = (crc >> 8) ^ crc32c_table[0][(crc ^ *p++) & 0xff];
+		n--;
+	}
+	while (n >= 8) {
+		uint32_t lo, hi;
+		memcpy(&lo, p, 4);
+		memcpy(&hi, p + 4, 4);
+		lo ^= crc;
+		crc = crc32c_table[7][lo & 0xff] ^ crc32c_table[6][(lo >> 8) & 0xff]
+				^ crc32c_table[5][(lo >> 16) & 0xff] ^ crc32c_table[4][lo >> 24]
+				^ crc32c_table[3][hi & 0xff] ^ crc32c_table[2][(hi >> 8) & 0xff]
+				^ crc32c_table[1][(hi >> 16) & 0xff] ^ crc32c_table[0][hi >> 24];
+		p += 8;
+		n -= 8;
+	}
+	while (n > 0) {
+		crc = (crc >> 8) ^ crc32c_table[0][(crc ^ *p++) & 0xff];
+		n--;
+	}
+	return crc;
+}
+
+#ifdef HAVE_X86_CRC32C
+__attribute__((target("sse4.2")))
+static uint32_t
+crc32c_sse42(uint32_t crc, const uint8_t *p, size_t n)
+{
+	while (n > 0 && ((uintptr_t) p & 7)) {
+		crc = _mm_crc32_u8(crc, *p++);
+		n--;
+	}
+#ifdef __x86_64__
+	uint64_t c = crc;
+	for (; n >= 8; p += 8, n -= 8) {
+		uint64_t v;
+		memcpy(&v, p, 8);
+		c = _mm_crc32_u64(c, v);
+	}
+	crc = (uint32_t) c;
+#endif
+	for (; n >= 4; p += 4, n -= 4) {
+		uint32_t v;
+		memcpy(&v, p, 4);
+		crc = _mm_crc32_u32(crc, v);
+	}
+	while (n > 0) {
+		crc = _mm_crc32_u8(crc, *p++);
+		n--;
+	}
+	return crc;
+}
+#endif /* HAVE_X86_CRC32C */
+
+#ifdef HAVE_ARM_CRC32C
+__attribute__((target("+crc")))
+static uint32_t
+crc32c_armv8(uint32_t crc, const uint8_t *p, size_t n)
+{
+	while (n > 0 && ((uintptr_t) p & 7)) {
+		__asm__("crc32cb %w0, %w0, %w1" : "+r"(crc) : "r"((uint32_t) *p));
+		p++;
+		n--;
+	}
+	for (; n >= 8; p += 8, n -= 8) {
+		uint64_t v;
+		memcpy(&v, p, 8);
+		__asm__("crc32cx %w0, %w0, %x1" : "+r"(crc) : "r"(v));
+	}
+	while (n > 0) {
+		__asm__("crc32cb %w0, %w0, %w1" : "+r"(crc) : "r"((uint32_t) *p));
+		p++;
+		n--;
+	}
+	return crc;
+}
+#endif /* HAVE_ARM_CRC32C */
+
+uint32_t
+psi_crc32c(uint32_t crc, const void *buf, size_t size)
+{
+	const uint8_t *p = buf;
+
+	pthread_once(&init_once, init_crc32c);
+	crc = ~crc;
+#if defined(HAVE_X86_CRC32C)
+	if (crc32c_impl == IMPL_SSE42) return ~crc32c_sse42(crc, p, size);
+#elif defined(HAVE_ARM_CRC32C)
+	if (crc32c_impl == IMPL_ARMV8) return ~crc32c_armv8(crc, p, size);
+#endif
+	return ~crc32c_software(crc, p, size);
+}
+
+const char *
+get_psi_crc32c_impl_name(void)
+{
+	pthread_once(&init_once, init_crc32c);
+	return impl_names[crc32c_impl];
+}
+
+// H5_checksum_fletcher32() of HDF5: 16 bit words with the first byte as
+// high byte, sums folded before they can overflow
+uint32_t
+psi_fletcher32(const void *buf, size_t size)
+{
+	const uint8_t *data = buf;
+	size_t len = size / 2;
+	uint32_t sum1 = 0, sum2 = 0;
+
+	while (len > 0) {
+		size_t tlen = len > 360 ? 360 : len;
+		len -= tlen;
+		do {
+			sum1 += ((uint32_t) data[0] << 8) | data[1];
+			data += 2;
+			sum2 += sum1;
+		} while (--tlen);
+		sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+		sum2 = (sum2 & 0xffff) + (sum2 >> 16);
+	}
+	if (size % 2) {
+		sum1 += (uint32_t) data[0] << 8;
+		sum2 += sum1;
+		sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+		sum2 = (sum2 & 0xffff) + (sum2 >> 16);
+	}
+	sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+	sum2 = (sum2 & 0xffff) + (sum2 >> 16);
+	return (sum2 << 16) | sum1;
+}
+
+static void
+write_u32_le(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t) v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t
+read_u32_le(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+size_t
+psi_append_checksum(int kind, void *buf, size_t size)
+{
+	uint32_t sum;
+
+	switch (kind) {
+	case PSI_CHECKSUM_FLETCHER32:
+		sum = psi_fletcher32(buf, size);
+		break;
+	case PSI_CHECKSUM_CRC32C:
+		sum = psi_crc32c(0, buf, size);
+		break;
+	default:
+		return size;
+	}
+	write_u32_le((uint8_t *) buf + size, sum);
+	return size + PSI_CHECKSUM_SIZE;
+}
+
+int
+psi_check_checksum(int kind, const void *buf, size_t size)
+{
+	const uint8_t *p = buf;
+	uint32_t sum;
+
+	if (size < PSI_CHECKSUM_SIZE) return -1;
+	size -= PSI_CHECKSUM_SIZE;
+	switch (kind) {
+	case PSI_CHECKSUM_FLETCHER32:
+		sum = psi_fletcher32(p, size);
+		break;
+	case PSI_CHECKSUM_CRC32C:
+		sum = psi_crc32c(0, p, size);
+		break;
+	default:
+		return -1;
+	}
+	return sum == read_u32_le(p + size) ? 0 : -1;
+}
+
+int
+psi_checksum_from_name(const char *name)
+{
+	for (int i = PSI_CHECKSUM_NONE; i <= PSI_CHECKSUM_CRC32C; i++)
+		if (strcmp(name, checksum_names[i]) == 0) return i;
+	return -1;
+}
+
+const char *
+get_psi_checksum_name(int kind)
+{
+	if (kind < PSI_CHECKSUM_NONE || kind > PSI_CHECKSUM_CRC32C) return "unknown";
+	return checksum_names[kind];
+}
+
+
+// HDF5 filter
+// -----------
+
+static size_t
+psi_crc32c_filter(unsigned int flags, size_t cd_nelmts, const unsigned int cd_values[], size_t nbytes, size_t *buf_size, void **buf)
+{
+	uint8_t *p = *buf;
+
+	if (flags & H5Z_FLAG_REVERSE) {  // incoming data, check and drop the trailer
+		if (nbytes < PSI_CHECKSUM_SIZE) return 0;
+		if (!(flags & H5Z_FLAG_SKIP_EDC) && psi_check_checksum(PSI_CHECKSUM_CRC32C, p, nbytes) != 0) {
+			printf("ERROR: CRC32C checksum of chunk does not match\n");
+			return 0;
+		}
+		return nbytes - PSI_CHECKSUM_SIZE;
+	}
+
+	// outgoing data, the buffer usually has no room for the trailer
+	if (*buf_size < nbytes + PSI_CHECKSUM_SIZE) {
+		void *bigger = realloc(*buf, nbytes + PSI_CHECKSUM_SIZE);
+		if (bigger == NULL) return 0;
+		*buf = bigger;
+		*buf_size = nbytes + PSI_CHECKSUM_SIZE;
+	}
+	return psi_append_checksum(PSI_CHECKSUM_CRC32C, *buf, nbytes);
+}
+
+static H5Z_class2_t psi_crc32c_filter_definition =
+{
+	    H5Z_CLASS_T_VERS,       /* H5Z_class_t version */
+	    PSI_CRC32C_FILTER,         /* Filter id number             */
+	    1,              /* encoder_present flag (set to true) */
+	    1,              /* decoder_present flag (set to true) */
+	    "psi_crc32c_filter",                  /* Filter name for debugging    */
+	    NULL,                       /* The "can apply" callback     */
+	    NULL,                       /* The "set local" callback     */
+	    psi_crc32c_filter,         /* The actual filter function   */
+};
+
+herr_t
+register_psi_crc32c_filter(void) {
+    herr_t status = H5Zregister(&psi_crc32c_filter_definition);
+    return(status);
+}
@@ -0,0 +1,54 @@
+/*
+ * psi_checksum_filter.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_CHECKSUM_FILTER_H_
+#define PSI_CHECKSUM_FILTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "hdf5.h"
+
+#define PSI_CRC32C_FILTER  402
+
+// bytes both checksum filters append to a chunk
+#define PSI_CHECKSUM_SIZE  4
+
+#define PSI_CHECKSUM_NONE        0
+#define PSI_CHECKSUM_FLETCHER32  1   // the HDF5 filter, H5Pset_fletcher32()
+#define PSI_CHECKSUM_CRC32C      2   // PSI_CRC32C_FILTER
+
+herr_t
+register_psi_crc32c_filter(void);
+
+// CRC32C (Castagnoli) of size bytes, continuing crc; start with 0
+uint32_t
+psi_crc32c(uint32_t crc, const void *buf, size_t size);
+
+// the checksum of the HDF5 Fletcher32 filter
+uint32_t
+psi_fletcher32(const void *buf, size_t size);
+
+// append the trailer the filter would store, for H5DOwrite_chunk(). buf
+// needs room for size + PSI_CHECKSUM_SIZE bytes. Returns the new size.
+size_t
+psi_append_checksum(int kind, void *buf, size_t size);
+
+// check the trailer at the end of the size bytes, returns 0 if it matches
+int
+psi_check_checksum(int kind, const void *buf, size_t size);
+
+int
+psi_checksum_from_name(const char *name);
+
+const char *
+get_psi_checksum_name(int kind);
+
+// implementation of psi_crc32c(): sse4.2, armv8 or software
+const char *
+get_psi_crc32c_impl_name(void);
+
+#endif /* PSI_CHECKSUM_FILTER_H_ */
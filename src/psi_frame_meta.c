@@ -0,0 +1,174 @@
+/*
+ * psi_frame_meta.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * per-frame records (frame number, timestamp, status) in a compound
+ * dataset next to the image data, appended like a DAQ would do it:
+ * extend the dataset, select the new rows and write them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "hdf5.h"
+#include "psi_frame_meta.h"
+
+static double
+now(void)
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (double) tv.tv_sec + tv.tv_usec*1.e-6;
+}
+
+static hid_t
+record_type(void)
+{
+	hid_t type = H5Tcreate(H5T_COMPOUND, sizeof(psi_frame_record_t));
+	if (type < 0) return -1;
+	if (H5Tinsert(type, "frame", HOFFSET(psi_frame_record_t, frame), H5T_NATIVE_ULLONG) < 0
+			|| H5Tinsert(type, "timestamp", HOFFSET(psi_frame_record_t, timestamp), H5T_NATIVE_DOUBLE) < 0
+			|| H5Tinsert(type, "status", HOFFSET(psi_frame_record_t, status), H5T_NATIVE_UINT) < 0) {
+		H5Tclose(type);
+		return -1;
+	}
+	return type;
+}
+
+herr_t
+create_psi_frame_meta(hid_t file, const char *name)
+{
+	hsize_t dims[1] = {0}, maxdims[1] = {H5S_UNLIMITED}, chunk[1] = {PSI_FRAME_META_CHUNK};
+	hid_t type, space, dcpl, dset = -1;
+
+	type = record_type();
+	space = H5Screate_simple(1, dims, maxdims);
+	dcpl = H5Pcreate(H5P_DATASET_CREATE);
+	if (type >= 0 && space >= 0 && dcpl >= 0 && H5Pset_chunk(dcpl, 1, chunk) >= 0)
+		dset = H5Dcreate(file, name, type, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+
+	if (dcpl >= 0) H5Pclose(dcpl);
+	if (space >= 0) H5Sclose(space);
+	if (type >= 0) H5Tclose(type);
+	if (dset < 0) return -1;
+	return H5Dclose(dset);
+}
+
+herr_t
+open_psi_frame_meta(hid_t file, const char *name, int batch, psi_frame_meta_t *meta)
+{
+	memset(meta, 0, sizeof(*meta));
+	meta->dset = -1;
+	meta->type = -1;
+	if (batch <= 0) return -1;
+
+	meta->batch = batch;
+	meta->records = calloc(batch, sizeof(psi_frame_record_t));
+	meta->type = record_type();
+	meta->dset = H5Dopen(file, name, H5P_DEFAULT);
+	if (meta->records == NULL || meta->type < 0 || meta->dset < 0) {
+		close_psi_frame_meta(meta);
+		return -1;
+	}
+	return 0;
+}
+
+static herr_t
+append(psi_frame_meta_t *meta)
+{
+	hsize_t dims[1], start[1], count[1];
+	hid_t space = -1, memspace = -1;
+	herr_t ret = -1;
+	double t0 = now();
+
+	if (meta->nbuffered == 0) return 0;
+
+	dims[0] = meta->nwritten + meta->nbuffered;
+	start[0] = meta->nwritten;
+	count[0] = meta->nbuffered;
+	if (H5Dset_extent(meta->dset, dims) < 0) goto done;
+	space = H5Dget_space(meta->dset);
+	memspace = H5Screate_simple(1, count, NULL);
+	if (space < 0 || memspace < 0) goto done;
+	if (H5Sselect_hyperslab(space, H5S_SELECT_SET, start, NULL, count, NULL) < 0) goto done;
+	if (H5Dwrite(meta->dset, meta->type, memspace, space, H5P_DEFAULT, meta->records) < 0) goto done;
+
+	meta->nwritten += meta->nbuffered;
+	meta->nbuffered = 0;
+	meta->nappends++;
+	ret = 0;
+
+done:
+	if (memspace >= 0) H5Sclose(memspace);
+	if (space >= 0) H5Sclose(space);
+	meta->append_time += now() - t0;
+	return ret;
+}
+
+herr_t
+add_psi_frame_meta(psi_frame_meta_t *meta, unsigned long long frame, unsigned int status)
+{
+	psi_frame_record_t *r = &meta->records[meta->nbuffered++];
+	r->frame = frame;
+	r->timestamp = now();
+	r->status = status;
+	if (meta->nbuffered == meta->batch)
+		return append(meta);
+	return 0;
+}
+
+herr_t
+close_psi_frame_meta(psi_frame_meta_t *meta)
+{
+	herr_t ret = 0;
+
+	if (meta->dset >= 0) {
+		ret = append(meta);
+		if (H5Dclose(meta->dset) < 0) ret = -1;
+	}
+	if (meta->type >= 0) H5Tclose(meta->type);
+	free(meta->records);
+	meta->dset = -1;
+	meta->type = -1;
+	meta->records = NULL;
+	return ret;
+}
+
+int
+verify_psi_frame_meta(hid_t file, const char *name, long long nframes)
+{
+	hsize_t dims[1];
+	hid_t dset, space = -1, type = -1;
+	psi_frame_record_t *records = NULL;
+	int ret = -1;
+
+	dset = H5Dopen(file, name, H5P_DEFAULT);
+	if (dset < 0) return -1;
+	space = H5Dget_space(dset);
+	type = record_type();
+	if (space < 0 || type < 0 || H5Sget_simple_extent_dims(space, dims, NULL) != 1) goto done;
+	if ((long long) dims[0] != nframes) {
+		printf("ERROR: frame metadata has %lli records instead of %lli\n", (long long) dims[0], nframes);
+		goto done;
+	}
+	records = malloc(nframes*sizeof(psi_frame_record_t) + 1);
+	if (records == NULL) goto done;
+	if (H5Dread(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, records) < 0) goto done;
+	for (long long i = 0; i < nframes; i++) {
+		if (records[i].frame != (unsigned long long) i) {
+			printf("ERROR: frame metadata record %lli has frame number %llu\n", i, records[i].frame);
+			goto done;
+		}
+	}
+	ret = 0;
+
+done:
+	free(records);
+	if (type >= 0) H5Tclose(type);
+	if (space >= 0) H5Sclose(space);
+	H5Dclose(dset);
+	return ret;
+}
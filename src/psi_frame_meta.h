@@ -0,0 +1,54 @@
+/*
+ * psi_frame_meta.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_FRAME_META_H_
+#define PSI_FRAME_META_H_
+
+#include "hdf5.h"
+
+// records per chunk of the frame metadata dataset
+#define PSI_FRAME_META_CHUNK  1024
+
+// one record per frame, stored as compound type
+typedef struct psi_frame_record_t {
+	unsigned long long frame;
+	double timestamp;        // seconds since the epoch
+	unsigned int status;
+} psi_frame_record_t;
+
+// records are buffered and appended to the dataset batch at a time
+typedef struct psi_frame_meta_t {
+	hid_t dset;
+	hid_t type;
+	psi_frame_record_t *records;
+	int batch;
+	int nbuffered;
+	long long nwritten;
+	long long nappends;
+	double append_time;      // in H5Dset_extent() and H5Dwrite() [s]
+} psi_frame_meta_t;
+
+// create an empty, extendible dataset for the records
+herr_t
+create_psi_frame_meta(hid_t file, const char *name);
+
+herr_t
+open_psi_frame_meta(hid_t file, const char *name, int batch, psi_frame_meta_t *meta);
+
+// buffer the record of one frame, appends the batch when it is full
+herr_t
+add_psi_frame_meta(psi_frame_meta_t *meta, unsigned long long frame, unsigned int status);
+
+// append the records still in the buffer and close the dataset
+herr_t
+close_psi_frame_meta(psi_frame_meta_t *meta);
+
+// check that the dataset holds the frames 0 to nframes-1, returns 0 if so
+int
+verify_psi_frame_meta(hid_t file, const char *name, long long nframes);
+
+#endif /* PSI_FRAME_META_H_ */
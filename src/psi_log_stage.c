@@ -0,0 +1,263 @@
+/*
+ * psi_log_stage.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * Staging of chunks in a sequential log. The writer appends a small header
+ * and the chunk data with one writev(), like the raw baseline. A converter
+ * thread follows the log through a read-only shared mapping of the whole
+ * file and hands the chunk data in the mapping directly to
+ * H5DOwrite_chunk(), so the data is not copied on the way. The log is sized
+ * with ftruncate() when it is opened; the converter never reads past the
+ * records the writer has published, so it doesn't touch pages beyond the
+ * written data.
+ */
+
+#define _GNU_SOURCE   /* MAP_SHARED, ftruncate, writev */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include "hdf5.h"
+#include "hdf5_hl.h"
+#include "psi_log_stage.h"
+
+static double
+now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) ts.tv_sec + ts.tv_nsec*1.e-9;
+}
+
+static void
+sleep_until(double t)
+{
+	double left = t - now();
+	if (left <= 0.) return;
+	struct timespec ts = { (time_t) left, (long) ((left - (time_t) left)*1.e9) };
+	nanosleep(&ts, NULL);
+}
+
+int
+open_psi_stage(psi_stage_t *stage, const char *name, long long capacity, long long max_records)
+{
+	memset(stage, 0, sizeof(*stage));
+	stage->fd = -1;
+	stage->map = MAP_FAILED;
+	stage->capacity = capacity;
+	stage->max_records = max_records;
+	pthread_mutex_init(&stage->lock, NULL);
+	pthread_cond_init(&stage->cond, NULL);
+
+	stage->append_time = calloc(max_records > 0 ? max_records : 1, sizeof(double));
+	if (stage->append_time == NULL) goto fail;
+	stage->fd = open(name, O_RDWR|O_CREAT|O_TRUNC, S_IRWXU);
+	if (stage->fd == -1) {
+		printf("ERROR:open failed for %s\n", name);
+		perror(NULL);
+		goto fail;
+	}
+	if (ftruncate(stage->fd, capacity) == -1) {
+		perror("ERROR: ftruncate of staging log failed");
+		goto fail;
+	}
+	stage->map = mmap(NULL, capacity, PROT_READ, MAP_SHARED, stage->fd, 0);
+	if (stage->map == MAP_FAILED) {
+		perror("ERROR: mmap of staging log failed");
+		goto fail;
+	}
+	stage->start = now();
+	return 0;
+
+fail:
+	close_psi_stage(stage);
+	return -1;
+}
+
+static void *
+converter_thread(void *arg)
+{
+	psi_stage_t *stage = arg;
+	psi_stage_stats_t *stats = &stage->stats;
+	hsize_t offset[H5S_MAX_RANK];
+	long long pos = 0, record = 0, converted = 0;
+	double lag_sum = 0.;
+
+	for (;;) {
+		long long end, nrecords;
+		int done;
+
+		pthread_mutex_lock(&stage->lock);
+		while (stage->end == pos && !stage->done)
+			pthread_cond_wait(&stage->cond, &stage->lock);
+		end = stage->end;
+		nrecords = stage->nrecords;
+		done = stage->done;
+		pthread_mutex_unlock(&stage->lock);
+
+		if (end - converted > stats->max_backlog) stats->max_backlog = end - converted;
+		if (pos == end && done) break;
+
+		while (pos < end && record < nrecords) {
+			psi_stage_record_t header;
+			memcpy(&header, stage->map + pos, sizeof(header));   // headers are not aligned
+			if (header.magic != PSI_STAGE_MAGIC || header.chunk >= (uint64_t) stage->max_records) {
+				printf("ERROR: broken record at %lli in the staging log\n", pos);
+				goto fail;
+			}
+			long long index = header.chunk;
+			for (int d = stage->rank - 1; d >= 0; d--) {
+				offset[d] = (index % stage->grid[d]) * stage->chunk[d];
+				index /= stage->grid[d];
+			}
+
+			if (stage->rate > 0.) {
+				double t0 = now();
+				sleep_until(stage->start + (stats->bytes + header.size)/stage->rate);
+				stats->throttle_time += now() - t0;
+			}
+			if (H5DOwrite_chunk(stage->dset, H5P_DEFAULT, header.filter_mask, offset, header.size,
+					stage->map + pos + sizeof(header)) < 0) {
+				printf("ERROR: H5DOwrite_chunk of staged chunk %lli failed\n", (long long) header.chunk);
+				goto fail;
+			}
+
+			double lag = now() - stage->append_time[record];
+			lag_sum += lag;
+			if (lag > stats->max_lag) stats->max_lag = lag;
+			pos += sizeof(header) + header.size;
+			converted = pos;
+			record++;
+			stats->records++;
+			stats->bytes += header.size;
+		}
+	}
+	stats->convert_time = now() - stage->start;
+	stats->mean_lag = stats->records > 0 ? lag_sum/stats->records : 0.;
+	return NULL;
+
+fail:
+	pthread_mutex_lock(&stage->lock);
+	stage->failed = 1;
+	pthread_mutex_unlock(&stage->lock);
+	return NULL;
+}
+
+int
+start_psi_stage_converter(psi_stage_t *stage, hid_t dset, double rate)
+{
+	hsize_t dims[H5S_MAX_RANK];
+	hid_t space = H5Dget_space(dset), dcpl = H5Dget_create_plist(dset);
+	int ret = -1;
+
+	if (space < 0 || dcpl < 0) goto done;
+	stage->rank = H5Sget_simple_extent_dims(space, dims, NULL);
+	if (stage->rank <= 0 || H5Pget_chunk(dcpl, stage->rank, stage->chunk) != stage->rank) goto done;
+	for (int d = 0; d < stage->rank; d++)
+		stage->grid[d] = (dims[d] + stage->chunk[d] - 1) / stage->chunk[d];
+
+	stage->dset = dset;
+	stage->rate = rate;
+	if (pthread_create(&stage->thread, NULL, converter_thread, stage) != 0) {
+		printf("ERROR: failed to start the converter thread\n");
+		goto done;
+	}
+	stage->running = 1;
+	ret = 0;
+
+done:
+	if (dcpl >= 0) H5Pclose(dcpl);
+	if (space >= 0) H5Sclose(space);
+	return ret;
+}
+
+int
+append_psi_stage(psi_stage_t *stage, long long chunk, const void *buf, size_t size, unsigned int filter_mask)
+{
+	psi_stage_record_t header = { PSI_STAGE_MAGIC, filter_mask, chunk, size };
+	struct iovec iov[2] = { { &header, sizeof(header) }, { (void *) buf, size } };
+	size_t left = sizeof(header) + size;
+
+	if (stage->end + (long long) left > stage->capacity || stage->nrecords >= stage->max_records) {
+		printf("ERROR: staging log is full\n");
+		return -1;
+	}
+	// only this thread moves the end, no need to lock for reading it
+	for (int i = 0; left > 0; ) {
+		ssize_t n = writev(stage->fd, iov + i, 2 - i);
+		if (n == -1) {
+			perror("ERROR: write to staging log failed");
+			return -1;
+		}
+		left -= n;
+		while (i < 2 && (size_t) n >= iov[i].iov_len) {
+			n -= iov[i].iov_len;
+			i++;
+		}
+		if (i < 2) {
+			iov[i].iov_base = (char *) iov[i].iov_base + n;
+			iov[i].iov_len -= n;
+		}
+	}
+
+	pthread_mutex_lock(&stage->lock);
+	stage->append_time[stage->nrecords] = now();
+	stage->end += sizeof(header) + size;
+	stage->nrecords++;
+	pthread_cond_signal(&stage->cond);
+	pthread_mutex_unlock(&stage->lock);
+	return 0;
+}
+
+int
+finish_psi_stage(psi_stage_t *stage, psi_stage_stats_t *stats)
+{
+	int failed;
+
+	pthread_mutex_lock(&stage->lock);
+	stage->done = 1;
+	stage->ingest_end = now();
+	pthread_cond_signal(&stage->cond);
+	pthread_mutex_unlock(&stage->lock);
+
+	if (stage->running) pthread_join(stage->thread, NULL);
+	stage->running = 0;
+
+	*stats = stage->stats;
+	stats->ingest_time = stage->ingest_end - stage->start;
+	stats->final_lag = stats->convert_time - stats->ingest_time;
+	if (stats->final_lag < 0.) stats->final_lag = 0.;
+	failed = stage->failed || stage->stats.records != stage->nrecords;
+	return failed ? -1 : 0;
+}
+
+int
+close_psi_stage(psi_stage_t *stage)
+{
+	int ret = 0;
+
+	if (stage->running) {
+		psi_stage_stats_t stats;
+		finish_psi_stage(stage, &stats);
+	}
+	if (stage->map != MAP_FAILED) munmap(stage->map, stage->capacity);
+	stage->map = MAP_FAILED;
+	if (stage->fd >= 0) {
+		if (ftruncate(stage->fd, stage->end) == -1) ret = -1;
+		if (close(stage->fd) == -1) ret = -1;
+	}
+	stage->fd = -1;
+	free(stage->append_time);
+	stage->append_time = NULL;
+	pthread_cond_destroy(&stage->cond);
+	pthread_mutex_destroy(&stage->lock);
+	return ret;
+}
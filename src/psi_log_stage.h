@@ -0,0 +1,88 @@
+/*
+ * psi_log_stage.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_LOG_STAGE_H_
+#define PSI_LOG_STAGE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "hdf5.h"
+
+#define PSI_STAGE_MAGIC  0x50534931u   // "PSI1"
+
+// header in front of every chunk in the log
+typedef struct psi_stage_record_t {
+	uint32_t magic;
+	uint32_t filter_mask;    // passed on to H5DOwrite_chunk()
+	uint64_t chunk;          // index in the chunk grid, C order
+	uint64_t size;           // bytes of chunk data after the header
+} psi_stage_record_t;
+
+typedef struct psi_stage_stats_t {
+	long long records;
+	long long bytes;            // chunk data, without the headers
+	double ingest_time;         // from opening the log to the last append
+	double convert_time;        // from opening the log to the last H5DOwrite_chunk()
+	double mean_lag;            // from the append to the H5DOwrite_chunk() of a chunk
+	double max_lag;
+	double final_lag;           // from the last append to the end of the conversion
+	long long max_backlog;      // bytes in the log not converted yet
+	double throttle_time;       // converter sleeping to keep its rate
+} psi_stage_stats_t;
+
+typedef struct psi_stage_t {
+	int fd;
+	char *map;                  // the whole log, read-only for the converter
+	long long capacity;
+	long long max_records;
+	double start;
+
+	// converter
+	pthread_t thread;
+	int running;
+	hid_t dset;
+	double rate;                // bytes/s, 0 for no limit
+	int rank;
+	hsize_t chunk[H5S_MAX_RANK];
+	hsize_t grid[H5S_MAX_RANK];
+
+	// shared between writer and converter, protected by lock
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	long long end;              // bytes of complete records in the log
+	long long nrecords;
+	double *append_time;        // of every record
+	int done;                   // no more appends
+	int failed;                 // converter gave up
+	double ingest_end;
+	psi_stage_stats_t stats;
+} psi_stage_t;
+
+// create the log file with room for capacity bytes of records and headers
+int
+open_psi_stage(psi_stage_t *stage, const char *name, long long capacity, long long max_records);
+
+// converter thread ingesting the log into the chunked dataset dset at up to
+// rate bytes/s, 0 for no limit. The caller must not use HDF5 until
+// finish_psi_stage(), unless the library is thread-safe.
+int
+start_psi_stage_converter(psi_stage_t *stage, hid_t dset, double rate);
+
+// append a chunk to the log with one writev(), returns -1 on failure
+int
+append_psi_stage(psi_stage_t *stage, long long chunk, const void *buf, size_t size, unsigned int filter_mask);
+
+// no more appends, wait for the converter. Returns -1 if a write failed.
+int
+finish_psi_stage(psi_stage_t *stage, psi_stage_stats_t *stats);
+
+// unmap, cut the log to its used size and close it
+int
+close_psi_stage(psi_stage_t *stage);
+
+#endif /* PSI_LOG_STAGE_H_ */
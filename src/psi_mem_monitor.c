@@ -0,0 +1,121 @@
+/*
+ * psi_mem_monitor.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * periodic samples of the resident set size and the HDF5 metadata cache.
+ * The sample buffer is static, so the monitor doesn't add to the memory
+ * it measures while running.
+ */
+
+#define _POSIX_C_SOURCE 200112L   /* clock_gettime */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "hdf5.h"
+#include "psi_mem_monitor.h"
+
+static psi_mem_sample_t samples[PSI_MEM_MAX_SAMPLES];
+static int nsamples = 0;
+static double start_time = 0.;
+static double next_time = 0.;
+static double sample_interval = 0.;
+
+static double
+now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) ts.tv_sec + ts.tv_nsec*1.e-9;
+}
+
+long long
+get_psi_rss(void)
+{
+	long long size, resident;
+	FILE *f = fopen("/proc/self/statm", "r");
+
+	if (f == NULL) return -1;
+	if (fscanf(f, "%lld %lld", &size, &resident) != 2) resident = -1;
+	fclose(f);
+	return resident < 0 ? -1 : resident * sysconf(_SC_PAGESIZE);
+}
+
+int
+init_psi_mem_monitor(double interval)
+{
+	if (interval <= 0.) return -1;
+	memset(samples, 0, sizeof(samples));    // fault in the buffer before the measurement
+	nsamples = 0;
+	sample_interval = interval;
+	start_time = now();
+	next_time = start_time;
+	return 0;
+}
+
+void
+tick_psi_mem_monitor(hid_t file)
+{
+	double t = now();
+
+	if (sample_interval <= 0. || t < next_time) return;
+	next_time = t + sample_interval;
+
+	if (nsamples == PSI_MEM_MAX_SAMPLES) {
+		for (int i = 0; i < PSI_MEM_MAX_SAMPLES/2; i++)
+			samples[i] = samples[2*i];
+		nsamples = PSI_MEM_MAX_SAMPLES/2;
+		sample_interval *= 2.;
+	}
+
+	psi_mem_sample_t *s = &samples[nsamples++];
+	s->time = t - start_time;
+	s->rss = get_psi_rss();
+	s->mdc_size = s->mdc_max_size = -1;
+	s->mdc_hit_rate = -1.;
+	if (file >= 0) {
+		size_t max_size, min_clean_size, cur_size;
+		int cur_num_entries;
+		if (H5Fget_mdc_size(file, &max_size, &min_clean_size, &cur_size, &cur_num_entries) >= 0) {
+			s->mdc_size = cur_size;
+			s->mdc_max_size = max_size;
+		}
+		H5Fget_mdc_hit_rate(file, &s->mdc_hit_rate);
+	}
+}
+
+void
+get_psi_mem_summary(psi_mem_summary_t *summary)
+{
+	struct rusage usage;
+	double half = nsamples > 0 ? samples[nsamples-1].time/2. : 0.;
+	long long rss_sum = 0, mdc_sum = 0;
+	int nsteady = 0;
+
+	memset(summary, 0, sizeof(*summary));
+	summary->nsamples = nsamples;
+	summary->mdc_hit_rate = -1.;
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+		summary->peak_rss = (long long) usage.ru_maxrss * 1024;   // KiB on Linux
+
+	for (int i = 0; i < nsamples; i++) {
+		if (samples[i].rss > summary->max_rss) summary->max_rss = samples[i].rss;
+		if (samples[i].mdc_size > summary->max_mdc_size) summary->max_mdc_size = samples[i].mdc_size;
+		if (samples[i].mdc_max_size > summary->mdc_max_size) summary->mdc_max_size = samples[i].mdc_max_size;
+		if (samples[i].time >= half) {
+			rss_sum += samples[i].rss;
+			mdc_sum += samples[i].mdc_size;
+			nsteady++;
+		}
+	}
+	if (nsteady > 0) {
+		summary->steady_rss = rss_sum / nsteady;
+		summary->steady_mdc_size = mdc_sum / nsteady;
+	}
+	if (nsamples > 0)
+		summary->mdc_hit_rate = samples[nsamples-1].mdc_hit_rate;
+}
@@ -0,0 +1,52 @@
+/*
+ * psi_mem_monitor.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_MEM_MONITOR_H_
+#define PSI_MEM_MONITOR_H_
+
+#include "hdf5.h"
+
+// at most this many samples are kept, when full every second one is
+// dropped and the interval doubled
+#define PSI_MEM_MAX_SAMPLES  4096
+
+typedef struct psi_mem_sample_t {
+	double time;             // seconds since init_psi_mem_monitor()
+	long long rss;           // resident set size [Byte]
+	long long mdc_size;      // current metadata cache size [Byte]
+	long long mdc_max_size;
+	double mdc_hit_rate;
+} psi_mem_sample_t;
+
+// steady state is the mean over the second half of the sampled time
+typedef struct psi_mem_summary_t {
+	int nsamples;
+	long long peak_rss;      // from getrusage(), covers the whole process life
+	long long max_rss;       // largest sampled value
+	long long steady_rss;
+	long long max_mdc_size;
+	long long steady_mdc_size;
+	long long mdc_max_size;  // configured maximum of the cache
+	double mdc_hit_rate;     // last sample
+} psi_mem_summary_t;
+
+// interval in seconds
+int
+init_psi_mem_monitor(double interval);
+
+// take a sample of the process and the cache of file if the interval has
+// passed, cheap enough to call for every chunk
+void
+tick_psi_mem_monitor(hid_t file);
+
+void
+get_psi_mem_summary(psi_mem_summary_t *summary);
+
+long long
+get_psi_rss(void);
+
+#endif /* PSI_MEM_MONITOR_H_ */
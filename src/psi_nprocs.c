@@ -0,0 +1,138 @@
+/*
+ * psi_nprocs.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * several writer processes with a common start. The barriers are pipes:
+ * every child writes one byte to the ready pipe and blocks reading the
+ * start pipe of the barrier. Once the parent has read a byte of every
+ * child it closes the start pipe and all children see EOF at once.
+ */
+
+#define _POSIX_C_SOURCE 200112L   /* fork, pipe, waitpid */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "psi_nprocs.h"
+
+static int nprocs = 0;
+static int rank = -1;
+static int barriers_passed = 0;
+static int ready_pipe[2] = {-1, -1};
+static int start_pipe[PSI_PROC_NBARRIERS][2];
+static int result_pipe[2] = {-1, -1};
+
+int
+start_psi_procs(int n)
+{
+	nprocs = n;
+	rank = -1;
+	barriers_passed = 0;
+	if (pipe(ready_pipe) != 0 || pipe(result_pipe) != 0) return -2;
+	for (int b = 0; b < PSI_PROC_NBARRIERS; b++)
+		if (pipe(start_pipe[b]) != 0) return -2;
+
+	fflush(NULL);    // or the children write out the buffers of the parent again
+	for (int r = 0; r < n; r++) {
+		pid_t pid = fork();
+		if (pid == -1) {
+			perror("ERROR: fork failed");
+			return -2;    // the parent gives up, the children see EOF at the barriers
+		}
+		if (pid == 0) {
+			rank = r;
+			close(ready_pipe[0]);
+			close(result_pipe[0]);
+			for (int b = 0; b < PSI_PROC_NBARRIERS; b++)
+				close(start_pipe[b][1]);
+			return rank;
+		}
+	}
+
+	close(ready_pipe[1]);
+	close(result_pipe[1]);
+	for (int b = 0; b < PSI_PROC_NBARRIERS; b++)
+		close(start_pipe[b][0]);
+	return -1;
+}
+
+static void
+pass_barrier(char state)
+{
+	char c;
+
+	if (write(ready_pipe[1], &state, 1) != 1)
+		perror("ERROR: barrier write failed");
+	while (read(start_pipe[barriers_passed][0], &c, 1) > 0)
+		;
+	barriers_passed++;
+}
+
+void
+psi_proc_barrier(void)
+{
+	if (rank < 0 || barriers_passed >= PSI_PROC_NBARRIERS) return;
+	pass_barrier('r');
+}
+
+void
+report_psi_proc_result(const psi_proc_result_t *result)
+{
+	if (rank < 0) return;
+	while (barriers_passed < PSI_PROC_NBARRIERS)
+		pass_barrier('x');
+	psi_proc_result_t r = *result;
+	r.rank = rank;
+	if (write(result_pipe[1], &r, sizeof(r)) != sizeof(r))    // below PIPE_BUF, so atomic
+		perror("ERROR: failed to send result to parent");
+	close(result_pipe[1]);
+	rank = -1;
+}
+
+int
+collect_psi_proc_results(psi_proc_result_t *results)
+{
+	int nok = 0;
+
+	// a missing byte means a child died, EOF comes when all did
+	for (int b = 0; b < PSI_PROC_NBARRIERS; b++) {
+		for (int i = 0; i < nprocs; i++) {
+			char c;
+			if (read(ready_pipe[0], &c, 1) != 1) break;
+		}
+		close(start_pipe[b][1]);
+	}
+
+	memset(results, 0, nprocs*sizeof(psi_proc_result_t));
+	for (int i = 0; i < nprocs; i++) {
+		psi_proc_result_t r;
+		if (read(result_pipe[0], &r, sizeof(r)) != sizeof(r)) break;
+		if (r.rank >= 0 && r.rank < nprocs) results[r.rank] = r;
+	}
+	for (int i = 0; i < nprocs; i++) {
+		int status;
+		if (wait(&status) == -1) break;
+	}
+	for (int i = 0; i < nprocs; i++)
+		if (results[i].ok) nok++;
+
+	close(ready_pipe[0]);
+	close(result_pipe[0]);
+	return nok;
+}
+
+double
+psi_fairness(const double *rates, int n)
+{
+	double sum = 0., sum2 = 0.;
+	for (int i = 0; i < n; i++) {
+		sum += rates[i];
+		sum2 += rates[i]*rates[i];
+	}
+	return sum2 > 0. ? sum*sum/(n*sum2) : 0.;
+}
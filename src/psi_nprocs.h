@@ -0,0 +1,51 @@
+/*
+ * psi_nprocs.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_NPROCS_H_
+#define PSI_NPROCS_H_
+
+// number of barriers every process passes: before the raw and before the
+// HDF5 writes
+#define PSI_PROC_NBARRIERS  2
+
+typedef struct psi_proc_result_t {
+	int rank;
+	int ok;
+	double raw_start;        // wall clock, comparable between the processes
+	double raw_end;
+	double h5_start;
+	double h5_end;
+	long long nbytes;
+	long long nchunks;       // written with the HDF5 API
+	double api_time;         // inside the HDF5 write calls, 0 if not measured
+	double api_cpu;          // cpu time inside the HDF5 write calls
+} psi_proc_result_t;
+
+// fork nprocs processes. Returns the rank in the child, -1 in the parent
+// and -2 on failure.
+int
+start_psi_procs(int nprocs);
+
+// wait for all processes, a no-op if not started with start_psi_procs()
+void
+psi_proc_barrier(void);
+
+// child: send the result to the parent, after a failure also passes the
+// remaining barriers so the others don't hang
+void
+report_psi_proc_result(const psi_proc_result_t *result);
+
+// parent: release the barriers, collect the results of all processes
+// and wait for them. Returns the number of processes that succeeded.
+int
+collect_psi_proc_results(psi_proc_result_t *results);
+
+// Jain's fairness index of n rates, 1 if all are equal
+double
+psi_fairness(const double *rates, int n);
+
+#endif /* PSI_NPROCS_H_ */
@@ -0,0 +1,115 @@
+/*
+ * psi_numa.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * cpu pinning and memory placement with plain syscalls, no libnuma.
+ * The storage node is found by walking up the sysfs path of the block
+ * device until a numa_node file shows up, for NVMe that's the PCI device.
+ */
+
+#define _GNU_SOURCE   /* cpu_set_t, sched_setaffinity, syscall */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
+#include "psi_numa.h"
+
+// from linux/mempolicy.h
+#define PSI_MPOL_PREFERRED  1
+#define PSI_MPOL_BIND       2
+#define PSI_MPOL_F_NODE     (1<<0)
+#define PSI_MPOL_F_ADDR     (1<<1)
+
+#define PSI_MAX_NODES  1024
+
+int
+set_psi_cpu_affinity(const char *list)
+{
+	cpu_set_t set;
+	const char *p = list;
+
+	CPU_ZERO(&set);
+	while (*p != '\0') {
+		char *end;
+		long first = strtol(p, &end, 10), last;
+		if (end == p || first < 0) return -1;
+		last = first;
+		if (*end == '-') {
+			p = end + 1;
+			last = strtol(p, &end, 10);
+			if (end == p || last < first) return -1;
+		}
+		if (last >= CPU_SETSIZE) return -1;
+		for (long cpu = first; cpu <= last; cpu++)
+			CPU_SET(cpu, &set);
+		if (*end == ',') end++;
+		else if (*end != '\0') return -1;
+		p = end;
+	}
+	if (CPU_COUNT(&set) == 0) return -1;
+	return sched_setaffinity(0, sizeof(set), &set);
+}
+
+int
+set_psi_numa_preferred(int node)
+{
+	unsigned long mask[PSI_MAX_NODES/(8*sizeof(unsigned long))] = {0};
+
+	if (node < 0 || node >= PSI_MAX_NODES) return -1;
+	mask[node/(8*sizeof(unsigned long))] = 1UL << (node % (8*sizeof(unsigned long)));
+	return syscall(SYS_set_mempolicy, PSI_MPOL_PREFERRED, mask, PSI_MAX_NODES + 1) == 0 ? 0 : -1;
+}
+
+int
+bind_psi_numa_memory(void *addr, size_t len, int node)
+{
+	unsigned long mask[PSI_MAX_NODES/(8*sizeof(unsigned long))] = {0};
+
+	if (node < 0 || node >= PSI_MAX_NODES) return -1;
+	mask[node/(8*sizeof(unsigned long))] = 1UL << (node % (8*sizeof(unsigned long)));
+	return syscall(SYS_mbind, addr, len, PSI_MPOL_BIND, mask, PSI_MAX_NODES + 1, 0) == 0 ? 0 : -1;
+}
+
+int
+get_psi_memory_node(void *addr)
+{
+	int node = -1;
+
+	if (syscall(SYS_get_mempolicy, &node, NULL, 0, addr, PSI_MPOL_F_NODE|PSI_MPOL_F_ADDR) != 0)
+		return -1;
+	return node;
+}
+
+int
+get_psi_storage_numa_node(const char *path)
+{
+	struct stat st;
+	char link[64], dir[PATH_MAX], file[PATH_MAX + 16];
+
+	if (stat(path, &st) != 0) return -1;
+	snprintf(link, sizeof(link), "/sys/dev/block/%u:%u", major(st.st_dev), minor(st.st_dev));
+	if (realpath(link, dir) == NULL) return -1;
+
+	while (strlen(dir) > strlen("/sys/devices")) {
+		FILE *f;
+		int node;
+
+		snprintf(file, sizeof(file), "%s/numa_node", dir);
+		f = fopen(file, "r");
+		if (f != NULL) {
+			int n = fscanf(f, "%d", &node);
+			fclose(f);
+			return n == 1 ? node : -1;
+		}
+		*strrchr(dir, '/') = '\0';
+	}
+	return -1;
+}
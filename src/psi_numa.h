@@ -0,0 +1,34 @@
+/*
+ * psi_numa.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_NUMA_H_
+#define PSI_NUMA_H_
+
+#include <stddef.h>
+
+// pin the calling process to the cpus in list, e.g. "0-3,8". Threads
+// started later inherit the mask.
+int
+set_psi_cpu_affinity(const char *list);
+
+// prefer node for all further allocations of the process (set_mempolicy)
+int
+set_psi_numa_preferred(int node);
+
+// bind addr..addr+len to node (mbind), before the pages are touched
+int
+bind_psi_numa_memory(void *addr, size_t len, int node);
+
+// node holding the page at addr, -1 if unknown
+int
+get_psi_memory_node(void *addr);
+
+// node of the block device holding path, from sysfs, -1 if unknown
+int
+get_psi_storage_numa_node(const char *path);
+
+#endif /* PSI_NUMA_H_ */
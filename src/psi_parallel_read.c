@@ -0,0 +1,404 @@
+/*
+ * psi_parallel_read.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * Read back of chunked datasets, either through the HDF5 filter pipeline,
+ * which decodes every chunk in the thread calling H5Dread(), or with
+ * H5Dread_chunk() on one I/O thread and the decoding on a pool of worker
+ * threads. The worker threads don't call HDF5 at all.
+ *
+ * The chunks travel in a fixed set of slots: the I/O thread takes a free
+ * slot, reads the stored chunk into it and queues it, a worker decodes it
+ * into its own buffer, checks it and returns the slot.
+ */
+
+#define _POSIX_C_SOURCE 200112L   /* clock_gettime */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "hdf5.h"
+#include "psi_parallel_read.h"
+
+#if !H5_VERSION_GE(1,10,2)
+#error "psi_parallel_read needs H5Dread_chunk() of HDF5 1.10.2 or later"
+#endif
+#include "psi_passthrough_filter.h"
+#include "psi_bshuf_lz4_filter.h"
+#include "psi_checksum_filter.h"
+
+typedef struct layout_t {
+	int rank;
+	hsize_t dims[H5S_MAX_RANK];
+	hsize_t chunk[H5S_MAX_RANK];
+	hsize_t grid[H5S_MAX_RANK];    // number of chunks per dimension
+	long long nchunks;
+	size_t elem_size;
+	size_t chunk_bytes;
+	int bshuf_bit;                 // filter_mask bit of the bitshuffle+LZ4 filter, -1 if none
+	int checksum;                  // PSI_CHECKSUM_FLETCHER32 or _CRC32C trailer, checked and dropped
+	int checksum_bit;
+	hid_t memtype;
+} layout_t;
+
+typedef struct slot_t {
+	void *buf;
+	size_t size;
+	uint32_t mask;
+	long long index;
+} slot_t;
+
+typedef struct reader_t {
+	const layout_t *layout;
+	psi_chunk_check_t check;
+	void *check_arg;
+	size_t slot_size;
+
+	pthread_mutex_t lock;
+	pthread_cond_t ready_cond;
+	pthread_cond_t free_cond;
+	slot_t *slots;
+	int nslots;
+	int *ready;         // ring of slots waiting for a worker
+	int ready_head;
+	int ready_count;
+	int *free_slots;    // stack of empty slots
+	int nfree;
+	int done;
+
+	// results of the workers, protected by lock
+	double decompress_time;
+	long long mismatches;
+	int failed;
+} reader_t;
+
+static double
+now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) ts.tv_sec + ts.tv_nsec*1.e-9;
+}
+
+// dataset shape, chunk shape and the filters we have to undo
+static int
+get_layout(hid_t dset, layout_t *layout)
+{
+	hid_t space = -1, dcpl = -1, type = -1;
+	int ret = -1;
+
+	memset(layout, 0, sizeof(*layout));
+	layout->bshuf_bit = -1;
+	layout->checksum = PSI_CHECKSUM_NONE;
+	layout->checksum_bit = -1;
+	layout->memtype = -1;
+
+	space = H5Dget_space(dset);
+	dcpl = H5Dget_create_plist(dset);
+	type = H5Dget_type(dset);
+	if (space < 0 || dcpl < 0 || type < 0) goto done;
+
+	layout->rank = H5Sget_simple_extent_dims(space, layout->dims, NULL);
+	if (layout->rank <= 0 || H5Pget_layout(dcpl) != H5D_CHUNKED) {
+		printf("ERROR: parallel read needs a chunked dataset\n");
+		goto done;
+	}
+	if (H5Pget_chunk(dcpl, layout->rank, layout->chunk) != layout->rank) goto done;
+
+	layout->elem_size = H5Tget_size(type);
+	layout->memtype = H5Tget_native_type(type, H5T_DIR_ASCEND);
+	if (layout->elem_size == 0 || layout->memtype < 0) goto done;
+
+	layout->nchunks = 1;
+	layout->chunk_bytes = layout->elem_size;
+	for (int d = 0; d < layout->rank; d++) {
+		layout->grid[d] = (layout->dims[d] + layout->chunk[d] - 1) / layout->chunk[d];
+		layout->nchunks *= layout->grid[d];
+		layout->chunk_bytes *= layout->chunk[d];
+	}
+
+	int nfilters = H5Pget_nfilters(dcpl);
+	for (int i = 0; i < nfilters; i++) {
+		unsigned int flags;
+		size_t cd_nelmts = 0;
+		H5Z_filter_t id = H5Pget_filter2(dcpl, i, &flags, &cd_nelmts, NULL, 0, NULL, NULL);
+		if (id == PSI_PASSTHROUGH_FILTER) {
+			continue;    // the identity on read, whatever the mode
+		} else if (id == PSI_BSHUF_LZ4_FILTER && layout->bshuf_bit < 0) {
+			layout->bshuf_bit = i;
+		} else if ((id == H5Z_FILTER_FLETCHER32 || id == PSI_CRC32C_FILTER) && i == nfilters - 1) {
+			// only as the last filter, the checksum covers the stored data
+			layout->checksum = id == PSI_CRC32C_FILTER ? PSI_CHECKSUM_CRC32C : PSI_CHECKSUM_FLETCHER32;
+			layout->checksum_bit = i;
+		} else {
+			printf("ERROR: parallel read does not support filter %i\n", (int) id);
+			goto done;
+		}
+	}
+	ret = 0;
+
+done:
+	if (type >= 0) H5Tclose(type);
+	if (dcpl >= 0) H5Pclose(dcpl);
+	if (space >= 0) H5Sclose(space);
+	return ret;
+}
+
+static void
+chunk_offset(const layout_t *layout, long long index, hsize_t *offset)
+{
+	for (int d = layout->rank - 1; d >= 0; d--) {
+		offset[d] = (index % layout->grid[d]) * layout->chunk[d];
+		index /= layout->grid[d];
+	}
+}
+
+herr_t
+psi_pipeline_read(hid_t dset, psi_chunk_check_t check, void *check_arg, psi_read_stats_t *stats)
+{
+	layout_t layout;
+	hsize_t offset[H5S_MAX_RANK], count[H5S_MAX_RANK];
+	hid_t space = -1, memspace = -1;
+	char *buf = NULL;
+	herr_t ret = -1;
+	double start = now();
+
+	memset(stats, 0, sizeof(*stats));
+	if (get_layout(dset, &layout) < 0) goto done;
+
+	buf = malloc(layout.chunk_bytes);
+	space = H5Dget_space(dset);
+	if (buf == NULL || space < 0) goto done;
+
+	for (long long i = 0; i < layout.nchunks; i++) {
+		size_t nbytes = layout.elem_size;
+		hsize_t stored = 0;
+
+		chunk_offset(&layout, i, offset);
+		for (int d = 0; d < layout.rank; d++) {   // edge chunks are cut at the dataset boundary
+			count[d] = layout.chunk[d];
+			if (offset[d] + count[d] > layout.dims[d]) count[d] = layout.dims[d] - offset[d];
+			nbytes *= count[d];
+		}
+		memspace = H5Screate_simple(layout.rank, count, NULL);
+		if (memspace < 0) goto done;
+		if (H5Sselect_hyperslab(space, H5S_SELECT_SET, offset, NULL, count, NULL) < 0) goto done;
+
+		double t0 = now();
+		herr_t status = H5Dread(dset, layout.memtype, memspace, space, H5P_DEFAULT, buf);
+		stats->io_time += now() - t0;
+		if (status < 0) {
+			printf("ERROR: H5Dread of chunk %lli failed\n", i);
+			goto done;
+		}
+		H5Sclose(memspace);
+		memspace = -1;
+
+		if (H5Dget_chunk_storage_size(dset, offset, &stored) >= 0)
+			stats->stored_bytes += stored;
+		stats->bytes += nbytes;
+		stats->chunks++;
+		if (check != NULL && check(i, buf, nbytes, check_arg) != 0)
+			stats->mismatches++;
+	}
+	ret = 0;
+
+done:
+	stats->wall_time = now() - start;
+	if (memspace >= 0) H5Sclose(memspace);
+	if (space >= 0) H5Sclose(space);
+	if (layout.memtype >= 0) H5Tclose(layout.memtype);
+	free(buf);
+	return ret;
+}
+
+static void *
+worker(void *arg)
+{
+	reader_t *r = arg;
+	const layout_t *layout = r->layout;
+	double decompress_time = 0.;
+	long long mismatches = 0;
+	int failed = 0;
+	char *out = malloc(layout->chunk_bytes);
+
+	if (out == NULL) failed = 1;
+
+	for (;;) {
+		pthread_mutex_lock(&r->lock);
+		while (r->ready_count == 0 && !r->done)
+			pthread_cond_wait(&r->ready_cond, &r->lock);
+		if (r->ready_count == 0) {    // done and nothing left
+			pthread_mutex_unlock(&r->lock);
+			break;
+		}
+		int s = r->ready[r->ready_head];
+		r->ready_head = (r->ready_head + 1) % r->nslots;
+		r->ready_count--;
+		pthread_mutex_unlock(&r->lock);
+
+		slot_t *slot = &r->slots[s];
+		const void *data = slot->buf;
+		if (!failed && layout->checksum != PSI_CHECKSUM_NONE && !(slot->mask & (1u << layout->checksum_bit))) {
+			double t0 = now();
+			int bad = psi_check_checksum(layout->checksum, slot->buf, slot->size);
+			decompress_time += now() - t0;
+			if (bad) {
+				printf("ERROR: checksum of chunk %lli does not match\n", slot->index);
+				failed = 1;
+			}
+			slot->size -= PSI_CHECKSUM_SIZE;
+		}
+		if (!failed) {
+			if (layout->bshuf_bit >= 0 && !(slot->mask & (1u << layout->bshuf_bit))) {
+				double t0 = now();
+				size_t n = psi_bshuf_lz4_decompress(slot->buf, slot->size, layout->elem_size, out, layout->chunk_bytes);
+				decompress_time += now() - t0;
+				if (n != layout->chunk_bytes) {
+					printf("ERROR: failed to decompress chunk %lli\n", slot->index);
+					failed = 1;
+				}
+				data = out;
+			} else if (slot->size != layout->chunk_bytes) {
+				printf("ERROR: chunk %lli stored unfiltered has wrong size %zu\n", slot->index, slot->size);
+				failed = 1;
+			}
+			if (!failed && r->check != NULL && r->check(slot->index, data, layout->chunk_bytes, r->check_arg) != 0)
+				mismatches++;
+		}
+
+		pthread_mutex_lock(&r->lock);
+		r->free_slots[r->nfree++] = s;
+		pthread_cond_signal(&r->free_cond);
+		pthread_mutex_unlock(&r->lock);
+	}
+
+	pthread_mutex_lock(&r->lock);
+	r->decompress_time += decompress_time;
+	r->mismatches += mismatches;
+	if (failed) r->failed = 1;
+	pthread_mutex_unlock(&r->lock);
+	free(out);
+	return NULL;
+}
+
+herr_t
+psi_parallel_read(hid_t dset, int nthreads, psi_chunk_check_t check, void *check_arg, psi_read_stats_t *stats)
+{
+	layout_t layout;
+	reader_t r;
+	pthread_t threads[PSI_PARALLEL_READ_MAX_THREADS];
+	int nstarted = 0;
+	hsize_t offset[H5S_MAX_RANK];
+	herr_t ret = -1;
+	double start = now();
+
+	memset(stats, 0, sizeof(*stats));
+	memset(&r, 0, sizeof(r));
+	if (nthreads < 1 || nthreads > PSI_PARALLEL_READ_MAX_THREADS) {
+		printf("ERROR: number of read threads must be between 1 and %i\n", PSI_PARALLEL_READ_MAX_THREADS);
+		return -1;
+	}
+	if (get_layout(dset, &layout) < 0) {
+		if (layout.memtype >= 0) H5Tclose(layout.memtype);
+		return -1;
+	}
+
+	// two slots per worker keep the workers busy while the I/O thread reads ahead
+	r.layout = &layout;
+	r.check = check;
+	r.check_arg = check_arg;
+	r.nslots = 2*nthreads;
+	r.slot_size = layout.chunk_bytes;
+	if (layout.bshuf_bit >= 0) {
+		size_t bound = psi_bshuf_lz4_bound(layout.chunk_bytes, layout.elem_size, 0);
+		if (bound > r.slot_size) r.slot_size = bound;
+	}
+	if (layout.checksum != PSI_CHECKSUM_NONE) r.slot_size += PSI_CHECKSUM_SIZE;
+	r.slots = calloc(r.nslots, sizeof(slot_t));
+	r.ready = calloc(r.nslots, sizeof(int));
+	r.free_slots = calloc(r.nslots, sizeof(int));
+	if (r.slots == NULL || r.ready == NULL || r.free_slots == NULL) goto cleanup;
+	for (int s = 0; s < r.nslots; s++) {
+		r.slots[s].buf = malloc(r.slot_size);
+		if (r.slots[s].buf == NULL) goto cleanup;
+		r.free_slots[r.nfree++] = s;
+	}
+	pthread_mutex_init(&r.lock, NULL);
+	pthread_cond_init(&r.ready_cond, NULL);
+	pthread_cond_init(&r.free_cond, NULL);
+
+	for (nstarted = 0; nstarted < nthreads; nstarted++) {
+		if (pthread_create(&threads[nstarted], NULL, worker, &r) != 0) {
+			printf("ERROR: failed to start read thread\n");
+			goto join;
+		}
+	}
+
+	for (long long i = 0; i < layout.nchunks; i++) {
+		hsize_t stored = 0;
+
+		chunk_offset(&layout, i, offset);
+		if (H5Dget_chunk_storage_size(dset, offset, &stored) < 0 || stored == 0 || stored > r.slot_size) {
+			printf("ERROR: chunk %lli has no valid storage size\n", i);
+			goto join;
+		}
+
+		pthread_mutex_lock(&r.lock);
+		while (r.nfree == 0)
+			pthread_cond_wait(&r.free_cond, &r.lock);
+		int s = r.free_slots[--r.nfree];
+		pthread_mutex_unlock(&r.lock);
+
+		slot_t *slot = &r.slots[s];
+		// only the read itself, waiting for a free slot is decode time
+		double t0 = now();
+		herr_t status = H5Dread_chunk(dset, H5P_DEFAULT, offset, &slot->mask, slot->buf);
+		stats->io_time += now() - t0;
+		if (status < 0) {
+			printf("ERROR: H5Dread_chunk of chunk %lli failed\n", i);
+			goto join;
+		}
+		slot->size = stored;
+		slot->index = i;
+		stats->stored_bytes += stored;
+		stats->bytes += layout.chunk_bytes;
+		stats->chunks++;
+
+		pthread_mutex_lock(&r.lock);
+		r.ready[(r.ready_head + r.ready_count) % r.nslots] = s;
+		r.ready_count++;
+		pthread_cond_signal(&r.ready_cond);
+		pthread_mutex_unlock(&r.lock);
+	}
+	ret = 0;
+
+join:
+	pthread_mutex_lock(&r.lock);
+	r.done = 1;
+	pthread_cond_broadcast(&r.ready_cond);
+	pthread_mutex_unlock(&r.lock);
+	for (int t = 0; t < nstarted; t++)
+		pthread_join(threads[t], NULL);
+	pthread_cond_destroy(&r.free_cond);
+	pthread_cond_destroy(&r.ready_cond);
+	pthread_mutex_destroy(&r.lock);
+	if (r.failed) ret = -1;
+	stats->decompress_time = r.decompress_time;
+	stats->mismatches = r.mismatches;
+
+cleanup:
+	stats->wall_time = now() - start;
+	if (r.slots != NULL)
+		for (int s = 0; s < r.nslots; s++)
+			free(r.slots[s].buf);
+	free(r.slots);
+	free(r.ready);
+	free(r.free_slots);
+	H5Tclose(layout.memtype);
+	return ret;
+}
@@ -0,0 +1,44 @@
+/*
+ * psi_parallel_read.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_PARALLEL_READ_H_
+#define PSI_PARALLEL_READ_H_
+
+#include <stddef.h>
+#include "hdf5.h"
+
+// upper limit for the number of decompression threads
+#define PSI_PARALLEL_READ_MAX_THREADS  256
+
+typedef struct psi_read_stats_t {
+	long long chunks;
+	long long stored_bytes;     // bytes read from the file
+	long long bytes;            // bytes after decompression
+	long long mismatches;       // chunks rejected by the check function
+	double wall_time;
+	double io_time;             // in H5Dread_chunk(), not waiting for a slot,
+	                            // resp. H5Dread() including the decoding
+	double decompress_time;     // summed over all threads
+} psi_read_stats_t;
+
+// called for every decoded chunk, returns != 0 if the data is wrong.
+// index counts the chunks in C order of the chunk grid.
+typedef int (*psi_chunk_check_t)(long long index, const void *data, size_t size, void *arg);
+
+// read all chunks with H5Dread(), decoding in the filter pipeline
+herr_t
+psi_pipeline_read(hid_t dset, psi_chunk_check_t check, void *check_arg, psi_read_stats_t *stats);
+
+// read all chunks with H5Dread_chunk() in the calling thread and decode them
+// on nthreads worker threads. Only the PSI filters are understood, the
+// passthrough filters are the identity on read. A Fletcher32 or CRC32C
+// checksum as last filter is checked on the worker threads too. The check
+// function gets whole chunks, also at the edge of the dataset.
+herr_t
+psi_parallel_read(hid_t dset, int nthreads, psi_chunk_check_t check, void *check_arg, psi_read_stats_t *stats);
+
+#endif /* PSI_PARALLEL_READ_H_ */
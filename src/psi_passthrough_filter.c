@@ -3,24 +3,51 @@
  *
  *  Created on: Aug 31, 2012
  *      Author: billich
+ *
+ * cd_values[0] selects what the filter does with the data, see
+ * psi_passthrough_filter.h. Without cd_values the filter is a no-op.
+ * Every invocation is timed, the sums are available with
+ * get_psi_passthrough_filter_stats(). --write-threads can run the filter
+ * from several threads at once, the stats and the first call flags are
+ * guarded by stats_lock.
  */
 
+#define _POSIX_C_SOURCE 200112L   /* clock_gettime */
+
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
 #include "hdf5.h"
 #include "psi_passthrough_filter.h"
 
+static psi_passthrough_stats_t stats;
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// keeps the compiler from dropping the checksum loop
+static volatile unsigned long long checksum_sink;
 
+static double
+now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) ts.tv_sec + ts.tv_nsec*1.e-9;
+}
 
 static size_t
 psi_passthrough_filter(unsigned int flags, size_t cd_nelmts, const unsigned int cd_values[], size_t nbytes, size_t *buf_size, void **buf)
 {
 	static int reverse = 0;
 	static int forward = 0;
+	unsigned int mode = cd_nelmts > 0 ? cd_values[0] : PSI_PASSTHROUGH_NOOP;
 
+	pthread_mutex_lock(&stats_lock);
 	if (flags & H5Z_FLAG_REVERSE) {  // incoming data, reverse filter action
 		if (reverse == 0) {
 			reverse = 1;
-		printf("psi_passthrough_filter called for the first time in reverse direction\n");
+			printf("psi_passthrough_filter called for the first time in reverse direction\n");
 		}
 	} else {  // outgoing data, apply filter
 		if (forward == 0) {
@@ -28,6 +55,56 @@ psi_passthrough_filter(unsigned int flags, size_t cd_nelmts, const unsigned int
 			printf("psi_passthrough_filter called for the first time in forward direction\n");
 		}
 	}
+	pthread_mutex_unlock(&stats_lock);
+
+	// the first call message is not part of the filter time
+	double start = now();
+
+	switch (mode) {
+	case PSI_PASSTHROUGH_NOOP:
+		break;
+	case PSI_PASSTHROUGH_MEMCPY: {   // hand the data over in a new buffer
+		void *copy = malloc(nbytes);
+		if (copy == NULL) return 0;
+		memcpy(copy, *buf, nbytes);
+		free(*buf);
+		*buf = copy;
+		*buf_size = nbytes;
+		break;
+	}
+	case PSI_PASSTHROUGH_REALLOC: {  // grow the buffer to twice the data size, contents unchanged
+		void *bigger = realloc(*buf, 2*nbytes);
+		if (bigger == NULL) return 0;
+		*buf = bigger;
+		*buf_size = 2*nbytes;
+		break;
+	}
+	case PSI_PASSTHROUGH_CHECKSUM: { // read all data once
+		const unsigned char *p = *buf;
+		unsigned long long sum1 = 0, sum2 = 0;
+		for (size_t i = 0; i < nbytes; i++) {
+			sum1 += p[i];
+			sum2 += sum1;
+		}
+		checksum_sink = sum2;
+		break;
+	}
+	default:
+		printf("ERROR: psi_passthrough_filter: unknown mode %u\n", mode);
+		return 0;
+	}
+
+	double elapsed = now() - start;
+	pthread_mutex_lock(&stats_lock);
+	if (flags & H5Z_FLAG_REVERSE) {
+		stats.reverse_calls++;
+		stats.reverse_time += elapsed;
+	} else {
+		stats.forward_calls++;
+		stats.forward_time += elapsed;
+	}
+	if (elapsed > stats.max_time) stats.max_time = elapsed;
+	pthread_mutex_unlock(&stats_lock);
 
   return(nbytes);
 }
@@ -49,3 +126,17 @@ register_psi_passthrough_filter(void) {
     herr_t status = H5Zregister(&psi_passthrough_filter_definition);
     return(status);
 }
+
+void
+get_psi_passthrough_filter_stats(psi_passthrough_stats_t *s) {
+	pthread_mutex_lock(&stats_lock);
+	*s = stats;
+	pthread_mutex_unlock(&stats_lock);
+}
+
+void
+reset_psi_passthrough_filter_stats(void) {
+	pthread_mutex_lock(&stats_lock);
+	memset(&stats, 0, sizeof(stats));
+	pthread_mutex_unlock(&stats_lock);
+}
@@ -12,8 +12,29 @@
 
 #define PSI_PASSTHROUGH_FILTER  400
 
+// filter behavior, passed in cd_values[0]
+#define PSI_PASSTHROUGH_NOOP      0   // return immediately
+#define PSI_PASSTHROUGH_MEMCPY    1   // copy the data into a new buffer
+#define PSI_PASSTHROUGH_REALLOC   2   // realloc the buffer to a different size
+#define PSI_PASSTHROUGH_CHECKSUM  3   // compute a checksum over the data
+#define PSI_PASSTHROUGH_NMODES    4
+
+// timing of all invocations since the last reset, in seconds
+typedef struct psi_passthrough_stats_t {
+	long long forward_calls;
+	long long reverse_calls;
+	double forward_time;
+	double reverse_time;
+	double max_time;
+} psi_passthrough_stats_t;
+
 herr_t
 register_psi_passthrough_filter(void);
 
+void
+get_psi_passthrough_filter_stats(psi_passthrough_stats_t *stats);
+
+void
+reset_psi_passthrough_filter_stats(void);
 
 #endif /* PSI_PASSTHROUGH_FILTER_H_ */
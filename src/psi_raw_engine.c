@@ -0,0 +1,191 @@
+/*
+ * psi_raw_engine.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * Different ways to write the raw baseline file. write() and pwrite() pass
+ * one chunk per call, writev() a batch of chunks. The mmap engine copies
+ * the chunks into a shared mapping of the file, one window at a time; a
+ * window is handed to msync(MS_ASYNC) before it is unmapped. Like with the
+ * other engines nothing waits for the data to reach the disk.
+ */
+
+#define _POSIX_C_SOURCE 200809L   /* ftruncate, pwrite */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "psi_raw_engine.h"
+
+static const char *engine_names[PSI_RAW_NENGINES] = { "write", "pwrite", "writev", "mmap" };
+
+int
+psi_raw_engine_from_name(const char *name)
+{
+	for (int i = 0; i < PSI_RAW_NENGINES; i++)
+		if (strcmp(name, engine_names[i]) == 0) return i;
+	return -1;
+}
+
+const char *
+get_psi_raw_engine_name(int engine)
+{
+	if (engine < 0 || engine >= PSI_RAW_NENGINES) return "unknown";
+	return engine_names[engine];
+}
+
+int
+open_psi_raw_writer(psi_raw_writer_t *w, int engine, const char *name, long long size, int niov, int keep)
+{
+	memset(w, 0, sizeof(*w));
+	w->fd = -1;
+	if (engine < 0 || engine >= PSI_RAW_NENGINES) return -1;
+	if (engine == PSI_RAW_WRITEV && (niov < 1 || niov > PSI_RAW_MAX_IOV)) {
+		printf("ERROR: writev needs between 1 and %i chunks per call\n", PSI_RAW_MAX_IOV);
+		return -1;
+	}
+	w->engine = engine;
+	w->size = size;
+	w->niov = niov;
+
+	w->fd = open(name, keep ? O_RDWR|O_CREAT : O_RDWR|O_CREAT|O_TRUNC, S_IRWXU);
+	if (w->fd == -1) {
+		printf("ERROR:open failed for %s\n", name);
+		perror(NULL);
+		return -1;
+	}
+	// a mapping can't grow the file, it needs its final size
+	if (engine == PSI_RAW_MMAP && ftruncate(w->fd, size) == -1) {
+		perror("ERROR: ftruncate of raw file failed");
+		close(w->fd);
+		w->fd = -1;
+		return -1;
+	}
+	return 0;
+}
+
+static int
+unmap_window(psi_raw_writer_t *w)
+{
+	int ret = 0;
+
+	if (w->map == NULL) return 0;
+	if (msync(w->map, w->map_len, MS_ASYNC) == -1) {
+		perror("ERROR: msync of raw file failed");
+		ret = -1;
+	}
+	if (munmap(w->map, w->map_len) == -1) ret = -1;
+	w->map = NULL;
+	return ret;
+}
+
+static ssize_t
+write_mapped(psi_raw_writer_t *w, const char *buf, size_t size)
+{
+	size_t done = 0;
+
+	if (w->offset + (long long) size > w->size) {
+		printf("ERROR: write beyond the end of the mapped raw file\n");
+		return -1;
+	}
+	while (done < size) {
+		long long pos = w->offset + done;
+		if (w->map == NULL || pos >= w->map_offset + (long long) w->map_len) {
+			if (unmap_window(w) != 0) return -1;
+			w->map_offset = pos - pos % PSI_RAW_MMAP_WINDOW;
+			w->map_len = w->size - w->map_offset < PSI_RAW_MMAP_WINDOW ? w->size - w->map_offset : PSI_RAW_MMAP_WINDOW;
+			w->map = mmap(NULL, w->map_len, PROT_READ|PROT_WRITE, MAP_SHARED, w->fd, w->map_offset);
+			if (w->map == MAP_FAILED) {
+				perror("ERROR: mmap of raw file failed");
+				w->map = NULL;
+				return -1;
+			}
+		}
+		size_t n = w->map_offset + w->map_len - pos;
+		if (n > size - done) n = size - done;
+		memcpy(w->map + (pos - w->map_offset), buf + done, n);
+		done += n;
+	}
+	return done;
+}
+
+ssize_t
+flush_psi_raw_writer(psi_raw_writer_t *w)
+{
+	struct iovec *iov = w->iov;
+	int iovcnt = w->iovcnt;
+	ssize_t total = 0;
+
+	if (w->engine != PSI_RAW_WRITEV) return 0;
+	while (iovcnt > 0) {
+		ssize_t n = writev(w->fd, iov, iovcnt);
+		if (n == -1) return -1;
+		total += n;
+		// a short write ends somewhere in the batch, continue from there
+		while (iovcnt > 0 && (size_t) n >= iov->iov_len) {
+			n -= iov->iov_len;
+			iov++;
+			iovcnt--;
+		}
+		if (iovcnt > 0) {
+			iov->iov_base = (char *) iov->iov_base + n;
+			iov->iov_len -= n;
+		}
+	}
+	w->iovcnt = 0;
+	return total;
+}
+
+ssize_t
+psi_raw_write(psi_raw_writer_t *w, const char *buf, size_t size)
+{
+	size_t done = 0;
+	ssize_t n = 0;
+
+	switch (w->engine) {
+	case PSI_RAW_WRITE:
+		while (done < size) {   // write() transfers at most about 2 GiB per call on Linux
+			n = write(w->fd, buf + done, size - done);
+			if (n == -1) return -1;
+			done += n;
+		}
+		break;
+	case PSI_RAW_PWRITE:
+		while (done < size) {
+			n = pwrite(w->fd, buf + done, size - done, w->offset + done);
+			if (n == -1) return -1;
+			done += n;
+		}
+		break;
+	case PSI_RAW_WRITEV:
+		w->iov[w->iovcnt].iov_base = (void *) buf;
+		w->iov[w->iovcnt].iov_len = size;
+		w->iovcnt++;
+		w->offset += size;
+		return w->iovcnt == w->niov ? flush_psi_raw_writer(w) : 0;
+	case PSI_RAW_MMAP:
+		n = write_mapped(w, buf, size);
+		if (n == -1) return -1;
+		done = n;
+		break;
+	}
+	w->offset += done;
+	return done;
+}
+
+int
+close_psi_raw_writer(psi_raw_writer_t *w)
+{
+	int ret = 0;
+
+	if (flush_psi_raw_writer(w) == -1) ret = -1;
+	if (unmap_window(w) != 0) ret = -1;
+	if (w->fd >= 0 && close(w->fd) == -1) ret = -1;
+	w->fd = -1;
+	return ret;
+}
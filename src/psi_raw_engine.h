@@ -0,0 +1,69 @@
+/*
+ * psi_raw_engine.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_RAW_ENGINE_H_
+#define PSI_RAW_ENGINE_H_
+
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+// how the raw baseline writes its chunks
+#define PSI_RAW_WRITE    0   // write() per chunk
+#define PSI_RAW_PWRITE   1   // pwrite() per chunk at an explicit offset
+#define PSI_RAW_WRITEV   2   // writev() of several chunks per call
+#define PSI_RAW_MMAP     3   // memcpy() into a MAP_SHARED mapping, msync() per window
+#define PSI_RAW_NENGINES 4
+
+// upper limit for the chunks per writev() call
+#define PSI_RAW_MAX_IOV  1024
+
+// size of the mapped part of the file with PSI_RAW_MMAP
+#define PSI_RAW_MMAP_WINDOW  (64LL*1024*1024)
+
+typedef struct psi_raw_writer_t {
+	int engine;
+	int fd;
+	long long offset;       // bytes passed to the writer so far
+	long long size;         // file size, needed by mmap
+	int niov;
+	int iovcnt;
+	struct iovec iov[PSI_RAW_MAX_IOV];
+	char *map;              // current window of the mapping
+	long long map_offset;
+	size_t map_len;
+} psi_raw_writer_t;
+
+// returns -1 for an unknown name
+int
+psi_raw_engine_from_name(const char *name);
+
+const char *
+get_psi_raw_engine_name(int engine);
+
+// open the file for writing size bytes. With keep the file is not
+// truncated, e.g. to write into preallocated blocks. niov is the number of
+// chunks per writev() call. Returns -1 on failure.
+int
+open_psi_raw_writer(psi_raw_writer_t *w, int engine, const char *name, long long size, int niov, int keep);
+
+// write a chunk, the buffer must stay unchanged until the writer is
+// flushed or closed. Returns the bytes that reached the file with this
+// call, writev collects the chunks and returns 0 until the batch is full,
+// -1 on failure.
+ssize_t
+psi_raw_write(psi_raw_writer_t *w, const char *buf, size_t size);
+
+// write out what is still queued, returns the bytes or -1 on failure
+ssize_t
+flush_psi_raw_writer(psi_raw_writer_t *w);
+
+// flushes and closes the file
+int
+close_psi_raw_writer(psi_raw_writer_t *w);
+
+#endif /* PSI_RAW_ENGINE_H_ */
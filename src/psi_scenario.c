@@ -0,0 +1,321 @@
+/*
+ * psi_scenario.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * Scenario files describe a workload of several datasets written into one
+ * HDF5 file at the same time. The format is line based, like an ini file:
+ *
+ *   # comment
+ *   [file]
+ *   description = two detectors and a camera
+ *   metadata-tuning = yes
+ *   alignment = 1048576
+ *
+ *   [dataset eiger]
+ *   shape = 2167 2070           # ny nx of a frame
+ *   dtype = uint32
+ *   frames = 3000
+ *   chunk-frames = 1
+ *   rate = 100                  # frames/s, 0 as fast as possible
+ *   start = 0                   # seconds after the start of the run
+ *   data = detector
+ *   compression = bshuf-lz4
+ *   write = direct              # or traditional
+ *   frame-meta = 100            # frames per append, 0 for none
+ *
+ * Everything but shape and frames has a default.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "psi_scenario.h"
+
+// HDF5 stores the size of a chunk in 32 bit
+#define MAX_CHUNK_BYTES  0xffffffffULL
+
+static const char *dtype_names[PSI_NDTYPES] = { "uint8", "uint16", "uint32", "int32", "float32", "float64" };
+static const size_t dtype_sizes[PSI_NDTYPES] = { 1, 2, 4, 4, 4, 8 };
+
+int
+psi_dtype_from_name(const char *name)
+{
+	for (int i = 0; i < PSI_NDTYPES; i++)
+		if (strcmp(name, dtype_names[i]) == 0) return i;
+	return -1;
+}
+
+const char *
+get_psi_dtype_name(int dtype)
+{
+	if (dtype < 0 || dtype >= PSI_NDTYPES) return "unknown";
+	return dtype_names[dtype];
+}
+
+size_t
+get_psi_dtype_size(int dtype)
+{
+	if (dtype < 0 || dtype >= PSI_NDTYPES) return 0;
+	return dtype_sizes[dtype];
+}
+
+hid_t
+get_psi_dtype_h5type(int dtype)
+{
+	switch (dtype) {
+	case PSI_DTYPE_UINT8:   return H5T_STD_U8LE;
+	case PSI_DTYPE_UINT16:  return H5T_STD_U16LE;
+	case PSI_DTYPE_UINT32:  return H5T_STD_U32LE;
+	case PSI_DTYPE_INT32:   return H5T_STD_I32LE;
+	case PSI_DTYPE_FLOAT32: return H5T_IEEE_F32LE;
+	case PSI_DTYPE_FLOAT64: return H5T_IEEE_F64LE;
+	}
+	return -1;
+}
+
+size_t
+get_psi_scenario_chunk_bytes(const psi_scenario_dataset_t *dataset)
+{
+	return (size_t) dataset->chunk_frames * dataset->ny * dataset->nx * get_psi_dtype_size(dataset->dtype);
+}
+
+// whitespace off both ends, in place
+static char *
+trim(char *s)
+{
+	char *end;
+
+	while (isspace((unsigned char) *s)) s++;
+	end = s + strlen(s);
+	while (end > s && isspace((unsigned char) end[-1])) end--;
+	*end = '\0';
+	return s;
+}
+
+static int
+parse_long(const char *value, long long min, long long *out)
+{
+	char *end;
+	long long v = strtoll(value, &end, 10);
+
+	if (end == value || *end != '\0' || v < min) return -1;
+	*out = v;
+	return 0;
+}
+
+static int
+parse_double(const char *value, double *out)
+{
+	char *end;
+	double v = strtod(value, &end);
+
+	if (end == value || *end != '\0' || v < 0.) return -1;
+	*out = v;
+	return 0;
+}
+
+static int
+parse_bool(const char *value, int *out)
+{
+	if (strcmp(value, "yes") == 0 || strcmp(value, "true") == 0 || strcmp(value, "1") == 0) {
+		*out = 1;
+	} else if (strcmp(value, "no") == 0 || strcmp(value, "false") == 0 || strcmp(value, "0") == 0) {
+		*out = 0;
+	} else {
+		return -1;
+	}
+	return 0;
+}
+
+static int
+set_file_key(psi_scenario_t *scenario, const char *key, const char *value)
+{
+	long long v;
+
+	if (strcmp(key, "description") == 0) {
+		snprintf(scenario->description, sizeof(scenario->description), "%s", value);
+	} else if (strcmp(key, "metadata-tuning") == 0) {
+		return parse_bool(value, &scenario->metadata_tuning);
+	} else if (strcmp(key, "alignment") == 0) {
+		if (parse_long(value, 0, &v) < 0) return -1;
+		scenario->alignment = v;
+	} else {
+		return -2;
+	}
+	return 0;
+}
+
+static int
+set_dataset_key(psi_scenario_dataset_t *d, const char *key, const char *value)
+{
+	long long v;
+
+	if (strcmp(key, "shape") == 0) {
+		if (sscanf(value, "%li %li", &d->ny, &d->nx) != 2 || d->ny <= 0 || d->nx <= 0) return -1;
+	} else if (strcmp(key, "dtype") == 0) {
+		d->dtype = psi_dtype_from_name(value);
+		if (d->dtype < 0) return -1;
+	} else if (strcmp(key, "frames") == 0) {
+		if (parse_long(value, 1, &d->frames) < 0) return -1;
+	} else if (strcmp(key, "chunk-frames") == 0) {
+		if (parse_long(value, 1, &v) < 0) return -1;
+		d->chunk_frames = v;
+	} else if (strcmp(key, "rate") == 0) {
+		return parse_double(value, &d->rate);
+	} else if (strcmp(key, "start") == 0) {
+		return parse_double(value, &d->start);
+	} else if (strcmp(key, "data") == 0) {
+		if (strcmp(value, "constant") != 0 && strcmp(value, "detector") != 0 && strcmp(value, "random") != 0)
+			return -1;
+		snprintf(d->data, sizeof(d->data), "%s", value);
+	} else if (strcmp(key, "compression") == 0) {
+		if (strcmp(value, "bshuf-lz4") == 0) d->bshuf_lz4 = 1;
+		else if (strcmp(value, "none") == 0) d->bshuf_lz4 = 0;
+		else return -1;
+	} else if (strcmp(key, "write") == 0) {
+		if (strcmp(value, "traditional") == 0) d->traditional = 1;
+		else if (strcmp(value, "direct") == 0) d->traditional = 0;
+		else return -1;
+	} else if (strcmp(key, "frame-meta") == 0) {
+		if (parse_long(value, 0, &v) < 0 || v > 1000000) return -1;
+		d->frame_meta = v;
+	} else {
+		return -2;
+	}
+	return 0;
+}
+
+// checks that need the whole section
+static int
+check_dataset(const char *path, const psi_scenario_t *scenario, const psi_scenario_dataset_t *d)
+{
+	if (d->ny == 0 || d->frames == 0) {
+		printf("ERROR: %s:%i: dataset %s needs shape and frames\n", path, d->line, d->name);
+		return -1;
+	}
+	if (d->frames % d->chunk_frames != 0) {
+		printf("ERROR: %s:%i: frames of dataset %s are not a multiple of chunk-frames\n", path, d->line, d->name);
+		return -1;
+	}
+	if ((double) d->chunk_frames * d->ny * d->nx * get_psi_dtype_size(d->dtype) > (double) MAX_CHUNK_BYTES) {
+		printf("ERROR: %s:%i: chunk of dataset %s exceeds the HDF5 limit of %llu bytes\n", path, d->line, d->name,
+				MAX_CHUNK_BYTES);
+		return -1;
+	}
+	if (strchr(d->name, '/') != NULL) {
+		printf("ERROR: %s:%i: dataset name %s must not contain '/'\n", path, d->line, d->name);
+		return -1;
+	}
+	for (const psi_scenario_dataset_t *o = scenario->datasets; o < d; o++) {
+		if (strcmp(o->name, d->name) == 0) {
+			printf("ERROR: %s:%i: dataset %s defined twice\n", path, d->line, d->name);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+int
+load_psi_scenario(const char *path, psi_scenario_t *scenario)
+{
+	char buf[512];
+	int lineno = 0;
+	int in_file = 0;
+	psi_scenario_dataset_t *d = NULL;
+	FILE *f;
+
+	memset(scenario, 0, sizeof(*scenario));
+	f = fopen(path, "r");
+	if (f == NULL) {
+		printf("ERROR: failed to open scenario %s\n", path);
+		perror(NULL);
+		return -1;
+	}
+
+	while (fgets(buf, sizeof(buf), f) != NULL) {
+		char *line, *hash, *eq, *key, *value;
+		int ret;
+
+		lineno++;
+		if (strchr(buf, '\n') == NULL && !feof(f)) {
+			printf("ERROR: %s:%i: line too long\n", path, lineno);
+			goto fail;
+		}
+		hash = strchr(buf, '#');
+		if (hash != NULL) *hash = '\0';
+		line = trim(buf);
+		if (*line == '\0') continue;
+
+		// section header
+		if (*line == '[') {
+			char name[PSI_SCENARIO_MAX_NAME];
+			char *close = strchr(line, ']');
+			if (close == NULL || *trim(close + 1) != '\0') {
+				printf("ERROR: %s:%i: broken section header\n", path, lineno);
+				goto fail;
+			}
+			*close = '\0';
+			line = trim(line + 1);
+			if (d != NULL && check_dataset(path, scenario, d) < 0) goto fail;
+			d = NULL;
+			in_file = 0;
+			if (strcmp(line, "file") == 0) {
+				in_file = 1;
+			} else if (sscanf(line, "dataset %63s", name) == 1) {
+				if (scenario->ndatasets == PSI_SCENARIO_MAX_DATASETS) {
+					printf("ERROR: %s:%i: more than %i datasets\n", path, lineno, PSI_SCENARIO_MAX_DATASETS);
+					goto fail;
+				}
+				d = &scenario->datasets[scenario->ndatasets++];
+				snprintf(d->name, sizeof(d->name), "%s", name);
+				d->dtype = PSI_DTYPE_UINT8;
+				d->chunk_frames = 1;
+				strcpy(d->data, "detector");
+				d->line = lineno;
+			} else {
+				printf("ERROR: %s:%i: unknown section [%s]\n", path, lineno, line);
+				goto fail;
+			}
+			continue;
+		}
+
+		eq = strchr(line, '=');
+		if (eq == NULL) {
+			printf("ERROR: %s:%i: expected key = value\n", path, lineno);
+			goto fail;
+		}
+		*eq = '\0';
+		key = trim(line);
+		value = trim(eq + 1);
+		if (in_file) {
+			ret = set_file_key(scenario, key, value);
+		} else if (d != NULL) {
+			ret = set_dataset_key(d, key, value);
+		} else {
+			printf("ERROR: %s:%i: %s outside of a section\n", path, lineno, key);
+			goto fail;
+		}
+		if (ret == -2) {
+			printf("ERROR: %s:%i: unknown key %s\n", path, lineno, key);
+			goto fail;
+		}
+		if (ret < 0) {
+			printf("ERROR: %s:%i: bad value for %s: %s\n", path, lineno, key, value);
+			goto fail;
+		}
+	}
+	if (d != NULL && check_dataset(path, scenario, d) < 0) goto fail;
+	if (scenario->ndatasets == 0) {
+		printf("ERROR: %s: no datasets\n", path);
+		goto fail;
+	}
+	fclose(f);
+	return 0;
+
+fail:
+	fclose(f);
+	return -1;
+}
@@ -0,0 +1,71 @@
+/*
+ * psi_scenario.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_SCENARIO_H_
+#define PSI_SCENARIO_H_
+
+#include "hdf5.h"
+
+#define PSI_SCENARIO_MAX_DATASETS  32
+#define PSI_SCENARIO_MAX_NAME      64
+
+// element types of the datasets
+#define PSI_DTYPE_UINT8    0
+#define PSI_DTYPE_UINT16   1
+#define PSI_DTYPE_UINT32   2
+#define PSI_DTYPE_INT32    3
+#define PSI_DTYPE_FLOAT32  4
+#define PSI_DTYPE_FLOAT64  5
+#define PSI_NDTYPES        6
+
+// one stream of frames written to its own dataset
+typedef struct psi_scenario_dataset_t {
+	char name[PSI_SCENARIO_MAX_NAME];
+	long ny, nx;                // frame shape
+	int dtype;
+	long long frames;
+	long chunk_frames;          // frames per chunk
+	double rate;                // frames/s, 0 as fast as possible
+	double start;               // first frame this many seconds after the start of the run
+	char data[16];              // chunk data like --data: constant, detector or random
+	int bshuf_lz4;              // compress with the bitshuffle+LZ4 filter
+	int traditional;            // H5Dwrite() instead of H5DOwrite_chunk()
+	int frame_meta;             // frames per append of the frame metadata, 0 for none
+	int line;                   // of the section header in the file
+} psi_scenario_dataset_t;
+
+typedef struct psi_scenario_t {
+	char description[256];
+	int metadata_tuning;        // like -m
+	long long alignment;        // like --alignment
+	int ndatasets;
+	psi_scenario_dataset_t datasets[PSI_SCENARIO_MAX_DATASETS];
+} psi_scenario_t;
+
+// read a scenario file. Returns 0 on success, -1 with a message naming the
+// file and line otherwise.
+int
+load_psi_scenario(const char *path, psi_scenario_t *scenario);
+
+int
+psi_dtype_from_name(const char *name);
+
+const char *
+get_psi_dtype_name(int dtype);
+
+size_t
+get_psi_dtype_size(int dtype);
+
+// little endian file type of the element type
+hid_t
+get_psi_dtype_h5type(int dtype);
+
+// bytes of one chunk of the dataset
+size_t
+get_psi_scenario_chunk_bytes(const psi_scenario_dataset_t *dataset);
+
+#endif /* PSI_SCENARIO_H_ */
@@ -0,0 +1,85 @@
+/*
+ * psi_stats.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * summary statistics of repeated measurements. The confidence interval
+ * uses Student's t distribution, few repetitions are the normal case.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "psi_stats.h"
+
+// two-sided 95% quantiles of Student's t for 1 to 30 degrees of freedom
+static const double t95[30] = {
+	12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+	2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+	2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+static double
+student_t95(int df)
+{
+	if (df <= 30) return t95[df - 1];
+	if (df <= 40) return 2.021;
+	if (df <= 60) return 2.000;
+	if (df <= 120) return 1.980;
+	return 1.960;
+}
+
+static int
+compare_doubles(const void *a, const void *b)
+{
+	double x = *(const double *) a, y = *(const double *) b;
+	return (x > y) - (x < y);
+}
+
+// linear interpolation between the closest ranks
+static double
+quantile(const double *sorted, int n, double q)
+{
+	double pos = q * (n - 1);
+	int i = (int) pos;
+	if (i >= n - 1) return sorted[n - 1];
+	return sorted[i] + (pos - i) * (sorted[i + 1] - sorted[i]);
+}
+
+int
+get_psi_stats(const double *samples, int n, psi_stats_t *stats, int *outlier)
+{
+	double *sorted;
+	double sum = 0., sum2 = 0.;
+
+	memset(stats, 0, sizeof(*stats));
+	if (n <= 0) return -1;
+	sorted = malloc(n * sizeof(double));
+	if (sorted == NULL) return -1;
+	memcpy(sorted, samples, n * sizeof(double));
+	qsort(sorted, n, sizeof(double), compare_doubles);
+
+	stats->n = n;
+	for (int i = 0; i < n; i++)
+		sum += samples[i];
+	stats->mean = sum / n;
+	for (int i = 0; i < n; i++)
+		sum2 += (samples[i] - stats->mean) * (samples[i] - stats->mean);
+	if (n > 1) {
+		stats->sd = sqrt(sum2 / (n - 1));
+		stats->ci95 = student_t95(n - 1) * stats->sd / sqrt(n);
+	}
+	stats->median = quantile(sorted, n, 0.5);
+	stats->q1 = quantile(sorted, n, 0.25);
+	stats->q3 = quantile(sorted, n, 0.75);
+
+	double iqr = stats->q3 - stats->q1;
+	for (int i = 0; i < n; i++) {
+		int out = n >= 4 && (samples[i] < stats->q1 - 1.5*iqr || samples[i] > stats->q3 + 1.5*iqr);
+		if (outlier != NULL) outlier[i] = out;
+		stats->noutliers += out;
+	}
+	free(sorted);
+	return 0;
+}
@@ -0,0 +1,28 @@
+/*
+ * psi_stats.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_STATS_H_
+#define PSI_STATS_H_
+
+typedef struct psi_stats_t {
+	int n;
+	double mean;
+	double median;
+	double sd;              // sample standard deviation
+	double ci95;            // half width of the 95% confidence interval of the mean
+	double q1;              // quartiles
+	double q3;
+	int noutliers;
+} psi_stats_t;
+
+// statistics of n samples. If outlier is not NULL, outlier[i] is set to 1
+// for samples outside 1.5 interquartile ranges from the quartiles (Tukey's
+// fences), else to 0.
+int
+get_psi_stats(const double *samples, int n, psi_stats_t *stats, int *outlier);
+
+#endif /* PSI_STATS_H_ */
@@ -0,0 +1,159 @@
+/*
+ * psi_timeline.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * throughput over time. The bytes of a call are booked into the bucket in
+ * which the call finished, a call blocking longer than a bucket leaves
+ * empty buckets behind - that is what a writeback stall looks like.
+ */
+
+#define _POSIX_C_SOURCE 200112L   /* clock_gettime */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "psi_timeline.h"
+
+static double
+now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) ts.tv_sec + ts.tv_nsec*1.e-9;
+}
+
+int
+init_psi_timeline(psi_timeline_t *timeline, const char *label, double bucket, double progress)
+{
+	memset(timeline, 0, sizeof(*timeline));
+	if (bucket <= 0.) return -1;
+	timeline->label = label;
+	timeline->bucket = bucket;
+	timeline->progress = progress;
+	timeline->max_buckets = 1024;
+	timeline->bytes = calloc(timeline->max_buckets, sizeof(long long));
+	if (timeline->bytes == NULL) return -1;
+	timeline->start = now();
+	timeline->next_progress = timeline->start + progress;
+	return 0;
+}
+
+// duration of bucket i, the last one ends with the timeline
+static double
+bucket_length(const psi_timeline_t *timeline, int i)
+{
+	double length = timeline->end - timeline->start - i*timeline->bucket;
+	return length < timeline->bucket ? length : timeline->bucket;
+}
+
+// make room for bucket i
+static int
+grow(psi_timeline_t *timeline, int i)
+{
+	if (i < timeline->max_buckets) return 0;
+
+	int n = timeline->max_buckets;
+	while (n <= i) n *= 2;
+	long long *bytes = realloc(timeline->bytes, n*sizeof(long long));
+	if (bytes == NULL) return -1;
+	memset(bytes + timeline->max_buckets, 0, (n - timeline->max_buckets)*sizeof(long long));
+	timeline->bytes = bytes;
+	timeline->max_buckets = n;
+	return 0;
+}
+
+void
+add_psi_timeline(psi_timeline_t *timeline, long long nbytes)
+{
+	if (timeline->bytes == NULL) return;
+
+	double t = now();
+	int i = (int) ((t - timeline->start) / timeline->bucket);
+	if (grow(timeline, i) < 0) return;
+	timeline->bytes[i] += nbytes;
+	if (i >= timeline->nbuckets) timeline->nbuckets = i + 1;
+	timeline->total_bytes += nbytes;
+
+	if (timeline->progress > 0. && t >= timeline->next_progress) {
+		double window = t - (timeline->next_progress - timeline->progress);
+		printf("# progress %s %9.1lfs %10.1lf MiB/s, %.3lf GiB written\n", timeline->label,
+				t - timeline->start,
+				(timeline->total_bytes - timeline->progress_bytes)/window/(1024.*1024.),
+				timeline->total_bytes/(1024.*1024.*1024.));
+		fflush(stdout);
+		timeline->progress_bytes = timeline->total_bytes;
+		timeline->next_progress = t + timeline->progress;
+	}
+}
+
+void
+finish_psi_timeline(psi_timeline_t *timeline)
+{
+	timeline->end = now();
+	if (timeline->bytes == NULL) return;
+
+	// trailing empty buckets are a stall too, e.g. while closing the file
+	int i = (int) ((timeline->end - timeline->start) / timeline->bucket);
+	if (grow(timeline, i) == 0 && i >= timeline->nbuckets) timeline->nbuckets = i + 1;
+}
+
+static int
+compare_double(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+void
+get_psi_timeline_summary(const psi_timeline_t *timeline, psi_timeline_summary_t *summary)
+{
+	int n = timeline->nbuckets;
+	double *rates;
+
+	memset(summary, 0, sizeof(*summary));
+	summary->nbuckets = n;
+	if (n == 0 || (rates = malloc(n*sizeof(double))) == NULL) return;
+
+	for (int i = 0; i < n; i++) {
+		double length = bucket_length(timeline, i);
+		rates[i] = length > 0. ? timeline->bytes[i]/length : 0.;
+	}
+	double stall = 0.;
+	qsort(rates, n, sizeof(double), compare_double);
+	summary->min_rate = rates[0];
+	summary->max_rate = rates[n-1];
+	summary->median_rate = rates[n/2];
+	for (int i = 0; i < n; i++) {
+		double length = bucket_length(timeline, i);
+		if (length > 0. && timeline->bytes[i]/length < PSI_TIMELINE_STALL_FRACTION*summary->median_rate) {
+			summary->stall_buckets++;
+			stall += length;
+			if (stall > summary->longest_stall) summary->longest_stall = stall;
+		} else {
+			stall = 0.;
+		}
+	}
+	free(rates);
+}
+
+void
+print_psi_timeline_json(FILE *f, const psi_timeline_t *timeline)
+{
+	fprintf(f, "{\"bucket\":%.3lf, \"mibs\":[", timeline->bucket);
+	for (int i = 0; i < timeline->nbuckets; i++) {
+		double length = bucket_length(timeline, i);
+		fprintf(f, "%s%.1lf", i > 0 ? "," : "",
+				length > 0. ? timeline->bytes[i]/length/(1024.*1024.) : 0.);
+	}
+	fprintf(f, "]}");
+}
+
+void
+free_psi_timeline(psi_timeline_t *timeline)
+{
+	free(timeline->bytes);
+	timeline->bytes = NULL;
+}
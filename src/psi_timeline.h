@@ -0,0 +1,62 @@
+/*
+ * psi_timeline.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_TIMELINE_H_
+#define PSI_TIMELINE_H_
+
+#include <stdio.h>
+
+// a bucket below this fraction of the median rate counts as a stall
+#define PSI_TIMELINE_STALL_FRACTION  0.25
+
+// bytes written per fixed time bucket
+typedef struct psi_timeline_t {
+	const char *label;
+	double bucket;           // bucket length [s]
+	double start;
+	double end;
+	long long *bytes;
+	int nbuckets;
+	int max_buckets;
+	double progress;         // interval of progress lines [s], 0 for none
+	double next_progress;
+	long long progress_bytes;
+	long long total_bytes;
+} psi_timeline_t;
+
+typedef struct psi_timeline_summary_t {
+	int nbuckets;
+	double median_rate;      // steady state [Byte/s]
+	double max_rate;
+	double min_rate;
+	int stall_buckets;
+	double longest_stall;    // [s]
+} psi_timeline_summary_t;
+
+// bucket and progress in seconds, starts the clock
+int
+init_psi_timeline(psi_timeline_t *timeline, const char *label, double bucket, double progress);
+
+// nbytes have been written just now
+void
+add_psi_timeline(psi_timeline_t *timeline, long long nbytes);
+
+// stops the clock
+void
+finish_psi_timeline(psi_timeline_t *timeline);
+
+void
+get_psi_timeline_summary(const psi_timeline_t *timeline, psi_timeline_summary_t *summary);
+
+// json array of the rate of each bucket in MiB/s
+void
+print_psi_timeline_json(FILE *f, const psi_timeline_t *timeline);
+
+void
+free_psi_timeline(psi_timeline_t *timeline);
+
+#endif /* PSI_TIMELINE_H_ */
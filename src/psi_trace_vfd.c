@@ -0,0 +1,394 @@
+/*
+ * psi_trace_vfd.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * pass-through virtual file driver: all I/O is forwarded to the sec2 driver,
+ * every read, write and truncate is recorded into a preallocated log which is
+ * dumped to a text file at close. One line per record:
+ *
+ *   <op> <time [s] since open> <H5FD_mem_t> <offset [Byte]> <size [Byte]>
+ *
+ * op is R, W or T. The log memory is allocated and touched when the fapl is
+ * set up, so neither allocation nor page faults show up inside the traced
+ * phase. If no dump file is given in the fapl, the log of the last closed
+ * file stays available and can be written later with dump_psi_trace_vfd_log().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "hdf5.h"
+#include "psi_trace_vfd.h"
+
+// the driver fills in the H5FD_class_t of 1.10 and 1.12 by position, with
+// lock and unlock. 1.13 added the version, value, ctl and vector read and
+// write fields, an initializer of this layout puts the callbacks into the
+// wrong slots there.
+#if !H5_VERSION_GE(1,10,0)
+#error "psi_trace_vfd needs HDF5 1.10.0 or later"
+#endif
+#if H5_VERSION_GE(1,13,0)
+#error "psi_trace_vfd implements the driver class of HDF5 1.10 and 1.12, 1.13 and later are not supported"
+#endif
+
+enum { MAX_DUMP_NAME_LENGTH=256 };
+
+typedef struct psi_trace_fapl_t {
+	long long max_records;
+	char dump_name[MAX_DUMP_NAME_LENGTH];
+} psi_trace_fapl_t;
+
+typedef struct psi_trace_record_t {
+	double time;
+	haddr_t addr;
+	size_t size;
+	char op;
+	signed char type;
+} psi_trace_record_t;
+
+typedef struct psi_trace_t {
+	H5FD_t pub;              // public part, must be first
+	H5FD_t *sec2;            // the file we forward to
+	psi_trace_fapl_t fa;
+	struct timeval start;
+	psi_trace_record_t *log;
+	int own_log;             // log was malloced at open, pool was busy
+	long long nrecords;
+	haddr_t last_write_end;
+	psi_trace_summary_t summary;
+} psi_trace_t;
+
+static hid_t psi_trace_vfd_id = -1;
+static psi_trace_summary_t last_summary;
+
+// preallocated log, used by one open file at a time
+static psi_trace_record_t *log_pool = NULL;
+static long long log_pool_size = 0;
+static long long log_pool_used = 0;
+static int log_pool_busy = 0;
+
+static double
+elapsed_since(const struct timeval *start)
+{
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return (double) (now.tv_sec - start->tv_sec + (now.tv_usec - start->tv_usec)*1.e-6);
+}
+
+static void
+psi_trace_record(psi_trace_t *file, char op, H5FD_mem_t type, haddr_t addr, size_t size)
+{
+	if (file->nrecords < file->fa.max_records) {
+		psi_trace_record_t *rec = &file->log[file->nrecords++];
+		rec->time = elapsed_since(&file->start);
+		rec->addr = addr;
+		rec->size = size;
+		rec->op = op;
+		rec->type = (signed char) type;
+	} else {
+		file->summary.dropped++;
+	}
+}
+
+static int
+psi_trace_dump(const char *name, const psi_trace_record_t *log, long long nrecords, long long dropped)
+{
+	FILE *dump;
+
+	dump = fopen(name, "w");
+	if (dump == NULL) {
+		perror("ERROR: failed to open file for vfd trace dump");
+		return -1;
+	}
+	fprintf(dump, "# psi_trace_vfd log, %lli records, %lli dropped\n", nrecords, dropped);
+	fprintf(dump, "# op time[s] memtype offset size\n");
+	for (long long i = 0; i < nrecords; i++) {
+		const psi_trace_record_t *rec = &log[i];
+		fprintf(dump, "%c %.6lf %i %llu %zu\n", rec->op, rec->time, rec->type,
+				(unsigned long long) rec->addr, rec->size);
+	}
+	return fclose(dump);
+}
+
+static void *
+psi_trace_fapl_get(H5FD_t *_file)
+{
+	psi_trace_t *file = (psi_trace_t *) _file;
+	psi_trace_fapl_t *fa = malloc(sizeof(psi_trace_fapl_t));
+	if (fa != NULL) *fa = file->fa;
+	return fa;
+}
+
+static void *
+psi_trace_fapl_copy(const void *_old_fa)
+{
+	psi_trace_fapl_t *fa = malloc(sizeof(psi_trace_fapl_t));
+	if (fa != NULL) *fa = *(const psi_trace_fapl_t *) _old_fa;
+	return fa;
+}
+
+static herr_t
+psi_trace_fapl_free(void *fa)
+{
+	free(fa);
+	return 0;
+}
+
+static H5FD_t *
+psi_trace_open(const char *name, unsigned flags, hid_t fapl, haddr_t maxaddr)
+{
+	const psi_trace_fapl_t *fa = H5Pget_driver_info(fapl);
+	psi_trace_t *file = NULL;
+	hid_t sec2_fapl;
+
+	if (fa == NULL) return NULL;
+
+	file = calloc(1, sizeof(psi_trace_t));
+	if (file == NULL) return NULL;
+	file->fa = *fa;
+
+	if (!log_pool_busy && file->fa.max_records <= log_pool_size) {
+		file->log = log_pool;
+		log_pool_busy = 1;
+	} else if (file->fa.max_records > 0) {
+		file->log = malloc(file->fa.max_records*sizeof(psi_trace_record_t));
+		if (file->log == NULL) {
+			printf("ERROR: failed to allocate space for %lli trace records\n", file->fa.max_records);
+			free(file);
+			return NULL;
+		}
+		file->own_log = 1;
+	}
+
+	sec2_fapl = H5Pcreate(H5P_FILE_ACCESS);
+	if (sec2_fapl < 0 || H5Pset_fapl_sec2(sec2_fapl) < 0) goto fail;
+	file->sec2 = H5FDopen(name, flags, sec2_fapl, maxaddr);
+	H5Pclose(sec2_fapl);
+	if (file->sec2 == NULL) goto fail;
+
+	gettimeofday(&file->start, NULL);
+	return (H5FD_t *) file;
+
+	fail:
+	if (file->own_log) {
+		free(file->log);
+	} else if (file->log != NULL) {
+		log_pool_busy = 0;
+	}
+	free(file);
+	return NULL;
+}
+
+static herr_t
+psi_trace_close(H5FD_t *_file)
+{
+	psi_trace_t *file = (psi_trace_t *) _file;
+	herr_t ret;
+
+	ret = H5FDclose(file->sec2);
+
+	file->summary.records = file->nrecords;
+	last_summary = file->summary;
+	if (file->fa.dump_name[0] != '\0') {
+		psi_trace_dump(file->fa.dump_name, file->log, file->nrecords, file->summary.dropped);
+	}
+
+	if (file->own_log) {
+		free(file->log);
+	} else if (file->log != NULL) {
+		log_pool_used = file->nrecords;
+		log_pool_busy = 0;
+	}
+	free(file);
+	return ret;
+}
+
+static int
+psi_trace_cmp(const H5FD_t *f1, const H5FD_t *f2)
+{
+	return H5FDcmp(((const psi_trace_t *) f1)->sec2, ((const psi_trace_t *) f2)->sec2);
+}
+
+static herr_t
+psi_trace_query(const H5FD_t *_file, unsigned long *flags)
+{
+	unsigned long sec2_flags = 0;
+
+	// the library asks with a NULL file before opening, answer like sec2 does
+	if (_file == NULL) {
+		return H5FDdriver_query(H5FD_SEC2, flags);
+	}
+	if (H5FDquery(((const psi_trace_t *) _file)->sec2, &sec2_flags) < 0) return -1;
+	*flags = sec2_flags;
+	return 0;
+}
+
+static haddr_t
+psi_trace_get_eoa(const H5FD_t *_file, H5FD_mem_t type)
+{
+	return H5FDget_eoa(((const psi_trace_t *) _file)->sec2, type);
+}
+
+static herr_t
+psi_trace_set_eoa(H5FD_t *_file, H5FD_mem_t type, haddr_t addr)
+{
+	return H5FDset_eoa(((psi_trace_t *) _file)->sec2, type, addr);
+}
+
+static haddr_t
+psi_trace_get_eof(const H5FD_t *_file, H5FD_mem_t type)
+{
+	return H5FDget_eof(((const psi_trace_t *) _file)->sec2, type);
+}
+
+static herr_t
+psi_trace_get_handle(H5FD_t *_file, hid_t fapl, void **file_handle)
+{
+	return H5FDget_vfd_handle(((psi_trace_t *) _file)->sec2, fapl, file_handle);
+}
+
+static herr_t
+psi_trace_read(H5FD_t *_file, H5FD_mem_t type, hid_t dxpl, haddr_t addr, size_t size, void *buf)
+{
+	psi_trace_t *file = (psi_trace_t *) _file;
+
+	psi_trace_record(file, 'R', type, addr, size);
+	file->summary.nreads++;
+	return H5FDread(file->sec2, type, dxpl, addr, size, buf);
+}
+
+static herr_t
+psi_trace_write(H5FD_t *_file, H5FD_mem_t type, hid_t dxpl, haddr_t addr, size_t size, const void *buf)
+{
+	psi_trace_t *file = (psi_trace_t *) _file;
+
+	psi_trace_record(file, 'W', type, addr, size);
+	file->summary.nwrites++;
+	if (type == H5FD_MEM_DRAW) {
+		file->summary.raw_writes++;
+		file->summary.raw_bytes_written += size;
+	} else {
+		file->summary.meta_writes++;
+		file->summary.meta_bytes_written += size;
+	}
+	if (size < PSI_TRACE_SMALL_WRITE && addr != file->last_write_end) {
+		file->summary.small_nonseq_writes++;
+	}
+	file->last_write_end = addr + size;
+
+	return H5FDwrite(file->sec2, type, dxpl, addr, size, buf);
+}
+
+static herr_t
+psi_trace_flush(H5FD_t *_file, hid_t dxpl, hbool_t closing)
+{
+	return H5FDflush(((psi_trace_t *) _file)->sec2, dxpl, closing);
+}
+
+static herr_t
+psi_trace_truncate(H5FD_t *_file, hid_t dxpl, hbool_t closing)
+{
+	psi_trace_t *file = (psi_trace_t *) _file;
+
+	psi_trace_record(file, 'T', H5FD_MEM_DEFAULT, H5FDget_eoa(file->sec2, H5FD_MEM_DEFAULT), 0);
+	file->summary.ntruncates++;
+	return H5FDtruncate(file->sec2, dxpl, closing);
+}
+
+static herr_t
+psi_trace_lock(H5FD_t *_file, hbool_t rw)
+{
+	return H5FDlock(((psi_trace_t *) _file)->sec2, rw);
+}
+
+static herr_t
+psi_trace_unlock(H5FD_t *_file)
+{
+	return H5FDunlock(((psi_trace_t *) _file)->sec2);
+}
+
+static const H5FD_class_t psi_trace_vfd_definition =
+{
+	    "psi_trace_vfd",            /* name                 */
+	    (haddr_t) 0x7fffffffffffffffULL,   /* maxaddr, same as sec2 */
+	    H5F_CLOSE_WEAK,             /* fc_degree            */
+	    NULL,                       /* terminate            */
+	    NULL,                       /* sb_size              */
+	    NULL,                       /* sb_encode            */
+	    NULL,                       /* sb_decode            */
+	    sizeof(psi_trace_fapl_t),   /* fapl_size            */
+	    psi_trace_fapl_get,         /* fapl_get             */
+	    psi_trace_fapl_copy,        /* fapl_copy            */
+	    psi_trace_fapl_free,        /* fapl_free            */
+	    0,                          /* dxpl_size            */
+	    NULL,                       /* dxpl_copy            */
+	    NULL,                       /* dxpl_free            */
+	    psi_trace_open,             /* open                 */
+	    psi_trace_close,            /* close                */
+	    psi_trace_cmp,              /* cmp                  */
+	    psi_trace_query,            /* query                */
+	    NULL,                       /* get_type_map         */
+	    NULL,                       /* alloc                */
+	    NULL,                       /* free                 */
+	    psi_trace_get_eoa,          /* get_eoa              */
+	    psi_trace_set_eoa,          /* set_eoa              */
+	    psi_trace_get_eof,          /* get_eof              */
+	    psi_trace_get_handle,       /* get_handle           */
+	    psi_trace_read,             /* read                 */
+	    psi_trace_write,            /* write                */
+	    psi_trace_flush,            /* flush                */
+	    psi_trace_truncate,         /* truncate             */
+	    psi_trace_lock,             /* lock                 */
+	    psi_trace_unlock,           /* unlock               */
+	    H5FD_FLMAP_DICHOTOMY        /* fl_map               */
+};
+
+hid_t
+register_psi_trace_vfd(void) {
+	if (psi_trace_vfd_id < 0) {
+		psi_trace_vfd_id = H5FDregister(&psi_trace_vfd_definition);
+	}
+	return(psi_trace_vfd_id);
+}
+
+herr_t
+set_fapl_psi_trace_vfd(hid_t fapl, long long max_records, const char *dump_name) {
+	psi_trace_fapl_t fa;
+	hid_t driver = register_psi_trace_vfd();
+
+	if (driver < 0 || max_records < 0) return -1;
+
+	// preallocate and touch the log, page faults should not show up in the trace
+	if (max_records > log_pool_size && !log_pool_busy) {
+		psi_trace_record_t *pool = realloc(log_pool, max_records*sizeof(psi_trace_record_t));
+		if (pool == NULL) {
+			printf("ERROR: failed to allocate space for %lli trace records\n", max_records);
+			return -1;
+		}
+		memset(pool, 0, max_records*sizeof(psi_trace_record_t));
+		log_pool = pool;
+		log_pool_size = max_records;
+		log_pool_used = 0;
+	}
+
+	memset(&fa, 0, sizeof(fa));
+	fa.max_records = max_records;
+	if (dump_name != NULL) {
+		strncpy(fa.dump_name, dump_name, MAX_DUMP_NAME_LENGTH-1);
+	}
+	return H5Pset_driver(fapl, driver, &fa);
+}
+
+void
+get_psi_trace_vfd_summary(psi_trace_summary_t *summary) {
+	*summary = last_summary;
+}
+
+herr_t
+dump_psi_trace_vfd_log(const char *dump_name) {
+	if (log_pool_busy) return -1;
+	return psi_trace_dump(dump_name, log_pool, log_pool_used, last_summary.dropped);
+}
@@ -0,0 +1,43 @@
+/*
+ * psi_trace_vfd.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_TRACE_VFD_H_
+#define PSI_TRACE_VFD_H_
+
+#include "hdf5.h"
+
+// writes smaller than this which do not continue the previous write are
+// counted as small non-sequential writes
+#define PSI_TRACE_SMALL_WRITE  4096
+
+// summary of the last file closed with the trace driver
+typedef struct psi_trace_summary_t {
+	long long nreads;
+	long long nwrites;
+	long long ntruncates;
+	long long raw_bytes_written;       // H5FD_MEM_DRAW
+	long long meta_bytes_written;      // all other memory types
+	long long raw_writes;
+	long long meta_writes;
+	long long small_nonseq_writes;
+	long long records;                 // records kept in the log
+	long long dropped;                 // records lost because the log was full
+} psi_trace_summary_t;
+
+hid_t
+register_psi_trace_vfd(void);
+
+herr_t
+set_fapl_psi_trace_vfd(hid_t fapl, long long max_records, const char *dump_name);
+
+void
+get_psi_trace_vfd_summary(psi_trace_summary_t *summary);
+
+herr_t
+dump_psi_trace_vfd_log(const char *dump_name);
+
+#endif /* PSI_TRACE_VFD_H_ */
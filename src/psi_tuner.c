@@ -0,0 +1,130 @@
+/*
+ * psi_tuner.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * Search for the chunk size and file settings with the best sustained
+ * write rate. The trials themselves are run by the caller, this only
+ * decides which configurations to try and keeps within the time budget.
+ * With rates that rise and then fall with the chunk size the coarse pass
+ * brackets the best chunk size and the fine pass looks inside the bracket.
+ */
+
+#define _POSIX_C_SOURCE 200112L   /* clock_gettime */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "psi_tuner.h"
+
+// chunk sizes of the coarse pass differ by about this factor
+#define COARSE_STEP  2
+// trials of the fine pass
+#define MAX_FINE     4
+
+static double
+now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) ts.tv_sec + ts.tv_nsec*1.e-9;
+}
+
+typedef struct search_t {
+	psi_tune_run_t run;
+	void *arg;
+	double start;
+	double budget;
+	double slice;
+	psi_tune_result_t *result;
+} search_t;
+
+static int
+same_config(const psi_tune_config_t *a, const psi_tune_config_t *b)
+{
+	return a->chunk_images == b->chunk_images && a->alignment == b->alignment
+			&& a->metadata_tuning == b->metadata_tuning;
+}
+
+// run a trial unless it was done before or the budget is used up
+static void
+try_config(search_t *search, const psi_tune_config_t *config, int phase)
+{
+	psi_tune_result_t *result = search->result;
+
+	for (int i = 0; i < result->ntrials; i++)
+		if (same_config(&result->trials[i].config, config)) return;
+	if (result->ntrials == PSI_TUNE_MAX_TRIALS || now() - search->start >= search->budget) {
+		result->budget_exceeded = 1;
+		return;
+	}
+
+	psi_tune_trial_t *trial = &result->trials[result->ntrials++];
+	double t0 = now();
+	trial->config = *config;
+	trial->phase = phase;
+	trial->rate = search->run(config, search->slice, search->arg);
+	trial->time = now() - t0;
+	if (trial->rate > result->best_rate) {
+		result->best_rate = trial->rate;
+		result->best = *config;
+	}
+}
+
+int
+psi_tune(const long *candidates, int ncandidates, const long long *alignments, int nalignments,
+		double budget, psi_tune_run_t run, void *arg, psi_tune_result_t *result)
+{
+	int coarse[PSI_TUNE_MAX_TRIALS];
+	int ncoarse = 0;
+	psi_tune_config_t config;
+	search_t search = { run, arg, now(), budget, 0., result };
+
+	memset(result, 0, sizeof(*result));
+	result->best_rate = -1.;
+	if (ncandidates <= 0 || nalignments <= 0 || budget <= 0.) return -1;
+
+	// coarse pass: the smallest, about a factor COARSE_STEP apart, the largest
+	coarse[ncoarse++] = 0;
+	for (int i = 1; i < ncandidates && ncoarse < PSI_TUNE_MAX_TRIALS/2; i++) {
+		if (candidates[i] >= COARSE_STEP*candidates[coarse[ncoarse-1]] || i == ncandidates - 1)
+			coarse[ncoarse++] = i;
+	}
+	search.slice = budget / (ncoarse + MAX_FINE + 2*nalignments - 1);
+
+	memset(&config, 0, sizeof(config));
+	for (int c = 0; c < ncoarse; c++) {
+		config.chunk_images = candidates[coarse[c]];
+		try_config(&search, &config, 0);
+	}
+	if (result->best_rate < 0.) goto done;
+
+	// fine pass between the coarse neighbours of the best one
+	int best = 0;
+	for (int c = 0; c < ncoarse; c++)
+		if (candidates[coarse[c]] == result->best.chunk_images) best = c;
+	int lo = best > 0 ? coarse[best-1] : coarse[best];
+	int hi = best < ncoarse - 1 ? coarse[best+1] : coarse[best];
+	int ninside = hi - lo - 1;
+	for (int f = 0; f < MAX_FINE && f < ninside; f++) {
+		// evenly spread over the candidates inside the bracket
+		int i = lo + 1 + (int) ((f + 0.5) * ninside / (ninside < MAX_FINE ? ninside : MAX_FINE));
+		config.chunk_images = candidates[i];
+		try_config(&search, &config, 1);
+	}
+
+	// file settings with the best chunk size
+	config.chunk_images = result->best.chunk_images;
+	for (int a = 0; a < nalignments; a++) {
+		for (int m = 0; m < 2; m++) {
+			config.alignment = alignments[a];
+			config.metadata_tuning = m;
+			try_config(&search, &config, 2);
+		}
+	}
+
+done:
+	result->time = now() - search.start;
+	return result->best_rate < 0. ? -1 : 0;
+}
@@ -0,0 +1,49 @@
+/*
+ * psi_tuner.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_TUNER_H_
+#define PSI_TUNER_H_
+
+// upper limit for the trials of one search
+#define PSI_TUNE_MAX_TRIALS  64
+
+typedef struct psi_tune_config_t {
+	long chunk_images;          // images per chunk
+	long long alignment;        // H5Pset_alignment(), 0 for none
+	int metadata_tuning;        // like -m
+} psi_tune_config_t;
+
+typedef struct psi_tune_trial_t {
+	psi_tune_config_t config;
+	int phase;                  // 0 coarse chunk size, 1 fine chunk size, 2 file settings
+	double rate;                // sustained MiB/s, -1 if the trial failed
+	double time;                // wall time of the trial including setup [s]
+} psi_tune_trial_t;
+
+typedef struct psi_tune_result_t {
+	psi_tune_config_t best;
+	double best_rate;
+	int ntrials;
+	psi_tune_trial_t trials[PSI_TUNE_MAX_TRIALS];
+	double time;                // whole search [s]
+	int budget_exceeded;        // trials were skipped
+} psi_tune_result_t;
+
+// run one trial for about the given number of seconds, returns the
+// sustained rate in MiB/s or -1 on failure
+typedef double (*psi_tune_run_t)(const psi_tune_config_t *config, double seconds, void *arg);
+
+// coarse to fine search: first chunk sizes about a factor 2 apart, then the
+// candidates between the neighbours of the best one, then the alignments
+// and metadata tuning with the best chunk size. The candidates must be
+// sorted, the first alignment should be 0. Every trial gets an equal part
+// of the budget in seconds.
+int
+psi_tune(const long *candidates, int ncandidates, const long long *alignments, int nalignments,
+		double budget, psi_tune_run_t run, void *arg, psi_tune_result_t *result);
+
+#endif /* PSI_TUNER_H_ */
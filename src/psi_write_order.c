@@ -0,0 +1,131 @@
+/*
+ * psi_write_order.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * Orders of the chunk writes. Writing the chunks with rising offsets only
+ * ever appends to the chunk index, the cheapest case for the B-tree of
+ * HDF5. The other orders insert into the middle of the index, split nodes
+ * all over it and touch more of it than the metadata cache holds.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "psi_write_order.h"
+
+static const char *order_names[] = { "sequential", "reverse", "strided", "shuffled", "interleaved" };
+
+int
+psi_write_order_from_name(const char *name)
+{
+	for (int i = PSI_WRITE_SEQUENTIAL; i <= PSI_WRITE_INTERLEAVED; i++)
+		if (strcmp(name, order_names[i]) == 0) return i;
+	return -1;
+}
+
+const char *
+get_psi_write_order_name(int order)
+{
+	if (order < PSI_WRITE_SEQUENTIAL || order > PSI_WRITE_INTERLEAVED) return "unknown";
+	return order_names[order];
+}
+
+// splitmix64, the permutation must not depend on RAND_MAX
+static unsigned long long
+next_random(unsigned long long *state)
+{
+	unsigned long long z = (*state += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+long long *
+get_psi_write_order(int order, long long n, long param)
+{
+	long long *index = malloc((n > 0 ? n : 1) * sizeof(long long));
+	long long k = 0;
+
+	if (index == NULL) return NULL;
+	switch (order) {
+	case PSI_WRITE_SEQUENTIAL:
+		for (long long i = 0; i < n; i++) index[i] = i;
+		break;
+	case PSI_WRITE_REVERSE:
+		for (long long i = 0; i < n; i++) index[i] = n - 1 - i;
+		break;
+	case PSI_WRITE_STRIDED:
+		if (param < 1) goto fail;
+		for (long r = 0; r < param && r < n; r++)
+			for (long long i = r; i < n; i += param) index[k++] = i;
+		break;
+	case PSI_WRITE_SHUFFLED: {
+		unsigned long long state = (unsigned long long) param;
+		for (long long i = 0; i < n; i++) index[i] = i;
+		for (long long i = n - 1; i > 0; i--) {   // Fisher-Yates
+			long long j = (long long) (next_random(&state) % (unsigned long long) (i + 1));
+			long long t = index[i];
+			index[i] = index[j];
+			index[j] = t;
+		}
+		break;
+	}
+	case PSI_WRITE_INTERLEAVED: {
+		long long nstreams = param < n ? param : n;
+		if (param < 1) goto fail;
+		// stream s owns the chunks s*n/nstreams .. (s+1)*n/nstreams - 1
+		for (long long round = 0; k < n; round++) {
+			for (long long s = 0; s < nstreams; s++) {
+				long long first = s*n/nstreams, end = (s + 1)*n/nstreams;
+				if (first + round < end) index[k++] = first + round;
+			}
+		}
+		break;
+	}
+	default:
+		goto fail;
+	}
+	return index;
+
+fail:
+	free(index);
+	return NULL;
+}
+
+static int
+compare_double(const void *a, const void *b)
+{
+	double x = *(const double *) a, y = *(const double *) b;
+	return (x > y) - (x < y);
+}
+
+int
+get_psi_latency_groups(const double *latency, long long n, int ngroups, psi_latency_group_t *groups)
+{
+	double *sorted;
+
+	if (n < ngroups) ngroups = n;
+	if (ngroups <= 0) return 0;
+	sorted = malloc(((n + ngroups - 1)/ngroups) * sizeof(double));
+	if (sorted == NULL) return -1;
+
+	for (int g = 0; g < ngroups; g++) {
+		psi_latency_group_t *group = &groups[g];
+		long long m;
+		double sum = 0.;
+
+		group->first = g*n/ngroups;
+		group->last = (g + 1)*n/ngroups - 1;
+		m = group->last - group->first + 1;
+		memcpy(sorted, latency + group->first, m*sizeof(double));
+		qsort(sorted, m, sizeof(double), compare_double);
+		for (long long i = 0; i < m; i++) sum += sorted[i];
+		group->mean = sum/m;
+		group->median = m % 2 ? sorted[m/2] : 0.5*(sorted[m/2 - 1] + sorted[m/2]);
+		group->p99 = sorted[(long long) (0.99*(m - 1) + 0.5)];
+		group->max = sorted[m - 1];
+	}
+	free(sorted);
+	return ngroups;
+}
@@ -0,0 +1,45 @@
+/*
+ * psi_write_order.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_WRITE_ORDER_H_
+#define PSI_WRITE_ORDER_H_
+
+#define PSI_WRITE_SEQUENTIAL   0
+#define PSI_WRITE_REVERSE      1
+#define PSI_WRITE_STRIDED      2   // every stride-th chunk, then the next offset
+#define PSI_WRITE_SHUFFLED     3   // random permutation
+#define PSI_WRITE_INTERLEAVED  4   // streams with a contiguous part each, in turn
+
+// insertion latency of the chunks written while the chunk index grew from
+// first to last + 1 chunks
+typedef struct psi_latency_group_t {
+	long long first;
+	long long last;
+	double mean;            // seconds
+	double median;
+	double p99;
+	double max;
+} psi_latency_group_t;
+
+int
+psi_write_order_from_name(const char *name);
+
+const char *
+get_psi_write_order_name(int order);
+
+// the chunk indices 0 .. n-1 in the order they are written. param is the
+// stride of strided, the number of streams of interleaved and the seed of
+// shuffled, ignored otherwise. Returns a malloc()ed array or NULL.
+long long *
+get_psi_write_order(int order, long long n, long param);
+
+// split the n latencies, in the order of writing, into up to ngroups groups
+// of consecutive writes. Returns the number of groups, -1 on failure.
+int
+get_psi_latency_groups(const double *latency, long long n, int ngroups, psi_latency_group_t *groups);
+
+#endif /* PSI_WRITE_ORDER_H_ */
@@ -0,0 +1,156 @@
+/*
+ * psi_write_threads.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * Direct chunk writes from several threads, each thread to its own dataset.
+ * A thread-safe HDF5 runs every API call under one global lock, so the
+ * threads take turns inside the library. The time a thread spends inside
+ * H5DOwrite_chunk() without using the cpu is mostly the wait for that lock,
+ * plus blocking I/O and, with more threads than cpus, the time the thread
+ * is not scheduled.
+ */
+
+#define _POSIX_C_SOURCE 200112L   /* clock_gettime */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "hdf5.h"
+#include "hdf5_hl.h"
+#include "psi_write_threads.h"
+
+// the threads wait here until all of them are started
+typedef struct start_gate_t {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	int go;
+	int abort;
+} start_gate_t;
+
+typedef struct writer_t {
+	hid_t dset;
+	const void *buf;
+	size_t size;
+	start_gate_t *gate;
+	psi_writer_stats_t *stats;
+} writer_t;
+
+static double
+now(clockid_t clock)
+{
+	struct timespec ts;
+	clock_gettime(clock, &ts);
+	return (double) ts.tv_sec + ts.tv_nsec*1.e-9;
+}
+
+herr_t
+psi_write_chunks(hid_t dset, const void *buf, size_t size, psi_writer_stats_t *stats)
+{
+	hsize_t dims[H5S_MAX_RANK], chunk[H5S_MAX_RANK], grid[H5S_MAX_RANK], offset[H5S_MAX_RANK];
+	hid_t space = -1, dcpl = -1;
+	long long nchunks = 1;
+	int rank;
+	herr_t ret = -1;
+
+	memset(stats, 0, sizeof(*stats));
+	stats->start = now(CLOCK_MONOTONIC);
+
+	space = H5Dget_space(dset);
+	dcpl = H5Dget_create_plist(dset);
+	if (space < 0 || dcpl < 0) goto done;
+	rank = H5Sget_simple_extent_dims(space, dims, NULL);
+	if (rank <= 0 || H5Pget_chunk(dcpl, rank, chunk) != rank) goto done;
+	for (int d = 0; d < rank; d++) {
+		grid[d] = (dims[d] + chunk[d] - 1) / chunk[d];
+		nchunks *= grid[d];
+	}
+
+	for (long long i = 0; i < nchunks; i++) {
+		long long index = i;
+		for (int d = rank - 1; d >= 0; d--) {
+			offset[d] = (index % grid[d]) * chunk[d];
+			index /= grid[d];
+		}
+
+		double t0 = now(CLOCK_MONOTONIC), c0 = now(CLOCK_THREAD_CPUTIME_ID);
+		if (H5DOwrite_chunk(dset, H5P_DEFAULT, 0, offset, size, buf) < 0) {
+			printf("ERROR: H5DOwrite_chunk of chunk %lli failed\n", i);
+			goto done;
+		}
+		stats->call_cpu += now(CLOCK_THREAD_CPUTIME_ID) - c0;
+		stats->call_time += now(CLOCK_MONOTONIC) - t0;
+		stats->chunks++;
+		stats->bytes += size;
+	}
+	ret = 0;
+
+done:
+	stats->end = now(CLOCK_MONOTONIC);
+	stats->failed = ret < 0;
+	if (dcpl >= 0) H5Pclose(dcpl);
+	if (space >= 0) H5Sclose(space);
+	return ret;
+}
+
+static void *
+writer_thread(void *arg)
+{
+	writer_t *w = arg;
+	int abort;
+
+	pthread_mutex_lock(&w->gate->lock);
+	while (!w->gate->go)
+		pthread_cond_wait(&w->gate->cond, &w->gate->lock);
+	abort = w->gate->abort;
+	pthread_mutex_unlock(&w->gate->lock);
+
+	if (!abort) psi_write_chunks(w->dset, w->buf, w->size, w->stats);
+	return NULL;
+}
+
+herr_t
+psi_threaded_write(const hid_t *dsets, int nthreads, const void *buf, size_t size, psi_writer_stats_t *stats)
+{
+	pthread_t threads[PSI_WRITE_MAX_THREADS];
+	writer_t writers[PSI_WRITE_MAX_THREADS];
+	start_gate_t gate = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0 };
+	int nstarted = 0;
+	herr_t ret = 0;
+
+	if (nthreads < 1 || nthreads > PSI_WRITE_MAX_THREADS) {
+		printf("ERROR: number of writer threads must be between 1 and %i\n", PSI_WRITE_MAX_THREADS);
+		return -1;
+	}
+	for (int t = 0; t < nthreads; t++) {
+		writers[t].dset = dsets[t];
+		writers[t].buf = buf;
+		writers[t].size = size;
+		writers[t].gate = &gate;
+		writers[t].stats = &stats[t];
+		memset(&stats[t], 0, sizeof(stats[t]));
+		stats[t].failed = 1;
+	}
+	for (nstarted = 0; nstarted < nthreads; nstarted++) {
+		if (pthread_create(&threads[nstarted], NULL, writer_thread, &writers[nstarted]) != 0) {
+			printf("ERROR: failed to start writer thread %i\n", nstarted);
+			ret = -1;
+			break;
+		}
+	}
+	pthread_mutex_lock(&gate.lock);
+	gate.go = 1;
+	gate.abort = ret < 0;
+	pthread_cond_broadcast(&gate.cond);
+	pthread_mutex_unlock(&gate.lock);
+
+	for (int t = 0; t < nstarted; t++)
+		pthread_join(threads[t], NULL);
+
+	for (int t = 0; t < nthreads; t++)
+		if (stats[t].failed) ret = -1;
+	return ret;
+}
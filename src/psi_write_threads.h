@@ -0,0 +1,37 @@
+/*
+ * psi_write_threads.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_WRITE_THREADS_H_
+#define PSI_WRITE_THREADS_H_
+
+#include <stddef.h>
+#include "hdf5.h"
+
+// upper limit for the number of writer threads
+#define PSI_WRITE_MAX_THREADS  256
+
+typedef struct psi_writer_stats_t {
+	long long chunks;
+	long long bytes;
+	double start;           // CLOCK_MONOTONIC, comparable between threads and processes
+	double end;
+	double call_time;       // wall time inside H5DOwrite_chunk()
+	double call_cpu;        // cpu time of the thread inside H5DOwrite_chunk()
+	int failed;
+} psi_writer_stats_t;
+
+// write every chunk of dset with H5DOwrite_chunk(), all from buf. The chunks
+// go in C order of the chunk grid.
+herr_t
+psi_write_chunks(hid_t dset, const void *buf, size_t size, psi_writer_stats_t *stats);
+
+// psi_write_chunks() for every dataset on its own thread, all threads start
+// at once. Needs a thread-safe HDF5 for more than one thread.
+herr_t
+psi_threaded_write(const hid_t *dsets, int nthreads, const void *buf, size_t size, psi_writer_stats_t *stats);
+
+#endif /* PSI_WRITE_THREADS_H_ */
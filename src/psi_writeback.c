@@ -0,0 +1,63 @@
+/*
+ * psi_writeback.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * Wait for the page cache to write back what the last phase left dirty,
+ * so that the next phase doesn't start with the writeback of the one
+ * before. sync() starts the writeback of everything, other processes can
+ * still dirty pages, hence the threshold.
+ */
+
+#define _POSIX_C_SOURCE 200112L   /* clock_gettime, nanosleep */
+#define _DEFAULT_SOURCE           /* sync */
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include "psi_writeback.h"
+
+// poll /proc/meminfo this often [ns]
+#define POLL_INTERVAL  50000000L
+
+static double
+now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) ts.tv_sec + ts.tv_nsec*1.e-9;
+}
+
+long long
+get_psi_dirty_bytes(void)
+{
+	char line[256];
+	long long kib, dirty = -1, writeback = -1;
+	FILE *f = fopen("/proc/meminfo", "r");
+
+	if (f == NULL) return -1;
+	while (fgets(line, sizeof(line), f) != NULL) {
+		if (sscanf(line, "Dirty: %lld kB", &kib) == 1) dirty = kib * 1024;
+		else if (sscanf(line, "Writeback: %lld kB", &kib) == 1) writeback = kib * 1024;
+	}
+	fclose(f);
+	if (dirty < 0 || writeback < 0) return -1;
+	return dirty + writeback;
+}
+
+double
+wait_psi_writeback_quiet(long long threshold, double timeout)
+{
+	struct timespec interval = { 0, POLL_INTERVAL };
+	double start = now();
+
+	sync();
+	for (;;) {
+		long long bytes = get_psi_dirty_bytes();
+		if (bytes < 0) return -1.;
+		if (bytes <= threshold) return now() - start;
+		if (now() - start >= timeout) return -1.;
+		nanosleep(&interval, NULL);
+	}
+}
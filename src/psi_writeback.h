@@ -0,0 +1,21 @@
+/*
+ * psi_writeback.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ */
+
+#ifndef PSI_WRITEBACK_H_
+#define PSI_WRITEBACK_H_
+
+// Dirty plus Writeback of /proc/meminfo in bytes, -1 if unknown
+long long
+get_psi_dirty_bytes(void);
+
+// sync() and wait until at most threshold bytes are dirty or under
+// writeback, but no longer than timeout seconds. Returns the seconds
+// waited, -1 on timeout or if /proc/meminfo can't be read.
+double
+wait_psi_writeback_quiet(long long threshold, double timeout);
+
+#endif /* PSI_WRITEBACK_H_ */
@@ -0,0 +1,254 @@
+/*
+ * test_bshuf_lz4.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: billich
+ *
+ * round trip tests for the bitshuffle + LZ4 codec, for all implementations of
+ * the bit transposition, and for the HDF5 filter on both write paths.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hdf5.h"
+#include "hdf5_hl.h"
+#include "psi_bshuf_lz4_filter.h"
+#include "psi_parallel_read.h"
+
+#define FILE            "test_bshuf_lz4.h5"
+#define DIM0            16
+#define DIM1            1000
+
+static unsigned int seed = 12345;
+
+static unsigned int
+next_random(void)
+{
+	seed = seed*1103515245 + 12345;
+	return (seed >> 16) & 0x7fff;
+}
+
+static void
+fill(unsigned char *buf, size_t n, int kind)
+{
+	for (size_t i = 0; i < n; i++) {
+		switch (kind) {
+		case 0: buf[i] = 127; break;                                      // constant
+		case 1: buf[i] = (next_random() % 16 == 0) ? next_random() % 8 : 0; break;  // sparse
+		default: buf[i] = (unsigned char) next_random(); break;           // noise
+		}
+	}
+}
+
+static int
+roundtrip(size_t nbytes, size_t elem_size, size_t block_size, int kind)
+{
+	unsigned char *in = malloc(nbytes + 1);
+	unsigned char *back = malloc(nbytes + 1);
+	size_t bound = psi_bshuf_lz4_bound(nbytes, elem_size, block_size);
+	unsigned char *packed = malloc(bound);
+	size_t n, m;
+
+	fill(in, nbytes, kind);
+	n = psi_bshuf_lz4_compress(in, nbytes, elem_size, block_size, packed, bound);
+	if (n == 0) {
+		printf("ERROR: compress failed for %zu bytes, elem size %zu\n", nbytes, elem_size);
+		return 1;
+	}
+	if (psi_bshuf_lz4_decompressed_size(packed, n) != nbytes) {
+		printf("ERROR: wrong size in header for %zu bytes\n", nbytes);
+		return 1;
+	}
+	memset(back, 0, nbytes + 1);
+	m = psi_bshuf_lz4_decompress(packed, n, elem_size, back, nbytes);
+	if (m != nbytes || memcmp(in, back, nbytes) != 0) {
+		printf("ERROR: round trip failed for %zu bytes, elem size %zu, block size %zu, data %i\n",
+				nbytes, elem_size, block_size, kind);
+		return 1;
+	}
+	// a truncated stream must be rejected
+	if (n > 16 && psi_bshuf_lz4_decompress(packed, n - 3, elem_size, back, nbytes) != 0) {
+		printf("ERROR: truncated stream not detected for %zu bytes\n", nbytes);
+		return 1;
+	}
+	free(in);
+	free(back);
+	free(packed);
+	return 0;
+}
+
+static int
+check_chunk(long long index, const void *data, size_t size, void *arg)
+{
+	return memcmp(data, (const char *) arg + index*size, size) != 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+	const size_t sizes[] = { 0, 1, 7, 8, 13, 64, 100, 1000, 8192, 8200, 65536, 100003, 1000000 };
+	const size_t elem_sizes[] = { 1, 2, 4, 8 };
+	const size_t block_sizes[] = { 0, 8, 1000 };
+	int failed = 0;
+
+	printf(">> Test: codec round trip\n");
+	for (int impl = PSI_BSHUF_IMPL_SCALAR; impl <= PSI_BSHUF_IMPL_AVX2; impl++) {
+		if (set_psi_bshuf_impl(impl) < 0) {
+			printf("implementation %i not supported by this cpu, skipped\n", impl);
+			continue;
+		}
+		printf("implementation %s\n", get_psi_bshuf_impl_name());
+		for (size_t s = 0; s < sizeof(sizes)/sizeof(sizes[0]); s++)
+			for (size_t e = 0; e < sizeof(elem_sizes)/sizeof(elem_sizes[0]); e++)
+				for (size_t b = 0; b < sizeof(block_sizes)/sizeof(block_sizes[0]); b++)
+					for (int kind = 0; kind < 3; kind++)
+						failed += roundtrip(sizes[s], elem_sizes[e], block_sizes[b], kind);
+	}
+	set_psi_bshuf_impl(PSI_BSHUF_IMPL_AUTO);
+	if (failed) {
+		printf("ERROR: %i codec round trips failed\n", failed);
+		exit(1);
+	}
+	printf("Success\n\n");
+
+	printf(">> Test: all implementations produce the same stream\n");
+	for (size_t e = 0; e < sizeof(elem_sizes)/sizeof(elem_sizes[0]); e++) {
+		size_t nbytes = 100003;
+		size_t bound = psi_bshuf_lz4_bound(nbytes, elem_sizes[e], 0);
+		unsigned char *in = malloc(nbytes);
+		unsigned char *ref = malloc(bound);
+		unsigned char *packed = malloc(bound);
+		size_t nref, n;
+
+		fill(in, nbytes, 1);
+		set_psi_bshuf_impl(PSI_BSHUF_IMPL_SCALAR);
+		nref = psi_bshuf_lz4_compress(in, nbytes, elem_sizes[e], 0, ref, bound);
+		for (int impl = PSI_BSHUF_IMPL_SSE2; impl <= PSI_BSHUF_IMPL_AVX2; impl++) {
+			if (set_psi_bshuf_impl(impl) < 0) continue;
+			n = psi_bshuf_lz4_compress(in, nbytes, elem_sizes[e], 0, packed, bound);
+			if (n != nref || memcmp(ref, packed, n) != 0) {
+				printf("ERROR: %s stream differs from scalar one, elem size %zu\n", get_psi_bshuf_impl_name(), elem_sizes[e]);
+				failed++;
+			}
+		}
+		free(in);
+		free(ref);
+		free(packed);
+	}
+	set_psi_bshuf_impl(PSI_BSHUF_IMPL_AUTO);
+	if (failed) {
+		printf("ERROR: %i implementations differ\n", failed);
+		exit(1);
+	}
+	printf("Success\n\n");
+
+	printf(">> Test: filter pipeline and direct chunk write\n");
+	hid_t file, space, dset, dcpl;
+	herr_t status;
+	hsize_t dims[2] = {DIM0, DIM1}, chunk[2] = {DIM0/2, DIM1}, offset[2] = {0, 0};
+	static unsigned short wdata[DIM0][DIM1], rdata[DIM0][DIM1];
+
+	fill((unsigned char *) wdata, sizeof(wdata), 1);
+
+	if (register_psi_bshuf_lz4_filter() < 0) {
+		printf("ERROR: failed to register filter\n");
+		exit(1);
+	}
+	file = H5Fcreate(FILE, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+	space = H5Screate_simple(2, dims, NULL);
+	dcpl = H5Pcreate(H5P_DATASET_CREATE);
+	status = H5Pset_filter(dcpl, PSI_BSHUF_LZ4_FILTER, H5Z_FLAG_MANDATORY, 0, NULL);
+	status = H5Pset_chunk(dcpl, 2, chunk);
+	dset = H5Dcreate(file, "DS1", H5T_NATIVE_USHORT, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+	if (dset < 0) {
+		printf("ERROR: failed to create dataset\n");
+		exit(1);
+	}
+
+	// first chunk through the pipeline, second one precompressed
+	hsize_t start[2] = {0, 0}, count[2] = {DIM0/2, DIM1};
+	hid_t memspace = H5Screate_simple(2, count, NULL);
+	status = H5Sselect_hyperslab(space, H5S_SELECT_SET, start, NULL, count, NULL);
+	status = H5Dwrite(dset, H5T_NATIVE_USHORT, memspace, space, H5P_DEFAULT, wdata[0]);
+	if (status < 0) {
+		printf("ERROR: H5Dwrite failed\n");
+		exit(1);
+	}
+
+	size_t chunk_bytes = sizeof(wdata)/2;
+	size_t bound = psi_bshuf_lz4_bound(chunk_bytes, sizeof(unsigned short), 0);
+	void *packed = malloc(bound);
+	size_t n = psi_bshuf_lz4_compress(wdata[DIM0/2], chunk_bytes, sizeof(unsigned short), 0, packed, bound);
+	offset[0] = DIM0/2;
+	status = H5DOwrite_chunk(dset, H5P_DEFAULT, 0, offset, n, packed);
+	if (n == 0 || status < 0) {
+		printf("ERROR: H5DOwrite_chunk with precompressed chunk failed\n");
+		exit(1);
+	}
+
+	H5Sclose(memspace);
+	H5Pclose(dcpl);
+	H5Dclose(dset);
+	H5Sclose(space);
+	H5Fclose(file);
+
+	file = H5Fopen(FILE, H5F_ACC_RDONLY, H5P_DEFAULT);
+	dset = H5Dopen(file, "DS1", H5P_DEFAULT);
+	status = H5Dread(dset, H5T_NATIVE_USHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata[0]);
+	if (status < 0 || memcmp(wdata, rdata, sizeof(wdata)) != 0) {
+		printf("ERROR: read back returned bogus data\n");
+		exit(1);
+	}
+	H5Dclose(dset);
+	H5Fclose(file);
+	printf("Success\n\n");
+
+	printf(">> Test: chunk stored uncompressed via filter mask\n");
+	file = H5Fopen(FILE, H5F_ACC_RDWR, H5P_DEFAULT);
+	space = H5Screate_simple(2, dims, NULL);
+	dcpl = H5Pcreate(H5P_DATASET_CREATE);
+	status = H5Pset_filter(dcpl, PSI_BSHUF_LZ4_FILTER, H5Z_FLAG_MANDATORY, 0, NULL);
+	status = H5Pset_chunk(dcpl, 2, chunk);
+	dset = H5Dcreate(file, "DS2", H5T_NATIVE_USHORT, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+	offset[0] = 0;
+	status = H5DOwrite_chunk(dset, H5P_DEFAULT, 0x1, offset, chunk_bytes, wdata[0]);
+	offset[0] = DIM0/2;
+	if (status >= 0)
+		status = H5DOwrite_chunk(dset, H5P_DEFAULT, 0, offset, n, packed);
+	if (status < 0) {
+		printf("ERROR: H5DOwrite_chunk with filter mask failed\n");
+		exit(1);
+	}
+	H5Pclose(dcpl);
+	H5Dclose(dset);
+	H5Sclose(space);
+	H5Fclose(file);
+
+	memset(rdata, 0, sizeof(rdata));
+	file = H5Fopen(FILE, H5F_ACC_RDONLY, H5P_DEFAULT);
+	dset = H5Dopen(file, "DS2", H5P_DEFAULT);
+	status = H5Dread(dset, H5T_NATIVE_USHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rdata[0]);
+	if (status < 0 || memcmp(wdata, rdata, sizeof(wdata)) != 0) {
+		printf("ERROR: read back of uncompressed and compressed chunks returned bogus data\n");
+		exit(1);
+	}
+	printf("Success\n\n");
+
+	printf(">> Test: parallel read of both kinds of chunk\n");
+	for (int nthreads = 1; nthreads <= 3; nthreads++) {
+		psi_read_stats_t stats;
+		if (psi_parallel_read(dset, nthreads, check_chunk, wdata, &stats) < 0
+				|| stats.chunks != 2 || stats.mismatches != 0) {
+			printf("ERROR: parallel read with %i threads failed\n", nthreads);
+			exit(1);
+		}
+	}
+	H5Dclose(dset);
+	H5Fclose(file);
+	free(packed);
+	printf("Success\n\n");
+
+	printf("\n%s: All Tests PASSED\n", argv[0]);
+	return 0;
+}